@@ -0,0 +1,328 @@
+#ifndef _XMATH_AABB_H_
+#define _XMATH_AABB_H_
+
+#include <algorithm>
+#include <limits>
+#include "Matrix.h"
+#include "Vector.h"
+#include "VectorBatch.h"
+
+namespace xmath{
+    /**@name AABB
+     * @note an axis-aligned box [min,max] in N dimensions, built on Vector<Type,N>
+     * @note the default box is empty (min > max): merging anything into it gives that thing,
+     *       it contains and intersects nothing
+     * @note transform() maps the box through an affine Matrix<Type,N + 1,N + 1> with Arvo's method:
+     *       center' = M % center + t, extent' = |M| % extent, instead of transforming the 2^N corners
+     */
+    template <class Type,size_t N>
+    class AABB{
+    public:
+        using value_type = Type;
+        using vector_type = Vector<Type,N>;
+
+        constexpr AABB()
+            :m_min(std::numeric_limits<Type>::max()),m_max(std::numeric_limits<Type>::lowest()){}
+        constexpr AABB(const vector_type &min,const vector_type &max)
+            :m_min(min),m_max(max){}
+        AABB(const AABB &) = default;
+        AABB(AABB &&) noexcept = default;
+        ~AABB() = default;
+
+        AABB &operator=(const AABB &) = default;
+        AABB &operator=(AABB &&) noexcept = default;
+
+        ///center +- extent
+        static constexpr AABB fromCenter(const vector_type &center,const vector_type &extent)noexcept{
+            return AABB(vector_type(center - extent),vector_type(center + extent));
+        }
+        ///the smallest box holding points[0,n), empty for n == 0
+        static constexpr AABB fromPoints(const vector_type *points,size_t n)noexcept{
+            AABB res;
+            for(size_t i = 0;i < n;++i){
+                res = res.merge(points[i]);
+            }
+            return res;
+        }
+
+        constexpr vector_type &min()noexcept{
+            return m_min;
+        }
+        constexpr const vector_type &min()const noexcept{
+            return m_min;
+        }
+        constexpr vector_type &max()noexcept{
+            return m_max;
+        }
+        constexpr const vector_type &max()const noexcept{
+            return m_max;
+        }
+
+        constexpr vector_type center()const noexcept{
+            return vector_type((m_min + m_max) * Type(0.5));
+        }
+        ///half the size along every axis
+        constexpr vector_type extent()const noexcept{
+            return vector_type((m_max - m_min) * Type(0.5));
+        }
+        constexpr vector_type size()const noexcept{
+            return vector_type(m_max - m_min);
+        }
+        constexpr bool empty()const noexcept{
+            for(size_t i = 0;i < N;++i){
+                if(m_min[i] > m_max[i]){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        ///the smallest box holding both
+        constexpr AABB merge(const AABB &box)const noexcept{
+            AABB res{vector_type(no_init),vector_type(no_init)};
+            for(size_t i = 0;i < N;++i){
+                res.m_min[i] = m_min[i] < box.m_min[i] ? m_min[i] : box.m_min[i];
+                res.m_max[i] = m_max[i] > box.m_max[i] ? m_max[i] : box.m_max[i];
+            }
+            return res;
+        }
+        constexpr AABB merge(const vector_type &point)const noexcept{
+            return merge(AABB(point,point));
+        }
+
+        ///boundaries included
+        constexpr bool contains(const vector_type &point)const noexcept{
+            for(size_t i = 0;i < N;++i){
+                if(point[i] < m_min[i] || point[i] > m_max[i]){
+                    return false;
+                }
+            }
+            return true;
+        }
+        constexpr bool contains(const AABB &box)const noexcept{
+            for(size_t i = 0;i < N;++i){
+                if(box.m_min[i] < m_min[i] || box.m_max[i] > m_max[i]){
+                    return false;
+                }
+            }
+            return true;
+        }
+        ///touching boxes intersect
+        constexpr bool intersects(const AABB &box)const noexcept{
+            for(size_t i = 0;i < N;++i){
+                if(box.m_max[i] < m_min[i] || box.m_min[i] > m_max[i]){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**@name transform
+         * @note the box bounding this one mapped by the affine mat (the last row is ignored),
+         *       as tight as the transformed corners' bounds; an empty box stays empty
+         */
+        constexpr AABB transform(const Matrix<Type,N + 1,N + 1> &mat)const noexcept{
+            if(empty()){
+                return AABB();
+            }
+            AABB res{vector_type(no_init),vector_type(no_init)};
+            for(size_t i = 0;i < N;++i){
+                Type center = mat(i,N);
+                Type extent = 0;
+                for(size_t j = 0;j < N;++j){
+                    center += mat(i,j) * ((m_min[j] + m_max[j]) * Type(0.5));
+                    extent += detail::abs(mat(i,j)) * ((m_max[j] - m_min[j]) * Type(0.5));
+                }
+                res.m_min[i] = center - extent;
+                res.m_max[i] = center + extent;
+            }
+            return res;
+        }
+
+        constexpr bool operator==(const AABB &box)const noexcept{
+            return m_min == box.m_min && m_max == box.m_max;
+        }
+        constexpr bool operator!=(const AABB &box)const noexcept{
+            return !(*this == box);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const AABB &box){
+            return os << '[' << box.m_min << ',' << box.m_max << ']';
+        }
+    protected:
+    private:
+        vector_type m_min;
+        vector_type m_max;
+    };
+
+    namespace detail{
+        /**@name BoxTransform
+         * @note the coefficients of an affine Matrix<Type,N + 1,N + 1> and their absolute values,
+         *       applied to structure-of-arrays boxes a Packet at a time
+         */
+        template <class Type,size_t N>
+        struct BoxTransform{
+            Type linear[N][N];
+            Type scale[N][N];
+            Type offset[N];
+
+            explicit BoxTransform(const Matrix<Type,N + 1,N + 1> &mat)noexcept{
+                for(size_t i = 0;i < N;++i){
+                    for(size_t j = 0;j < N;++j){
+                        linear[i][j] = mat(i,j);
+                        scale[i][j] = abs(mat(i,j));
+                    }
+                    offset[i] = mat(i,N);
+                }
+            }
+
+            ///box k is [mins[j][k],maxs[j][k]] for j < N, the results may overwrite the inputs
+            void operator()(const Type *const *mins,const Type *const *maxs,Type *const *res_mins,Type *const *res_maxs,size_t n)const noexcept{
+                packetFor<Type>(n,[&](auto tag,size_t k){
+                    using P = typename decltype(tag)::type;
+                    const P half = P::broadcast(Type(0.5));
+                    P c[N],e[N];
+                    for(size_t j = 0;j < N;++j){
+                        const P lo = P::load(mins[j] + k);
+                        const P hi = P::load(maxs[j] + k);
+                        c[j] = (lo + hi) * half;
+                        e[j] = (hi - lo) * half;
+                    }
+                    for(size_t i = 0;i < N;++i){
+                        P center = P::broadcast(offset[i]);
+                        P extent = P::broadcast(scale[i][0]) * e[0];
+                        for(size_t j = 0;j < N;++j){
+                            center = madd(P::broadcast(linear[i][j]),c[j],center);
+                        }
+                        for(size_t j = 1;j < N;++j){
+                            extent = madd(P::broadcast(scale[i][j]),e[j],extent);
+                        }
+                        (center - extent).store(res_mins[i] + k);
+                        (center + extent).store(res_maxs[i] + k);
+                    }
+                });
+            }
+        };
+    }
+
+    /**@name transformBoxes
+     * @note out[i] = in[i].transform(mat) for i < n, in and out may be the same array
+     * @note boxes are transposed into a structure-of-arrays block on the stack,
+     *       transformed a Packet at a time and transposed back
+     */
+    template <class Type,size_t N>
+    void transformBoxes(const std::type_identity_t<Matrix<Type,N + 1,N + 1>> &mat,const AABB<Type,N> *in,AABB<Type,N> *out,size_t n)noexcept{
+        constexpr size_t Block = 128;
+        const detail::BoxTransform<Type,N> kernel(mat);
+        Type lo[N][Block],hi[N][Block];
+        Type *mins[N],*maxs[N];
+        for(size_t j = 0;j < N;++j){
+            mins[j] = lo[j];
+            maxs[j] = hi[j];
+        }
+        bool empty[Block];
+        for(size_t beg = 0;beg < n;beg += Block){
+            const size_t count = std::min(Block,n - beg);
+            for(size_t k = 0;k < count;++k){
+                empty[k] = in[beg + k].empty();
+                for(size_t j = 0;j < N;++j){
+                    lo[j][k] = in[beg + k].min()[j];
+                    hi[j][k] = in[beg + k].max()[j];
+                }
+            }
+            kernel(mins,maxs,mins,maxs,count);
+            for(size_t k = 0;k < count;++k){
+                if(empty[k]){
+                    out[beg + k] = AABB<Type,N>();
+                    continue;
+                }
+                for(size_t j = 0;j < N;++j){
+                    out[beg + k].min()[j] = lo[j][k];
+                    out[beg + k].max()[j] = hi[j][k];
+                }
+            }
+        }
+    }
+
+    /**@name transformBoxes
+     * @note the structure-of-arrays form: box i is [mins.get(i),maxs.get(i)],
+     *       res_mins/res_maxs are resized and may be mins/maxs themselves
+     * @note a Packet of boxes at a time, the boxes must not be empty
+     */
+    template <class Type,size_t N>
+    void transformBoxes(const std::type_identity_t<Matrix<Type,N + 1,N + 1>> &mat,const VectorBatch<Type,N> &mins,const VectorBatch<Type,N> &maxs,
+                        VectorBatch<Type,N> &res_mins,VectorBatch<Type,N> &res_maxs){
+        const size_t n = std::min(mins.size(),maxs.size());
+        res_mins.resize(n);
+        res_maxs.resize(n);
+        const Type *in[2][N];
+        Type *res[2][N];
+        for(size_t j = 0;j < N;++j){
+            in[0][j] = mins.component(j);
+            in[1][j] = maxs.component(j);
+            res[0][j] = res_mins.component(j);
+            res[1][j] = res_maxs.component(j);
+        }
+        const detail::BoxTransform<Type,N> kernel(mat);
+        kernel(in[0],in[1],res[0],res[1],n);
+    }
+
+    ///the smallest box holding boxes[0,n), empty for n == 0
+    template <class Type,size_t N>
+    AABB<Type,N> mergeBoxes(const AABB<Type,N> *boxes,size_t n)noexcept{
+        Type lo[N],hi[N];
+        for(size_t j = 0;j < N;++j){
+            lo[j] = std::numeric_limits<Type>::max();
+            hi[j] = std::numeric_limits<Type>::lowest();
+        }
+        for(size_t i = 0;i < n;++i){
+            for(size_t j = 0;j < N;++j){
+                lo[j] = std::min(lo[j],boxes[i].min()[j]);
+                hi[j] = std::max(hi[j],boxes[i].max()[j]);
+            }
+        }
+        return AABB<Type,N>(Vector<Type,N>(lo),Vector<Type,N>(hi));
+    }
+    ///the structure-of-arrays form, a Packet of boxes at a time
+    template <class Type,size_t N>
+    AABB<Type,N> mergeBoxes(const VectorBatch<Type,N> &mins,const VectorBatch<Type,N> &maxs)noexcept{
+        using P = detail::widest_packet_t<Type>;
+        const size_t n = std::min(mins.size(),maxs.size());
+        AABB<Type,N> res;
+        for(size_t j = 0;j < N;++j){
+            const Type *lo = mins.component(j);
+            const Type *hi = maxs.component(j);
+            size_t i = 0;
+            if(n >= P::size){
+                P low = P::load(lo),high = P::load(hi);
+                for(i = P::size;i + P::size <= n;i += P::size){
+                    low = min(low,P::load(lo + i));
+                    high = max(high,P::load(hi + i));
+                }
+                Type lanes[2][P::size];
+                low.store(lanes[0]);
+                high.store(lanes[1]);
+                res.min()[j] = *std::min_element(lanes[0],lanes[0] + P::size);
+                res.max()[j] = *std::max_element(lanes[1],lanes[1] + P::size);
+            }
+            for(;i < n;++i){
+                res.min()[j] = std::min(res.min()[j],lo[i]);
+                res.max()[j] = std::max(res.max()[j],hi[i]);
+            }
+        }
+        return res;
+    }
+
+    template <size_t N>
+    using AABBf = AABB<float,N>;
+    template <size_t N>
+    using AABBd = AABB<double,N>;
+
+    using AABB2f = AABB<float,2>;
+    using AABB3f = AABB<float,3>;
+
+    using AABB2d = AABB<double,2>;
+    using AABB3d = AABB<double,3>;
+}
+
+#endif //_XMATH_AABB_H_
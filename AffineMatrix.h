@@ -0,0 +1,259 @@
+#ifndef _XMATH_AFFINE_MATRIX_H_
+#define _XMATH_AFFINE_MATRIX_H_
+
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace xmath{
+    namespace detail{
+        /**@name affineProduct
+         * @note res(Row x 4) = lhs(Row x 4) % | rhs(3 x 4) |, the last row [0,0,0,1] of the right side is implied
+         *                                    | 0  0  0  1 |
+         * @note the operations of product() in the same order, a row fewer to load
+         */
+        template <class Type,size_t Row>
+        constexpr void affineProduct(const Type *lhs,const Type *rhs,Type *res)noexcept{
+            constexpr Type unit[4] = {0,0,0,1};
+            const Type *const rows[4] = {rhs,rhs + 4,rhs + 8,unit};
+            if(std::is_constant_evaluated()){
+                unrollGrid<Row,4>([&](auto i,auto j){
+                    promote_t<Type> acc = lhs[i * 4] * rows[0][j];
+                    unroll<3>([&](auto k){
+                        acc += lhs[i * 4 + k + 1] * rows[k + 1][j];
+                    });
+                    res[i * 4 + j] = static_cast<Type>(acc);
+                });
+                return;
+            }
+            using P = packet_for_t<Type,4>;
+            unrollGrid<Row,4 / P::size>([&](auto i,auto packet){
+                const size_t j = packet * P::size;
+                auto acc = P::broadcast(lhs[i * 4]) * P::load(rows[0] + j);
+                unroll<3>([&](auto k){
+                    acc = madd(P::broadcast(lhs[i * 4 + k + 1]),P::load(rows[k + 1] + j),acc);
+                });
+                acc.store(res + i * 4 + j);
+            });
+        }
+    }
+
+    /**@name AffineMatrix
+     * @note a 4x4 matrix | A t | whose last row is always [0,0,0,1], only the upper 3x4 is stored (row-major):
+     *                    | 0 1 |
+     *       12 values instead of 16, what lookAt() and products of the structured matrices return
+     * @note lhs % rhs computes 3 rows instead of 4 and loads 3 rows of rhs instead of 4,
+     *       transformPoint()/transformDirection() take 9 multiplies and inverse() only inverts A
+     * @note converts implicitly to Matrix<Type,4,4> for projections and every other 4x4 product
+     * @note the default AffineMatrix is the identity
+     */
+    template <class Type>
+    class AffineMatrix{
+    public:
+        using value_type = Type;
+        using matrix_type = Matrix<Type,3,4>;
+        static constexpr size_t Count = matrix_type::Count;
+        using iterator = typename matrix_type::iterator;
+        using const_iterator = typename matrix_type::const_iterator;
+
+        constexpr AffineMatrix()
+            :m_data(no_init){
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                m_data(i,j) = Type(i == j);
+            });
+        }
+        constexpr explicit AffineMatrix(no_init_t)noexcept
+            :m_data(no_init){}
+        ///the 12 values of the upper 3x4, row by row
+        constexpr AffineMatrix(std::initializer_list<Type> list)
+            :m_data(list){}
+        constexpr explicit AffineMatrix(const matrix_type &mat)
+            :m_data(mat){}
+        constexpr AffineMatrix(const Matrix<Type,3,3> &linear,const Vector<Type,3> &translation)
+            :m_data(no_init){
+            detail::unroll<3>([&](auto i){
+                detail::unroll<3>([&](auto j){
+                    m_data(i,j) = linear(i,j);
+                });
+                m_data(i,3) = translation[i];
+            });
+        }
+        ///the last row of mat is ignored
+        constexpr explicit AffineMatrix(const Matrix<Type,4,4> &mat)
+            :m_data(mat.data()){}
+        ///from a TranslationMatrix,DiagonalMatrix,RotationMatrix or IdentityMatrix
+        template <class Mat,class = decltype(std::declval<const Mat &>().toAffine())>
+        constexpr AffineMatrix(const Mat &mat)
+            :AffineMatrix(mat.toAffine()){}
+        AffineMatrix(const AffineMatrix &) = default;
+        AffineMatrix(AffineMatrix &&) noexcept = default;
+        ~AffineMatrix() = default;
+
+        AffineMatrix &operator=(const AffineMatrix &) = default;
+        AffineMatrix &operator=(AffineMatrix &&) noexcept = default;
+
+        constexpr Type &operator()(size_t x,size_t y)noexcept{
+            return m_data(x,y);
+        }
+        constexpr const Type &operator()(size_t x,size_t y)const noexcept{
+            return m_data(x,y);
+        }
+        constexpr Type &operator[](size_t index)noexcept{
+            return m_data[index];
+        }
+        constexpr const Type &operator[](size_t index)const noexcept{
+            return m_data[index];
+        }
+        constexpr Type *data()noexcept{
+            return m_data.data();
+        }
+        constexpr const Type *data()const noexcept{
+            return m_data.data();
+        }
+        constexpr iterator begin()noexcept{
+            return m_data.begin();
+        }
+        constexpr iterator end()noexcept{
+            return m_data.end();
+        }
+        constexpr const_iterator begin()const noexcept{
+            return m_data.begin();
+        }
+        constexpr const_iterator end()const noexcept{
+            return m_data.end();
+        }
+
+        ///the stored upper 3x4
+        constexpr const matrix_type &matrix()const noexcept{
+            return m_data;
+        }
+        ///A
+        constexpr Matrix<Type,3,3> linear()const noexcept{
+            return m_data.template sub<3,3>(0,0);
+        }
+        ///t
+        constexpr Vector<Type,3> translation()const noexcept{
+            return Vector<Type,3>{m_data(0,3),m_data(1,3),m_data(2,3)};
+        }
+
+        ///the full 4x4 for upload, projection or mixing with matrix code
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            Matrix<Type,4,4> res(no_init);
+            detail::unroll<Count>([&](auto i){
+                res[i] = m_data[i];
+            });
+            res(3,0) = res(3,1) = res(3,2) = 0;
+            res(3,3) = 1;
+            return res;
+        }
+        constexpr operator Matrix<Type,4,4>()const noexcept{
+            return toMatrix();
+        }
+
+        ///A % point + t, the product with [x,y,z,1]
+        constexpr Vector<Type,3> transformPoint(const Vector<Type,3> &point)const noexcept{
+            Vector<Type,3> res(no_init);
+            detail::unroll<3>([&](auto i){
+                res[i] = m_data(i,0) * point[0] + m_data(i,1) * point[1] + m_data(i,2) * point[2] + m_data(i,3);
+            });
+            return res;
+        }
+        ///A % dir, the product with [x,y,z,0]
+        constexpr Vector<Type,3> transformDirection(const Vector<Type,3> &dir)const noexcept{
+            Vector<Type,3> res(no_init);
+            detail::unroll<3>([&](auto i){
+                res[i] = m_data(i,0) * dir[0] + m_data(i,1) * dir[1] + m_data(i,2) * dir[2];
+            });
+            return res;
+        }
+
+        ///the determinant of the 4x4, that of A
+        constexpr detail::promote_t<Type> det()const noexcept{
+            return linear().det();
+        }
+
+        /**@name inverse
+         * @note | A t |^-1 = | A^-1 -A^-1 t |, the same as Matrix<Type,4,4>::inverseAffine()
+         *       | 0 1 |      | 0     1      |
+         * @param invertible set to false (and zero A and t returned) if A is singular
+         */
+        constexpr AffineMatrix inverse(bool &invertible)const noexcept{
+            AffineMatrix res(no_init);
+            invertible = detail::inverse3x3<Type,4>(m_data.data(),res.m_data.data());
+            if(!invertible){
+                return AffineMatrix(matrix_type());
+            }
+            return res;
+        }
+        constexpr AffineMatrix inverse()const noexcept{
+            bool invertible;
+            return inverse(invertible);
+        }
+        ///for a rotation + translation only: | R^T -R^T t |
+        constexpr AffineMatrix inverseRigid()const noexcept{
+            AffineMatrix res(no_init);
+            detail::unroll<3>([&](auto i){
+                detail::unroll<3>([&](auto j){
+                    res(i,j) = m_data(j,i);
+                });
+                res(i,3) = -(m_data(0,i) * m_data(0,3) + m_data(1,i) * m_data(1,3) + m_data(2,i) * m_data(2,3));
+            });
+            return res;
+        }
+
+        ///*this = *this % mat
+        constexpr AffineMatrix &operator%=(const AffineMatrix &mat)noexcept{
+            return *this = *this % mat;
+        }
+
+        ///3 result rows instead of 4, the implied [0,0,0,1] never loaded from memory
+        friend constexpr AffineMatrix operator%(const AffineMatrix &lhs,const AffineMatrix &rhs)noexcept{
+            AffineMatrix res(no_init);
+            detail::affineProduct<Type,3>(lhs.data(),rhs.data(),res.data());
+            return res;
+        }
+        friend constexpr Matrix<Type,4,4> operator%(const Matrix<Type,4,4> &lhs,const AffineMatrix &rhs)noexcept{
+            Matrix<Type,4,4> res(no_init);
+            detail::affineProduct<Type,4>(lhs.data(),rhs.data(),res.data());
+            return res;
+        }
+        ///[A t] % rhs (3x4 % 4x4), the last row of rhs copied
+        friend constexpr Matrix<Type,4,4> operator%(const AffineMatrix &lhs,const Matrix<Type,4,4> &rhs)noexcept{
+            Matrix<Type,4,4> res(no_init);
+            detail::product<Type,3,4,4>(lhs.data(),rhs.data(),res.data());
+            detail::unroll<4>([&](auto j){
+                res(3,j) = rhs(3,j);
+            });
+            return res;
+        }
+        friend constexpr Vector<Type,3> operator%(const AffineMatrix &mat,const Vector<Type,3> &point)noexcept{
+            return mat.transformPoint(point);
+        }
+        friend constexpr Vector<Type,4> operator%(const AffineMatrix &mat,const Vector<Type,4> &vec)noexcept{
+            Vector<Type,4> res(no_init);
+            detail::unroll<3>([&](auto i){
+                res[i] = mat(i,0) * vec[0] + mat(i,1) * vec[1] + mat(i,2) * vec[2] + mat(i,3) * vec[3];
+            });
+            res[3] = vec[3];
+            return res;
+        }
+
+        constexpr bool operator==(const AffineMatrix &mat)const noexcept{
+            return m_data == mat.m_data;
+        }
+        constexpr bool operator!=(const AffineMatrix &mat)const noexcept{
+            return !(*this == mat);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const AffineMatrix &mat){
+            return os << mat.toMatrix();
+        }
+    protected:
+    private:
+        matrix_type m_data;
+    };
+
+    using AffineMatrixf = AffineMatrix<float>;
+    using AffineMatrixd = AffineMatrix<double>;
+}
+
+#endif //_XMATH_AFFINE_MATRIX_H_
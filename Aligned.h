@@ -0,0 +1,343 @@
+#ifndef _XMATH_ALIGNED_H_
+#define _XMATH_ALIGNED_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include "Matrix.h"
+#include "Vector.h"
+
+#if !defined(XMATH_CACHE_LINE)
+#define XMATH_CACHE_LINE 64
+#endif
+
+namespace xmath{
+    namespace detail{
+        /**@name alignedAlloc
+         * @note align must be a power of two,the original pointer is kept just before the returned one
+         */
+        inline void *alignedAlloc(size_t bytes,size_t align){
+            void *raw = std::malloc(bytes + align + sizeof(void *));
+            if(raw == nullptr){
+                throw std::bad_alloc();
+            }
+            auto addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+            addr = (addr + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+            reinterpret_cast<void **>(addr)[-1] = raw;
+            return reinterpret_cast<void *>(addr);
+        }
+        inline void alignedFree(void *ptr)noexcept{
+            if(ptr != nullptr){
+                std::free(reinterpret_cast<void **>(ptr)[-1]);
+            }
+        }
+    }
+
+    /**@name AlignedAllocator
+     * @note an allocator returning Align aligned storage (or alignof(Type) if that is larger),
+     *       std::vector<Type,AlignedAllocator<Type>> keeps aligned loads legal on its data()
+     */
+    template <class Type,size_t Align = XMATH_CACHE_LINE>
+    class AlignedAllocator{
+    public:
+        static_assert((Align & (Align - 1)) == 0,"Align must be a power of two");
+        using value_type = Type;
+        static constexpr size_t alignment = Align > alignof(Type) ? Align : alignof(Type);
+
+        template <class Other>
+        struct rebind{
+            using other = AlignedAllocator<Other,Align>;
+        };
+
+        constexpr AlignedAllocator()noexcept = default;
+        template <class Other>
+        constexpr AlignedAllocator(const AlignedAllocator<Other,Align> &)noexcept{}
+
+        Type *allocate(size_t count){
+            if(count > std::numeric_limits<size_t>::max() / sizeof(Type)){
+                throw std::bad_array_new_length();
+            }
+            return static_cast<Type *>(detail::alignedAlloc(count * sizeof(Type),alignment));
+        }
+        void deallocate(Type *ptr,size_t)noexcept{
+            detail::alignedFree(ptr);
+        }
+
+        template <class Other>
+        constexpr bool operator==(const AlignedAllocator<Other,Align> &)const noexcept{
+            return true;
+        }
+        template <class Other>
+        constexpr bool operator!=(const AlignedAllocator<Other,Align> &)const noexcept{
+            return false;
+        }
+    };
+
+    template <class Base,size_t Align>
+    class Aligned;
+
+    template <class Base,size_t Align>
+    struct expression_traits<Aligned<Base,Align>> : expression_traits<Base>{};
+
+    /**@name Aligned
+     * @note Base (a Matrix or Vector) placed on an Align byte boundary,
+     *       e.g. Aligned<Matrix4f,64> never straddles two cache lines
+     * @note it is a Base, everything taking a Base takes it and the results are plain Base values,
+     *       converting back and forth is a copy
+     */
+    template <class Base,size_t Align>
+    class alignas(Align) Aligned : public Base{
+    public:
+        using Base::Base;
+        constexpr Aligned():Base(){}
+        constexpr Aligned(const Base &base):Base(base){}
+        Aligned(const Aligned &) = default;
+        Aligned(Aligned &&) noexcept = default;
+        ~Aligned() = default;
+
+        Aligned &operator=(const Aligned &) = default;
+        Aligned &operator=(Aligned &&) noexcept = default;
+        constexpr Aligned &operator=(const Base &base){
+            Base::operator=(base);
+            return *this;
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,typename expression_traits<Base>::result_type>>>
+        constexpr Aligned &operator=(const Expr &expr)noexcept{
+            Base::operator=(expr);
+            return *this;
+        }
+    };
+
+    template <class Type>
+    class PaddedVector3;
+
+    ///PaddedVector3 only combines with PaddedVector3, so every operand has the fourth lane to load
+    template <class Type>
+    struct expression_traits<PaddedVector3<Type>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = true;
+        static constexpr bool is_scalar = false;
+        using value_type = Type;
+        using result_type = PaddedVector3<Type>;
+    };
+
+    /**@name PaddedVector3
+     * @note the three components of a Vector<Type,3> followed by a zero fourth lane, the four lanes
+     *       are one aligned array, element-wise expressions of PaddedVector3 run as one 4-wide Packet instead of 3 scalars
+     * @note the fourth lane is reset to zero after every evaluation, so it never holds inf/NaN
+     * @note Vector<Type,3> is the packed form for I/O and the rest of the library,
+     *       a PaddedVector3 converts to it implicitly (a copy), see convert() for arrays of them
+     */
+    template <class Type>
+    class alignas(4 * sizeof(Type)) PaddedVector3{
+    public:
+        using iterator = Type *;
+        using const_iterator = const Type *;
+
+        constexpr size_t count()const noexcept{
+            return 3;
+        }
+
+        constexpr PaddedVector3()
+            :m_data{0,0,0,0}{}
+        constexpr explicit PaddedVector3(no_init_t)noexcept{
+            m_data[3] = 0;
+        }
+        constexpr explicit PaddedVector3(Type val)
+            :m_data{val,val,val,0}{}
+        constexpr explicit PaddedVector3(const Type *ptr)
+            :m_data{ptr[0],ptr[1],ptr[2],0}{}
+        constexpr explicit PaddedVector3(std::initializer_list<Type> list)
+            :m_data{0,0,0,0}{
+            std::copy_n(list.begin(),std::min<size_t>(list.size(),3),m_data.begin());
+        }
+        constexpr PaddedVector3(const Vector<Type,3> &vec)
+            :m_data{vec[0],vec[1],vec[2],0}{}
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3(const Expr &expr)noexcept{
+            assign(expr);
+        }
+        PaddedVector3(const PaddedVector3 &) = default;
+        PaddedVector3(PaddedVector3 &&) noexcept = default;
+        ~PaddedVector3() = default;
+
+        PaddedVector3 &operator=(const PaddedVector3 &) = default;
+        PaddedVector3 &operator=(PaddedVector3 &&) noexcept = default;
+        constexpr PaddedVector3 &operator=(const Vector<Type,3> &vec){
+            return *this = PaddedVector3(vec);
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3 &operator=(const Expr &expr)noexcept{
+            assign(expr);
+            return *this;
+        }
+
+        ///a Vector<Type,3> operand is padded first, expressions must be of PaddedVector3
+
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3 &operator+=(const Expr &expr)noexcept{
+            return *this = *this + expr;
+        }
+        constexpr PaddedVector3 &operator+=(const PaddedVector3 &vec)noexcept{
+            return *this = *this + vec;
+        }
+        constexpr PaddedVector3 &operator+=(const Vector<Type,3> &vec)noexcept{
+            return *this += PaddedVector3(vec);
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3 &operator-=(const Expr &expr)noexcept{
+            return *this = *this - expr;
+        }
+        constexpr PaddedVector3 &operator-=(const PaddedVector3 &vec)noexcept{
+            return *this = *this - vec;
+        }
+        constexpr PaddedVector3 &operator-=(const Vector<Type,3> &vec)noexcept{
+            return *this -= PaddedVector3(vec);
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3 &operator*=(const Expr &expr)noexcept{
+            return *this = *this * expr;
+        }
+        constexpr PaddedVector3 &operator*=(const PaddedVector3 &vec)noexcept{
+            return *this = *this * vec;
+        }
+        constexpr PaddedVector3 &operator*=(const Vector<Type,3> &vec)noexcept{
+            return *this *= PaddedVector3(vec);
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,PaddedVector3>>>
+        constexpr PaddedVector3 &operator/=(const Expr &expr)noexcept{
+            return *this = *this / expr;
+        }
+        constexpr PaddedVector3 &operator/=(const PaddedVector3 &vec)noexcept{
+            return *this = *this / vec;
+        }
+        constexpr PaddedVector3 &operator/=(const Vector<Type,3> &vec)noexcept{
+            return *this /= PaddedVector3(vec);
+        }
+        constexpr PaddedVector3 &operator+=(const Type &value)noexcept{
+            return *this = *this + value;
+        }
+        constexpr PaddedVector3 &operator-=(const Type &value)noexcept{
+            return *this = *this - value;
+        }
+        constexpr PaddedVector3 &operator*=(const Type &value)noexcept{
+            return *this = *this * value;
+        }
+        constexpr PaddedVector3 &operator/=(const Type &value)noexcept{
+            return *this = *this / value;
+        }
+
+        constexpr Type &operator[](size_t index)noexcept{
+            return m_data[index];
+        }
+        constexpr const Type &operator[](size_t index)const noexcept{
+            return m_data[index];
+        }
+        ///the four lanes, data()[3] is the zero padding
+        constexpr Type *data()noexcept{
+            return m_data.data();
+        }
+        constexpr const Type *data()const noexcept{
+            return m_data.data();
+        }
+        constexpr iterator begin()noexcept{
+            return m_data.data();
+        }
+        constexpr iterator end()noexcept{
+            return m_data.data() + 3;
+        }
+        constexpr const_iterator begin()const noexcept{
+            return m_data.data();
+        }
+        constexpr const_iterator end()const noexcept{
+            return m_data.data() + 3;
+        }
+
+        ///the Packet starting at lane index, used by the expression evaluator
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            return Packet::load(m_data.data() + index);
+        }
+
+        ///the packed form
+        constexpr Vector<Type,3> toVector()const noexcept{
+            return Vector<Type,3>{m_data[0],m_data[1],m_data[2]};
+        }
+        constexpr operator Vector<Type,3>()const noexcept{
+            return toVector();
+        }
+
+        constexpr Type dot(const PaddedVector3 &vec)const noexcept{
+            return toVector().dot(vec.toVector());
+        }
+        constexpr PaddedVector3 cross(const PaddedVector3 &vec)const noexcept{
+            return PaddedVector3(toVector().cross(vec.toVector()));
+        }
+        constexpr Type length()const noexcept{
+            return toVector().length();
+        }
+        constexpr Type length2()const noexcept{
+            return toVector().length2();
+        }
+        constexpr PaddedVector3 normalize()const noexcept{
+            return PaddedVector3(*this / length());
+        }
+
+        ///as for Vector<Type,3>, which is not looked up for a PaddedVector3 operand
+        friend constexpr Vector<Type,3> operator%(const Matrix<Type,3,3> &mat,const PaddedVector3 &vec)noexcept{
+            return mat % vec.toVector();
+        }
+
+        constexpr bool operator==(const Vector<Type,3> &vec)const noexcept{
+            return toVector() == vec;
+        }
+        constexpr bool operator!=(const Vector<Type,3> &vec)const noexcept{
+            return !(*this == vec);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const PaddedVector3 &vec){
+            return os << vec.toVector();
+        }
+    protected:
+    private:
+        template <class Expr>
+        constexpr void assign(const Expr &expr)noexcept{
+            if(std::is_constant_evaluated()){
+                detail::evaluate<3>(m_data.data(),expr);
+            }else{
+                //every leaf of expr is a PaddedVector3, so all four lanes can be loaded
+                detail::evaluate<4>(m_data.data(),expr);
+            }
+            m_data[3] = 0;
+        }
+
+        std::array<Type,4> m_data;
+    };
+
+    /**@name convert
+     * @note between packed Vector<Type,3> arrays (12 bytes apart for float) and PaddedVector3 arrays
+     */
+    template <class Type>
+    void convert(const Vector<Type,3> *src,PaddedVector3<Type> *dst,size_t count)noexcept{
+        for(size_t i = 0;i < count;++i){
+            dst[i] = src[i];
+        }
+    }
+    template <class Type>
+    void convert(const PaddedVector3<Type> *src,Vector<Type,3> *dst,size_t count)noexcept{
+        for(size_t i = 0;i < count;++i){
+            dst[i] = src[i];
+        }
+    }
+
+    using PaddedVector3f = PaddedVector3<float>;
+    using PaddedVector3d = PaddedVector3<double>;
+
+    using AlignedVector4f = Aligned<Vector4f,16>;
+    using AlignedVector4d = Aligned<Vector4d,32>;
+    using AlignedMatrix4f = Aligned<Matrix4f,XMATH_CACHE_LINE>;
+    using AlignedMatrix4d = Aligned<Matrix4d,XMATH_CACHE_LINE>;
+}
+
+#endif //_XMATH_ALIGNED_H_
@@ -0,0 +1,386 @@
+#ifndef _XMATH_BINARY_H_
+#define _XMATH_BINARY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "Matrix.h"
+#include "Vector.h"
+#include "Quaternion.h"
+#include "Half.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xmath{
+    enum class BinaryError{
+        none,
+        open,       ///<the file could not be opened/created/mapped
+        io,         ///<a write failed
+        format,     ///<not an XMath binary file
+        version,    ///<written by a newer format version
+        endian,     ///<written on a machine of the other byte order
+        type,       ///<the records are not of the requested type
+        truncated   ///<shorter than its header says
+    };
+
+    /**@name BinaryHeader
+     * @note the first 64 bytes of an XMath binary file, the records follow at offset
+     *       (a multiple of 64, so mapped records are aligned like the cache line)
+     * @note endian holds 0x01020304 as written, a reader seeing it byte-swapped rejects the file
+     * @note scalar/kind/rows/cols describe one record, e.g. Matrix<float,3,4> is
+     *       scalar = float, kind = matrix, rows = 3, cols = 4; vectors and quaternions have cols = 1
+     */
+    struct BinaryHeader{
+        static constexpr char magic_value[8] = {'X','M','A','T','H','B','I','N'};
+        static constexpr uint32_t current_version = 1;
+        static constexpr uint32_t endian_value = 0x01020304;
+
+        enum Scalar : uint32_t{
+            float32 = 1,
+            float64 = 2,
+            int32 = 3,
+            uint32 = 4,
+            float16 = 5,
+            bfloat16 = 6
+        };
+        enum Kind : uint32_t{
+            matrix = 1,
+            vector = 2,
+            quaternion = 3
+        };
+
+        char magic[8];
+        uint32_t version;
+        uint32_t endian;
+        uint32_t scalar;
+        uint32_t kind;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t record_size;
+        uint32_t reserved;
+        uint64_t count;
+        uint64_t offset;
+        char padding[8];
+    };
+    static_assert(sizeof(BinaryHeader) == 64,"the header is one 64 byte block");
+
+    namespace detail{
+        template <class Type>
+        struct binary_scalar;
+        template <>
+        struct binary_scalar<float> : std::integral_constant<uint32_t,BinaryHeader::float32>{};
+        template <>
+        struct binary_scalar<double> : std::integral_constant<uint32_t,BinaryHeader::float64>{};
+        template <>
+        struct binary_scalar<int32_t> : std::integral_constant<uint32_t,BinaryHeader::int32>{};
+        template <>
+        struct binary_scalar<uint32_t> : std::integral_constant<uint32_t,BinaryHeader::uint32>{};
+        template <>
+        struct binary_scalar<half> : std::integral_constant<uint32_t,BinaryHeader::float16>{};
+        template <>
+        struct binary_scalar<bfloat16> : std::integral_constant<uint32_t,BinaryHeader::bfloat16>{};
+
+        ///the header fields describing one Record, for the types a binary file can hold
+        template <class Record>
+        struct binary_record;
+        template <class Type,size_t Row,size_t Col>
+        struct binary_record<Matrix<Type,Row,Col>>{
+            static constexpr uint32_t scalar = binary_scalar<Type>::value;
+            static constexpr uint32_t kind = BinaryHeader::matrix;
+            static constexpr uint32_t rows = Row;
+            static constexpr uint32_t cols = Col;
+        };
+        template <class Type,size_t Count>
+        struct binary_record<Vector<Type,Count>>{
+            static constexpr uint32_t scalar = binary_scalar<Type>::value;
+            static constexpr uint32_t kind = BinaryHeader::vector;
+            static constexpr uint32_t rows = Count;
+            static constexpr uint32_t cols = 1;
+        };
+        template <class Type>
+        struct binary_record<Quaternion<Type>>{
+            static constexpr uint32_t scalar = binary_scalar<Type>::value;
+            static constexpr uint32_t kind = BinaryHeader::quaternion;
+            static constexpr uint32_t rows = 4;
+            static constexpr uint32_t cols = 1;
+        };
+
+        template <class Record>
+        constexpr BinaryHeader binaryHeader(uint64_t count)noexcept{
+            static_assert(std::is_trivially_copyable<Record>::value,"records are stored as raw bytes");
+            BinaryHeader header{};
+            for(size_t i = 0;i < sizeof(header.magic);++i){
+                header.magic[i] = BinaryHeader::magic_value[i];
+            }
+            header.version = BinaryHeader::current_version;
+            header.endian = BinaryHeader::endian_value;
+            header.scalar = binary_record<Record>::scalar;
+            header.kind = binary_record<Record>::kind;
+            header.rows = binary_record<Record>::rows;
+            header.cols = binary_record<Record>::cols;
+            header.record_size = sizeof(Record);
+            header.count = count;
+            header.offset = sizeof(BinaryHeader);
+            return header;
+        }
+
+        ///checks a header read from a file of size bytes against Record
+        template <class Record>
+        BinaryError checkBinaryHeader(const BinaryHeader &header,uint64_t size)noexcept{
+            if(std::memcmp(header.magic,BinaryHeader::magic_value,sizeof(header.magic)) != 0){
+                return BinaryError::format;
+            }
+            if(header.endian != BinaryHeader::endian_value){
+                return BinaryError::endian;
+            }
+            if(header.version > BinaryHeader::current_version){
+                return BinaryError::version;
+            }
+            const BinaryHeader expected = binaryHeader<Record>(0);
+            if(header.scalar != expected.scalar || header.kind != expected.kind
+               || header.rows != expected.rows || header.cols != expected.cols
+               || header.record_size != expected.record_size){
+                return BinaryError::type;
+            }
+            if(header.offset < sizeof(BinaryHeader) || header.offset % alignof(Record) != 0
+               || header.offset > size || header.count > (size - header.offset) / sizeof(Record)){
+                return BinaryError::truncated;
+            }
+            return BinaryError::none;
+        }
+    }
+
+    /**@name BinaryWriter
+     * @note streams Records into an XMath binary file,
+     *       the record count in the header is filled in by close() (or the destructor)
+     */
+    template <class Record>
+    class BinaryWriter{
+    public:
+        BinaryWriter() = default;
+        explicit BinaryWriter(const char *path){
+            open(path);
+        }
+        BinaryWriter(const BinaryWriter &) = delete;
+        BinaryWriter &operator=(const BinaryWriter &) = delete;
+        ~BinaryWriter(){
+            close();
+        }
+
+        BinaryError open(const char *path)noexcept{
+            close();
+            m_file = std::fopen(path,"wb");
+            if(m_file == nullptr){
+                return m_error = BinaryError::open;
+            }
+            m_count = 0;
+            const BinaryHeader header = detail::binaryHeader<Record>(0);
+            m_error = std::fwrite(&header,sizeof(header),1,m_file) == 1 ? BinaryError::none : BinaryError::io;
+            return m_error;
+        }
+
+        BinaryError write(const Record *records,size_t count)noexcept{
+            if(m_file == nullptr || m_error != BinaryError::none){
+                return m_error == BinaryError::none ? BinaryError::open : m_error;
+            }
+            if(std::fwrite(records,sizeof(Record),count,m_file) != count){
+                return m_error = BinaryError::io;
+            }
+            m_count += count;
+            return BinaryError::none;
+        }
+        BinaryError write(std::span<const Record> records)noexcept{
+            return write(records.data(),records.size());
+        }
+
+        ///patches the record count into the header and closes the file
+        BinaryError close()noexcept{
+            if(m_file == nullptr){
+                return m_error;
+            }
+            if(m_error == BinaryError::none){
+                const BinaryHeader header = detail::binaryHeader<Record>(m_count);
+                if(std::fseek(m_file,0,SEEK_SET) != 0 || std::fwrite(&header,sizeof(header),1,m_file) != 1){
+                    m_error = BinaryError::io;
+                }
+            }
+            if(std::fclose(m_file) != 0 && m_error == BinaryError::none){
+                m_error = BinaryError::io;
+            }
+            m_file = nullptr;
+            return m_error;
+        }
+
+        size_t size()const noexcept{
+            return m_count;
+        }
+        BinaryError error()const noexcept{
+            return m_error;
+        }
+    protected:
+    private:
+        std::FILE *m_file = nullptr;
+        uint64_t m_count = 0;
+        BinaryError m_error = BinaryError::none;
+    };
+
+    template <class Record>
+    BinaryError writeBinary(const char *path,const Record *records,size_t count)noexcept{
+        BinaryWriter<Record> writer;
+        writer.open(path);
+        writer.write(records,count);
+        return writer.close();
+    }
+
+    /**@name MappedBinary
+     * @note maps an XMath binary file read-only and exposes its Records in place:
+     *       open() only checks the 64 byte header, nothing is parsed or copied,
+     *       pages are read by the OS the first time a record is touched
+     * @note records() stays valid until close()/open()/destruction
+     */
+    template <class Record>
+    class MappedBinary{
+    public:
+        MappedBinary() = default;
+        explicit MappedBinary(const char *path){
+            open(path);
+        }
+        MappedBinary(const MappedBinary &) = delete;
+        MappedBinary &operator=(const MappedBinary &) = delete;
+        MappedBinary(MappedBinary &&other)noexcept
+            :m_map(std::exchange(other.m_map,nullptr)),m_bytes(std::exchange(other.m_bytes,0)),
+             m_records(std::exchange(other.m_records,{})){}
+        MappedBinary &operator=(MappedBinary &&other)noexcept{
+            if(this != &other){
+                close();
+                m_map = std::exchange(other.m_map,nullptr);
+                m_bytes = std::exchange(other.m_bytes,0);
+                m_records = std::exchange(other.m_records,{});
+            }
+            return *this;
+        }
+        ~MappedBinary(){
+            close();
+        }
+
+        BinaryError open(const char *path)noexcept{
+            close();
+            if(!map(path)){
+                return BinaryError::open;
+            }
+            if(m_bytes < sizeof(BinaryHeader)){
+                close();
+                return BinaryError::format;
+            }
+            BinaryHeader header;
+            std::memcpy(&header,m_map,sizeof(header));
+            const BinaryError error = detail::checkBinaryHeader<Record>(header,m_bytes);
+            if(error != BinaryError::none){
+                close();
+                return error;
+            }
+            m_records = std::span<const Record>(
+                    reinterpret_cast<const Record *>(static_cast<const char *>(m_map) + header.offset),
+                    static_cast<size_t>(header.count));
+            return BinaryError::none;
+        }
+        void close()noexcept{
+            if(m_map != nullptr){
+                unmap();
+            }
+            m_map = nullptr;
+            m_bytes = 0;
+            m_records = {};
+        }
+
+        bool isOpen()const noexcept{
+            return m_map != nullptr;
+        }
+        std::span<const Record> records()const noexcept{
+            return m_records;
+        }
+        size_t size()const noexcept{
+            return m_records.size();
+        }
+        const Record &operator[](size_t index)const noexcept{
+            return m_records[index];
+        }
+        auto begin()const noexcept{
+            return m_records.begin();
+        }
+        auto end()const noexcept{
+            return m_records.end();
+        }
+    protected:
+    private:
+#if defined(_WIN32)
+        bool map(const char *path)noexcept{
+            HANDLE file = CreateFileA(path,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+            if(file == INVALID_HANDLE_VALUE){
+                return false;
+            }
+            LARGE_INTEGER size;
+            HANDLE mapping = nullptr;
+            if(GetFileSizeEx(file,&size) && size.QuadPart > 0){
+                mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+            }
+            CloseHandle(file);
+            if(mapping == nullptr){
+                return false;
+            }
+            m_map = MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+            CloseHandle(mapping);
+            if(m_map == nullptr){
+                return false;
+            }
+            m_bytes = static_cast<size_t>(size.QuadPart);
+            return true;
+        }
+        void unmap()noexcept{
+            UnmapViewOfFile(m_map);
+        }
+#else
+        bool map(const char *path)noexcept{
+            const int file = ::open(path,O_RDONLY);
+            if(file < 0){
+                return false;
+            }
+            struct stat info;
+            void *ptr = MAP_FAILED;
+            if(::fstat(file,&info) == 0 && info.st_size > 0){
+                ptr = ::mmap(nullptr,static_cast<size_t>(info.st_size),PROT_READ,MAP_PRIVATE,file,0);
+            }
+            ::close(file);
+            if(ptr == MAP_FAILED){
+                return false;
+            }
+            m_map = ptr;
+            m_bytes = static_cast<size_t>(info.st_size);
+            return true;
+        }
+        void unmap()noexcept{
+            ::munmap(m_map,m_bytes);
+        }
+#endif
+
+        void *m_map = nullptr;
+        size_t m_bytes = 0;
+        std::span<const Record> m_records;
+    };
+}
+
+#endif //_XMATH_BINARY_H_
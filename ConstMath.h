@@ -0,0 +1,166 @@
+#ifndef _XMATH_CONSTMATH_H_
+#define _XMATH_CONSTMATH_H_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace xmath{
+    namespace detail{
+        /**@name constant-expression math
+         * @note <cmath> is not usable in constant expressions (until C++23/26),
+         *       these call std:: at runtime and fall back to plain series/iterations
+         *       while constant-evaluated, so runtime results are unchanged
+         * @note integer arguments are computed in double, like std::sqrt(int)
+         */
+        template <class Type>
+        using math_t = std::conditional_t<std::is_floating_point<Type>::value,Type,double>;
+
+        ///any Type with a sign, storage-only types (half,bfloat16) included
+        template <class Type>
+        constexpr Type abs(const Type &value)noexcept{
+            if constexpr (std::is_unsigned<Type>::value){
+                return value;
+            }else{
+                if constexpr (std::is_floating_point<Type>::value){
+                    //one and with the sign mask, the comparison below is a compare and a blend
+                    if(!std::is_constant_evaluated()){
+                        return std::fabs(value);
+                    }
+                }
+                return value < Type(0) ? Type(-value) : value;
+            }
+        }
+
+        template <class Type>
+        constexpr Type round(const Type &value)noexcept{
+            if(std::is_constant_evaluated()){
+                //half away from zero, like std::round
+                const auto truncated = static_cast<long long>(value);
+                const Type fraction = value - static_cast<Type>(truncated);
+                if(fraction >= Type(0.5)){
+                    return static_cast<Type>(truncated + 1);
+                }
+                if(fraction <= Type(-0.5)){
+                    return static_cast<Type>(truncated - 1);
+                }
+                return static_cast<Type>(truncated);
+            }
+            return std::round(value);
+        }
+
+        template <class Type>
+        constexpr math_t<Type> sqrt(const Type &value)noexcept{
+            using Compute = math_t<Type>;
+            if(std::is_constant_evaluated()){
+                const auto x = static_cast<Compute>(value);
+                if(!(x >= Compute(0))){
+                    return std::numeric_limits<Compute>::quiet_NaN();
+                }
+                if(x == Compute(0) || x == std::numeric_limits<Compute>::infinity()){
+                    return x;
+                }
+                //Newton from above decreases monotonically until it reaches the root
+                Compute res = x > Compute(1) ? x : Compute(1);
+                for(;;){
+                    const Compute next = (res + x / res) / 2;
+                    if(next >= res){
+                        return res;
+                    }
+                    res = next;
+                }
+            }
+            return std::sqrt(static_cast<Compute>(value));
+        }
+
+        ///Taylor series of sin/cos about 0 after reducing x to [-pi,pi], in long double
+        constexpr long double sinCosSeries(long double x,bool cosine)noexcept{
+            constexpr long double pi = 3.141592653589793238462643383279502884L;
+            const long double turns = x / (2 * pi);
+            const auto whole = static_cast<long double>(static_cast<long long>(turns < 0 ? turns - 0.5L : turns + 0.5L));
+            x -= whole * 2 * pi;
+            long double term = cosine ? 1.0L : x;
+            long double sum = term;
+            for(int k = 1;k < 64;++k){
+                const long double n = cosine ? 2 * k - 1 : 2 * k;
+                term *= -x * x / (n * (n + 1));
+                if(sum + term == sum){
+                    break;
+                }
+                sum += term;
+            }
+            return sum;
+        }
+
+        template <class Type>
+        constexpr math_t<Type> sin(const Type &value)noexcept{
+            using Compute = math_t<Type>;
+            if(std::is_constant_evaluated()){
+                return static_cast<Compute>(sinCosSeries(static_cast<long double>(value),false));
+            }
+            return std::sin(static_cast<Compute>(value));
+        }
+
+        template <class Type>
+        constexpr math_t<Type> cos(const Type &value)noexcept{
+            using Compute = math_t<Type>;
+            if(std::is_constant_evaluated()){
+                return static_cast<Compute>(sinCosSeries(static_cast<long double>(value),true));
+            }
+            return std::cos(static_cast<Compute>(value));
+        }
+
+        ///atan by reduction to |x| <= tan(pi/8) and its Taylor series, in long double
+        constexpr long double atanSeries(long double x)noexcept{
+            constexpr long double pi = 3.141592653589793238462643383279502884L;
+            const bool negative = x < 0;
+            x = negative ? -x : x;
+            const bool inverted = x > 1;
+            x = inverted ? 1 / x : x;
+            const bool shifted = x > 0.414213562373095048801688724209698079L;
+            x = shifted ? (x - 1) / (x + 1) : x;
+            long double term = x;
+            long double sum = x;
+            for(int k = 1;k < 256;++k){
+                term *= -x * x;
+                const long double next = term / (2 * k + 1);
+                if(sum + next == sum){
+                    break;
+                }
+                sum += next;
+            }
+            sum = shifted ? sum + pi / 4 : sum;
+            sum = inverted ? pi / 2 - sum : sum;
+            return negative ? -sum : sum;
+        }
+
+        template <class Type>
+        constexpr math_t<Type> acos(const Type &value)noexcept{
+            using Compute = math_t<Type>;
+            if(std::is_constant_evaluated()){
+                const auto x = static_cast<long double>(value);
+                if(x <= -1){
+                    return static_cast<Compute>(3.141592653589793238462643383279502884L);
+                }
+                if(x >= 1){
+                    return Compute(0);
+                }
+                return static_cast<Compute>(2 * atanSeries(detail::sqrt((1 - x) / (1 + x))));
+            }
+            return std::acos(static_cast<Compute>(value));
+        }
+
+        template <class Type>
+        constexpr math_t<Type> tan(const Type &value)noexcept{
+            using Compute = math_t<Type>;
+            if(std::is_constant_evaluated()){
+                const auto x = static_cast<long double>(value);
+                return static_cast<Compute>(sinCosSeries(x,false) / sinCosSeries(x,true));
+            }
+            return std::tan(static_cast<Compute>(value));
+        }
+    }
+}
+
+#endif //_XMATH_CONSTMATH_H_
@@ -0,0 +1,359 @@
+#ifndef _XMATH_DECOMPOSITION_H_
+#define _XMATH_DECOMPOSITION_H_
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace xmath{
+    namespace detail{
+        /**@name choleskyDecompose
+         * @note in-place A = L L^T of the symmetric N x N row-major l, only the lower triangle is read,
+         *       afterwards it holds L (the upper triangle is left as it was)
+         * @param tolerance pivots not larger than this are treated as zero
+         * @return false if the matrix is not (numerically) positive definite
+         */
+        template <class Type,size_t N>
+        constexpr bool choleskyDecompose(Type *l,Type tolerance)noexcept{
+            for(size_t j = 0;j < N;++j){
+                Type diag = l[j * N + j];
+                for(size_t k = 0;k < j;++k){
+                    diag -= l[j * N + k] * l[j * N + k];
+                }
+                if(diag <= tolerance){
+                    return false;
+                }
+                diag = detail::sqrt(diag);
+                l[j * N + j] = diag;
+                const Type inv_diag = Type(1) / diag;
+                for(size_t i = j + 1;i < N;++i){
+                    Type sum = l[i * N + j];
+                    for(size_t k = 0;k < j;++k){
+                        sum -= l[i * N + k] * l[j * N + k];
+                    }
+                    l[i * N + j] = sum * inv_diag;
+                }
+            }
+            return true;
+        }
+
+        /**@name choleskySolve
+         * @note solves L L^T x = b for Cols right-hand sides (b and x are N x Cols, row-major)
+         *       given the output of choleskyDecompose, x may be b
+         */
+        template <class Type,size_t N,size_t Cols>
+        constexpr void choleskySolve(const Type *l,const Type *b,Type *x)noexcept{
+            for(size_t i = 0;i < N;++i){
+                const Type inv_diag = Type(1) / l[i * N + i];
+                for(size_t c = 0;c < Cols;++c){
+                    Type sum = b[i * Cols + c];
+                    for(size_t k = 0;k < i;++k){
+                        sum -= l[i * N + k] * x[k * Cols + c];
+                    }
+                    x[i * Cols + c] = sum * inv_diag;
+                }
+            }
+            for(size_t i = N;i-- > 0;){
+                const Type inv_diag = Type(1) / l[i * N + i];
+                for(size_t c = 0;c < Cols;++c){
+                    Type sum = x[i * Cols + c];
+                    for(size_t k = i + 1;k < N;++k){
+                        sum -= l[k * N + i] * x[k * Cols + c];
+                    }
+                    x[i * Cols + c] = sum * inv_diag;
+                }
+            }
+        }
+
+        /**@name householderDecompose
+         * @note in-place QR decomposition of the Row x Col (Row >= Col) row-major qr by Householder reflections,
+         *       afterwards column k of qr holds the reflection vector v_k from row k down,
+         *       H_k = I - tau[k] v_k v_k^T, the strict upper triangle holds R and rdiag its diagonal
+         * @param tolerance diagonal entries of R not larger than this are treated as zero
+         * @return false if the matrix does not have full column rank
+         */
+        template <class Type,size_t Row,size_t Col>
+        constexpr bool householderDecompose(Type *qr,Type *tau,Type *rdiag,Type tolerance)noexcept{
+            bool full_rank = true;
+            for(size_t k = 0;k < Col;++k){
+                Type norm2 = 0;
+                for(size_t i = k;i < Row;++i){
+                    norm2 += qr[i * Col + k] * qr[i * Col + k];
+                }
+                const Type norm = detail::sqrt(norm2);
+                if(norm <= tolerance){
+                    tau[k] = 0;
+                    rdiag[k] = 0;
+                    full_rank = false;
+                    continue;
+                }
+                //reflect onto -sign(a_kk) * norm so v_k[0] never cancels
+                const Type alpha = qr[k * Col + k] > Type(0) ? -norm : norm;
+                qr[k * Col + k] -= alpha;
+                tau[k] = Type(1) / (norm2 - alpha * (qr[k * Col + k] + alpha));
+                rdiag[k] = alpha;
+                for(size_t j = k + 1;j < Col;++j){
+                    Type dot = 0;
+                    for(size_t i = k;i < Row;++i){
+                        dot += qr[i * Col + k] * qr[i * Col + j];
+                    }
+                    dot *= tau[k];
+                    for(size_t i = k;i < Row;++i){
+                        qr[i * Col + j] -= dot * qr[i * Col + k];
+                    }
+                }
+            }
+            return full_rank;
+        }
+
+        /**@name householderSolve
+         * @note the least squares solution x (Col x Cols) of A x = b (Row x Cols),
+         *       given the output of householderDecompose for a full rank A, b is overwritten by Q^T b
+         */
+        template <class Type,size_t Row,size_t Col,size_t Cols>
+        constexpr void householderSolve(const Type *qr,const Type *tau,const Type *rdiag,Type *b,Type *x)noexcept{
+            for(size_t k = 0;k < Col;++k){
+                for(size_t c = 0;c < Cols;++c){
+                    Type dot = 0;
+                    for(size_t i = k;i < Row;++i){
+                        dot += qr[i * Col + k] * b[i * Cols + c];
+                    }
+                    dot *= tau[k];
+                    for(size_t i = k;i < Row;++i){
+                        b[i * Cols + c] -= dot * qr[i * Col + k];
+                    }
+                }
+            }
+            for(size_t i = Col;i-- > 0;){
+                const Type inv_diag = Type(1) / rdiag[i];
+                for(size_t c = 0;c < Cols;++c){
+                    Type sum = b[i * Cols + c];
+                    for(size_t k = i + 1;k < Col;++k){
+                        sum -= qr[i * Col + k] * x[k * Cols + c];
+                    }
+                    x[i * Cols + c] = sum * inv_diag;
+                }
+            }
+        }
+    }
+
+    /**@name LUDecomposition
+     * @note P A = L U with partial pivoting, factorised once by the constructor,
+     *       then solve()/det()/inverse() reuse it: O(N^3) once, O(N^2) per right-hand side
+     * @note arithmetic runs in detail::compute_t<Type> (double for integer and storage-only types)
+     * @note for a singular matrix invertible() is false, solve()/inverse() return zero and det() 0
+     */
+    template <class Type,size_t N>
+    class LUDecomposition{
+    public:
+        constexpr explicit LUDecomposition(const Matrix<Type,N,N> &mat)noexcept{
+            for(size_t i = 0;i < N * N;++i){
+                m_lu[i] = static_cast<Compute>(mat[i]);
+            }
+            const Compute tolerance = N * std::numeric_limits<Compute>::epsilon()
+                                    * detail::maxAbs<Compute,N * N>(mat.data());
+            m_invertible = detail::luDecompose<Compute,N>(m_lu.data(),m_perm.data(),m_sign,tolerance);
+        }
+
+        constexpr bool invertible()const noexcept{
+            return m_invertible;
+        }
+        constexpr Type det()const noexcept{
+            if(!m_invertible){
+                return Type(0);
+            }
+            Compute res = m_sign;
+            for(size_t i = 0;i < N;++i){
+                res *= m_lu[i * N + i];
+            }
+            return detail::computeCast<Type>(res);
+        }
+
+        ///x with A % x = b, for every column of b
+        template <size_t Cols>
+        constexpr Matrix<Type,N,Cols> solve(const Matrix<Type,N,Cols> &b)const noexcept{
+            if(!m_invertible){
+                return Matrix<Type,N,Cols>();
+            }
+            std::array<Compute,N * Cols> rhs,x;
+            for(size_t i = 0;i < N * Cols;++i){
+                rhs[i] = static_cast<Compute>(b[i]);
+            }
+            detail::luSolve<Compute,N,Cols>(m_lu.data(),m_perm.data(),rhs.data(),x.data());
+            Matrix<Type,N,Cols> res(no_init);
+            for(size_t i = 0;i < N * Cols;++i){
+                res[i] = detail::computeCast<Type>(x[i]);
+            }
+            return res;
+        }
+        constexpr Vector<Type,N> solve(const Vector<Type,N> &b)const noexcept{
+            return Vector<Type,N>(solve(b.toCol()));
+        }
+        constexpr Matrix<Type,N,N> inverse()const noexcept{
+            Matrix<Type,N,N> id;
+            for(size_t i = 0;i < N;++i){
+                id(i,i) = 1;
+            }
+            return solve(id);
+        }
+    protected:
+    private:
+        using Compute = detail::compute_t<Type>;
+
+        std::array<Compute,N * N> m_lu{};
+        std::array<size_t,N> m_perm{};
+        int m_sign = 1;
+        bool m_invertible = false;
+    };
+
+    /**@name CholeskyDecomposition
+     * @note A = L L^T for a symmetric positive definite A (only its lower triangle is read),
+     *       about half the work of LU and no pivoting, e.g. for the normal equations J^T J x = J^T r
+     * @note positiveDefinite() is false if a pivot is not positive, solve()/inverse() then return zero and det() 0
+     */
+    template <class Type,size_t N>
+    class CholeskyDecomposition{
+    public:
+        constexpr explicit CholeskyDecomposition(const Matrix<Type,N,N> &mat)noexcept{
+            Compute scale = 0;
+            for(size_t i = 0;i < N;++i){
+                for(size_t j = 0;j <= i;++j){
+                    m_l[i * N + j] = static_cast<Compute>(mat(i,j));
+                }
+                scale = std::max(scale,detail::abs(m_l[i * N + i]));
+            }
+            m_positive_definite = detail::choleskyDecompose<Compute,N>(m_l.data(),N * std::numeric_limits<Compute>::epsilon() * scale);
+        }
+
+        constexpr bool positiveDefinite()const noexcept{
+            return m_positive_definite;
+        }
+        ///the lower triangular factor
+        constexpr Matrix<Type,N,N> l()const noexcept{
+            Matrix<Type,N,N> res;
+            if(m_positive_definite){
+                for(size_t i = 0;i < N;++i){
+                    for(size_t j = 0;j <= i;++j){
+                        res(i,j) = detail::computeCast<Type>(m_l[i * N + j]);
+                    }
+                }
+            }
+            return res;
+        }
+        constexpr Type det()const noexcept{
+            if(!m_positive_definite){
+                return Type(0);
+            }
+            Compute res = 1;
+            for(size_t i = 0;i < N;++i){
+                res *= m_l[i * N + i] * m_l[i * N + i];
+            }
+            return detail::computeCast<Type>(res);
+        }
+
+        ///x with A % x = b, for every column of b
+        template <size_t Cols>
+        constexpr Matrix<Type,N,Cols> solve(const Matrix<Type,N,Cols> &b)const noexcept{
+            if(!m_positive_definite){
+                return Matrix<Type,N,Cols>();
+            }
+            std::array<Compute,N * Cols> x;
+            for(size_t i = 0;i < N * Cols;++i){
+                x[i] = static_cast<Compute>(b[i]);
+            }
+            detail::choleskySolve<Compute,N,Cols>(m_l.data(),x.data(),x.data());
+            Matrix<Type,N,Cols> res(no_init);
+            for(size_t i = 0;i < N * Cols;++i){
+                res[i] = detail::computeCast<Type>(x[i]);
+            }
+            return res;
+        }
+        constexpr Vector<Type,N> solve(const Vector<Type,N> &b)const noexcept{
+            return Vector<Type,N>(solve(b.toCol()));
+        }
+        constexpr Matrix<Type,N,N> inverse()const noexcept{
+            Matrix<Type,N,N> id;
+            for(size_t i = 0;i < N;++i){
+                id(i,i) = 1;
+            }
+            return solve(id);
+        }
+    protected:
+    private:
+        using Compute = detail::compute_t<Type>;
+
+        std::array<Compute,N * N> m_l{};
+        bool m_positive_definite = false;
+    };
+
+    /**@name QRDecomposition
+     * @note A = Q R by Householder reflections for a Row x Col A with Row >= Col,
+     *       Q is kept as its Col reflections and never formed
+     * @note solve() gives the least squares x minimising |A % x - b| (the exact solution if Row == Col)
+     *       without forming A^T A, so it keeps the conditioning of A instead of squaring it
+     * @note fullRank() is false if A has dependent columns, solve() then returns zero
+     */
+    template <class Type,size_t Row,size_t Col>
+    class QRDecomposition{
+    public:
+        static_assert(Row >= Col,"QR needs at least as many rows as columns");
+
+        constexpr explicit QRDecomposition(const Matrix<Type,Row,Col> &mat)noexcept{
+            for(size_t i = 0;i < Row * Col;++i){
+                m_qr[i] = static_cast<Compute>(mat[i]);
+            }
+            const Compute tolerance = Row * std::numeric_limits<Compute>::epsilon()
+                                    * detail::maxAbs<Compute,Row * Col>(mat.data());
+            m_full_rank = detail::householderDecompose<Compute,Row,Col>(m_qr.data(),m_tau.data(),m_rdiag.data(),tolerance);
+        }
+
+        constexpr bool fullRank()const noexcept{
+            return m_full_rank;
+        }
+        ///the Col x Col upper triangular factor
+        constexpr Matrix<Type,Col,Col> r()const noexcept{
+            Matrix<Type,Col,Col> res;
+            for(size_t i = 0;i < Col;++i){
+                res(i,i) = detail::computeCast<Type>(m_rdiag[i]);
+                for(size_t j = i + 1;j < Col;++j){
+                    res(i,j) = detail::computeCast<Type>(m_qr[i * Col + j]);
+                }
+            }
+            return res;
+        }
+
+        ///the least squares x of A % x = b, for every column of b
+        template <size_t Cols>
+        constexpr Matrix<Type,Col,Cols> solve(const Matrix<Type,Row,Cols> &b)const noexcept{
+            if(!m_full_rank){
+                return Matrix<Type,Col,Cols>();
+            }
+            std::array<Compute,Row * Cols> rhs;
+            std::array<Compute,Col * Cols> x;
+            for(size_t i = 0;i < Row * Cols;++i){
+                rhs[i] = static_cast<Compute>(b[i]);
+            }
+            detail::householderSolve<Compute,Row,Col,Cols>(m_qr.data(),m_tau.data(),m_rdiag.data(),rhs.data(),x.data());
+            Matrix<Type,Col,Cols> res(no_init);
+            for(size_t i = 0;i < Col * Cols;++i){
+                res[i] = detail::computeCast<Type>(x[i]);
+            }
+            return res;
+        }
+        constexpr Vector<Type,Col> solve(const Vector<Type,Row> &b)const noexcept{
+            return Vector<Type,Col>(solve(b.toCol()));
+        }
+    protected:
+    private:
+        using Compute = detail::compute_t<Type>;
+
+        std::array<Compute,Row * Col> m_qr{};
+        std::array<Compute,Col> m_tau{};
+        std::array<Compute,Col> m_rdiag{};
+        bool m_full_rank = false;
+    };
+}
+
+#endif //_XMATH_DECOMPOSITION_H_
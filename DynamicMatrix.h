@@ -0,0 +1,681 @@
+#ifndef _XMATH_DYNAMICMATRIX_H_
+#define _XMATH_DYNAMICMATRIX_H_
+
+#include "Aligned.h"
+#include "Vector.h"
+
+#if !defined(XMATH_DYNAMIC_ALIGN)
+#define XMATH_DYNAMIC_ALIGN XMATH_CACHE_LINE
+#endif
+
+namespace xmath{
+    namespace detail{
+        /**@name gemm
+         * @note c(m x n) += a(m x k) % b(k x n), all row-major with leading dimensions lda,ldb,ldc
+         * @note blocked over k/n/m so the working set of b and c stays in cache,
+         *       full 4 x (2 packets) tiles of c are accumulated in registers
+         */
+        template <class Type>
+        void gemm(size_t m,size_t n,size_t k,
+                  const Type *a,size_t lda,
+                  const Type *b,size_t ldb,
+                  Type *c,size_t ldc)noexcept{
+            using P = widest_packet_t<Type>;
+            constexpr size_t MR = 4;
+            constexpr size_t NR = 2 * P::size;
+            constexpr size_t MC = 64;
+            constexpr size_t KC = 256;
+            constexpr size_t NC = 512;
+
+            for(size_t jc = 0;jc < n;jc += NC){
+                const size_t nc = std::min(NC,n - jc);
+                const size_t nc_full = nc / NR * NR;
+                for(size_t pc = 0;pc < k;pc += KC){
+                    const size_t kc = std::min(KC,k - pc);
+                    for(size_t ic = 0;ic < m;ic += MC){
+                        const size_t mc = std::min(MC,m - ic);
+                        const size_t mc_full = mc / MR * MR;
+                        for(size_t jr = 0;jr < nc_full;jr += NR){
+                            for(size_t ir = 0;ir < mc_full;ir += MR){
+                                const Type *pa = a + (ic + ir) * lda + pc;
+                                const Type *pb = b + pc * ldb + jc + jr;
+                                Type *pc_ = c + (ic + ir) * ldc + jc + jr;
+                                P acc[MR][2];
+                                for(size_t r = 0;r < MR;++r){
+                                    acc[r][0] = P::load(pc_ + r * ldc);
+                                    acc[r][1] = P::load(pc_ + r * ldc + P::size);
+                                }
+                                for(size_t p = 0;p < kc;++p){
+                                    const auto b0 = P::load(pb + p * ldb);
+                                    const auto b1 = P::load(pb + p * ldb + P::size);
+                                    for(size_t r = 0;r < MR;++r){
+                                        const auto av = P::broadcast(pa[r * lda + p]);
+                                        acc[r][0] = madd(av,b0,acc[r][0]);
+                                        acc[r][1] = madd(av,b1,acc[r][1]);
+                                    }
+                                }
+                                for(size_t r = 0;r < MR;++r){
+                                    acc[r][0].store(pc_ + r * ldc);
+                                    acc[r][1].store(pc_ + r * ldc + P::size);
+                                }
+                            }
+                            //remaining rows of this column tile
+                            for(size_t i = ic + mc_full;i < ic + mc;++i){
+                                for(size_t p = pc;p < pc + kc;++p){
+                                    const Type av = a[i * lda + p];
+                                    for(size_t j = jc + jr;j < jc + jr + NR;++j){
+                                        c[i * ldc + j] += av * b[p * ldb + j];
+                                    }
+                                }
+                            }
+                        }
+                        //remaining columns
+                        for(size_t i = ic;i < ic + mc;++i){
+                            for(size_t p = pc;p < pc + kc;++p){
+                                const Type av = a[i * lda + p];
+                                for(size_t j = jc + nc_full;j < jc + nc;++j){
+                                    c[i * ldc + j] += av * b[p * ldb + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**@name DynamicMatrixView
+     * @note a non-owning,row-major window onto Matrix/DynamicMatrix storage,
+     *       Type may be const for read-only views
+     */
+    template <class Type>
+    class DynamicMatrixView{
+    public:
+        using value_type = std::remove_const_t<Type>;
+
+        DynamicMatrixView()noexcept
+            :m_data(nullptr),m_rows(0),m_cols(0),m_stride(0){}
+        DynamicMatrixView(Type *data,size_t rows,size_t cols,size_t stride)noexcept
+            :m_data(data),m_rows(rows),m_cols(cols),m_stride(stride){}
+        DynamicMatrixView(Type *data,size_t rows,size_t cols)noexcept
+            :DynamicMatrixView(data,rows,cols,cols){}
+        template <size_t Row,size_t Col>
+        DynamicMatrixView(Matrix<value_type,Row,Col> &mat)noexcept
+            :DynamicMatrixView(mat.data(),Row,Col){}
+        template <size_t Row,size_t Col,class Type2 = Type,
+                  class = std::enable_if_t<std::is_const<Type2>::value>>
+        DynamicMatrixView(const Matrix<value_type,Row,Col> &mat)noexcept
+            :DynamicMatrixView(mat.data(),Row,Col){}
+        template <class Type2 = Type,
+                  class = std::enable_if_t<std::is_const<Type2>::value>>
+        DynamicMatrixView(const DynamicMatrixView<value_type> &view)noexcept
+            :DynamicMatrixView(view.data(),view.getRowCount(),view.getColCount(),view.getStride()){}
+
+        size_t getRowCount()const noexcept{
+            return m_rows;
+        }
+        size_t getColCount()const noexcept{
+            return m_cols;
+        }
+        ///distance in elements between two consecutive rows
+        size_t getStride()const noexcept{
+            return m_stride;
+        }
+        size_t count()const noexcept{
+            return m_rows * m_cols;
+        }
+
+        Type &operator()(size_t x,size_t y)const noexcept{
+            return m_data[x * m_stride + y];
+        }
+        Type *data()const noexcept{
+            return m_data;
+        }
+
+        DynamicMatrixView sub(size_t x,size_t y,size_t rows,size_t cols)const noexcept{
+            return DynamicMatrixView(m_data + x * m_stride + y,rows,cols,m_stride);
+        }
+
+        ///copies the view into a fixed-size Matrix
+        template <size_t Row,size_t Col>
+        Matrix<value_type,Row,Col> toMatrix()const noexcept{
+            Matrix<value_type,Row,Col> res;
+            for(size_t i = 0;i < Row && i < m_rows;++i){
+                for(size_t j = 0;j < Col && j < m_cols;++j){
+                    res(i,j) = (*this)(i,j);
+                }
+            }
+            return res;
+        }
+    private:
+        Type *m_data;
+        size_t m_rows;
+        size_t m_cols;
+        size_t m_stride;
+    };
+
+    template <class Type>
+    class DynamicVector;
+
+    /**@name DynamicMatrix
+     * @note a row-major matrix with runtime dimensions on XMATH_DYNAMIC_ALIGN aligned heap storage
+     * @note operations on mismatching dimensions return an empty (0 x 0) matrix
+     */
+    template <class Type>
+    class DynamicMatrix{
+    public:
+        using value_type = Type;
+        using iterator = Type *;
+        using const_iterator = const Type *;
+
+        DynamicMatrix()noexcept
+            :m_data(nullptr),m_rows(0),m_cols(0){}
+        DynamicMatrix(size_t rows,size_t cols)
+            :DynamicMatrix(rows,cols,Type(0)){}
+        DynamicMatrix(size_t rows,size_t cols,Type value)
+            :m_data(allocate(rows * cols)),m_rows(rows),m_cols(cols){
+            std::fill(begin(),end(),value);
+        }
+        ///leaves the elements uninitialised
+        DynamicMatrix(size_t rows,size_t cols,no_init_t)
+            :m_data(allocate(rows * cols)),m_rows(rows),m_cols(cols){}
+        DynamicMatrix(size_t rows,size_t cols,std::initializer_list<Type> list)
+            :DynamicMatrix(rows,cols,no_init){
+            const auto last = std::copy(list.begin(),list.begin() + std::min(list.size(),count()),begin());
+            std::fill(last,end(),Type(0));
+        }
+        DynamicMatrix(DynamicMatrixView<const Type> view)
+            :m_data(allocate(view.count())),m_rows(view.getRowCount()),m_cols(view.getColCount()){
+            for(size_t i = 0;i < m_rows;++i){
+                std::copy(&view(i,0),&view(i,0) + m_cols,m_data + i * m_cols);
+            }
+        }
+        template <size_t Row,size_t Col>
+        explicit DynamicMatrix(const Matrix<Type,Row,Col> &mat)
+            :DynamicMatrix(DynamicMatrixView<const Type>(mat)){}
+        DynamicMatrix(const DynamicMatrix &mat)
+            :DynamicMatrix(mat.view()){}
+        DynamicMatrix(DynamicMatrix &&mat)noexcept
+            :m_data(mat.m_data),m_rows(mat.m_rows),m_cols(mat.m_cols){
+            mat.m_data = nullptr;
+            mat.m_rows = mat.m_cols = 0;
+        }
+        ~DynamicMatrix(){
+            detail::alignedFree(m_data);
+        }
+
+        DynamicMatrix &operator=(const DynamicMatrix &mat){
+            if(this != &mat){
+                *this = DynamicMatrix(mat);
+            }
+            return *this;
+        }
+        DynamicMatrix &operator=(DynamicMatrix &&mat)noexcept{
+            std::swap(m_data,mat.m_data);
+            std::swap(m_rows,mat.m_rows);
+            std::swap(m_cols,mat.m_cols);
+            return *this;
+        }
+
+        size_t getRowCount()const noexcept{
+            return m_rows;
+        }
+        size_t getColCount()const noexcept{
+            return m_cols;
+        }
+        size_t count()const noexcept{
+            return m_rows * m_cols;
+        }
+
+        Type &operator()(size_t x,size_t y)noexcept{
+            return m_data[x * m_cols + y];
+        }
+        const Type &operator()(size_t x,size_t y)const noexcept{
+            return m_data[x * m_cols + y];
+        }
+        Type &operator[](size_t index)noexcept{
+            return m_data[index];
+        }
+        const Type &operator[](size_t index)const noexcept{
+            return m_data[index];
+        }
+        Type *data()noexcept{
+            return m_data;
+        }
+        const Type *data()const noexcept{
+            return m_data;
+        }
+
+        DynamicMatrixView<Type> view()noexcept{
+            return DynamicMatrixView<Type>(m_data,m_rows,m_cols);
+        }
+        DynamicMatrixView<const Type> view()const noexcept{
+            return DynamicMatrixView<const Type>(m_data,m_rows,m_cols);
+        }
+        operator DynamicMatrixView<const Type>()const noexcept{
+            return view();
+        }
+        ///a copy-free window of rows x cols starting at (x,y)
+        DynamicMatrixView<Type> view(size_t x,size_t y,size_t rows,size_t cols)noexcept{
+            return view().sub(x,y,rows,cols);
+        }
+        DynamicMatrixView<const Type> view(size_t x,size_t y,size_t rows,size_t cols)const noexcept{
+            return view().sub(x,y,rows,cols);
+        }
+
+        DynamicMatrix identity()const{
+            DynamicMatrix res(m_rows,m_cols);
+            for(size_t i = 0;i < m_rows && i < m_cols;++i){
+                res(i,i) = 1;
+            }
+            return res;
+        }
+
+        friend DynamicMatrix operator+(const DynamicMatrix &lhs,const DynamicMatrix &rhs){
+            return apply(lhs,rhs,[](const Type &a,const Type &b){return a + b;});
+        }
+        friend DynamicMatrix operator-(const DynamicMatrix &lhs,const DynamicMatrix &rhs){
+            return apply(lhs,rhs,[](const Type &a,const Type &b){return a - b;});
+        }
+        friend DynamicMatrix operator*(const DynamicMatrix &lhs,const DynamicMatrix &rhs){
+            return apply(lhs,rhs,[](const Type &a,const Type &b){return a * b;});
+        }
+        friend DynamicMatrix operator/(const DynamicMatrix &lhs,const DynamicMatrix &rhs){
+            return apply(lhs,rhs,[](const Type &a,const Type &b){return a / b;});
+        }
+        friend DynamicMatrix operator+(const DynamicMatrix &lhs,const Type &value){
+            return apply(lhs,[&](const Type &a){return a + value;});
+        }
+        friend DynamicMatrix operator-(const DynamicMatrix &lhs,const Type &value){
+            return apply(lhs,[&](const Type &a){return a - value;});
+        }
+        friend DynamicMatrix operator*(const DynamicMatrix &lhs,const Type &value){
+            return apply(lhs,[&](const Type &a){return a * value;});
+        }
+        friend DynamicMatrix operator/(const DynamicMatrix &lhs,const Type &value){
+            return apply(lhs,[&](const Type &a){return a / value;});
+        }
+        friend DynamicMatrix operator-(const DynamicMatrix &mat){
+            return apply(mat,[](const Type &a){return -a;});
+        }
+        DynamicMatrix &operator+=(const DynamicMatrix &mat){
+            return *this = *this + mat;
+        }
+        DynamicMatrix &operator-=(const DynamicMatrix &mat){
+            return *this = *this - mat;
+        }
+        DynamicMatrix &operator*=(const Type &value){
+            return *this = *this * value;
+        }
+        DynamicMatrix &operator/=(const Type &value){
+            return *this = *this / value;
+        }
+
+        bool operator==(const DynamicMatrix &mat)const noexcept{
+            if(m_rows != mat.m_rows || m_cols != mat.m_cols){
+                return false;
+            }
+            for(size_t i = 0;i < count();++i){
+                if(detail::abs(m_data[i] - mat.m_data[i]) > XMATH_EPS){
+                    return false;
+                }
+            }
+            return true;
+        }
+        bool operator!=(const DynamicMatrix &mat)const noexcept{
+            return !(*this == mat);
+        }
+
+        DynamicMatrix transpose()const{
+            DynamicMatrix res(m_cols,m_rows,no_init);
+            constexpr size_t Block = 32;
+            for(size_t ib = 0;ib < m_rows;ib += Block){
+                for(size_t jb = 0;jb < m_cols;jb += Block){
+                    for(size_t i = ib;i < std::min(ib + Block,m_rows);++i){
+                        for(size_t j = jb;j < std::min(jb + Block,m_cols);++j){
+                            res(j,i) = (*this)(i,j);
+                        }
+                    }
+                }
+            }
+            return res;
+        }
+        DynamicMatrix operator~()const{
+            return transpose();
+        }
+
+        DynamicMatrix sub(size_t x,size_t y,size_t rows,size_t cols)const{
+            return DynamicMatrix(view(x,y,rows,cols));
+        }
+        DynamicMatrix row(size_t r)const{
+            return sub(r,0,1,m_cols);
+        }
+        DynamicMatrix col(size_t c)const{
+            return sub(0,c,m_rows,1);
+        }
+
+        template <Direction dir = Direction::right>
+        DynamicMatrix extend(DynamicMatrixView<const Type> mat)const{
+            const bool horizontal = dir == Direction::right || dir == Direction::left;
+            if(horizontal ? mat.getRowCount() != m_rows : mat.getColCount() != m_cols){
+                return DynamicMatrix();
+            }
+            DynamicMatrix res(horizontal ? m_rows : m_rows + mat.getRowCount(),
+                              horizontal ? m_cols + mat.getColCount() : m_cols,no_init);
+            const bool self_first = dir == Direction::right || dir == Direction::down;
+            copyInto(res,view(),self_first ? 0 : (horizontal ? 0 : mat.getRowCount()),
+                                self_first ? 0 : (horizontal ? mat.getColCount() : 0));
+            copyInto(res,mat,self_first ? (horizontal ? 0 : m_rows) : 0,
+                             self_first ? (horizontal ? m_cols : 0) : 0);
+            return res;
+        }
+
+        iterator begin()noexcept{
+            return m_data;
+        }
+        iterator end()noexcept{
+            return m_data + count();
+        }
+        const_iterator begin()const noexcept{
+            return m_data;
+        }
+        const_iterator end()const noexcept{
+            return m_data + count();
+        }
+        const_iterator cbegin()const noexcept{
+            return m_data;
+        }
+        const_iterator cend()const noexcept{
+            return m_data + count();
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const DynamicMatrix &mat){
+            for(size_t i = 0;i < mat.m_rows;++i){
+                os << '[';
+                for(size_t j = 0;j < mat.m_cols;++j){
+                    os << mat(i,j) << (j + 1 == mat.m_cols ? "]\n" : ",");
+                }
+            }
+            return os;
+        }
+    private:
+        static Type *allocate(size_t count){
+            return count == 0 ? nullptr
+                              : static_cast<Type *>(detail::alignedAlloc(count * sizeof(Type),XMATH_DYNAMIC_ALIGN));
+        }
+        static void copyInto(DynamicMatrix &dst,DynamicMatrixView<const Type> src,size_t x,size_t y)noexcept{
+            for(size_t i = 0;i < src.getRowCount();++i){
+                std::copy(&src(i,0),&src(i,0) + src.getColCount(),&dst(x + i,y));
+            }
+        }
+        template <class Func>
+        static DynamicMatrix apply(const DynamicMatrix &lhs,const DynamicMatrix &rhs,Func func){
+            if(lhs.m_rows != rhs.m_rows || lhs.m_cols != rhs.m_cols){
+                return DynamicMatrix();
+            }
+            DynamicMatrix res(lhs.m_rows,lhs.m_cols,no_init);
+            for(size_t i = 0;i < res.count();++i){
+                res.m_data[i] = func(lhs.m_data[i],rhs.m_data[i]);
+            }
+            return res;
+        }
+        template <class Func>
+        static DynamicMatrix apply(const DynamicMatrix &mat,Func func){
+            DynamicMatrix res(mat.m_rows,mat.m_cols,no_init);
+            for(size_t i = 0;i < res.count();++i){
+                res.m_data[i] = func(mat.m_data[i]);
+            }
+            return res;
+        }
+
+        Type *m_data;
+        size_t m_rows;
+        size_t m_cols;
+    };
+
+    /**@name DynamicVector
+     * @note a column vector with a runtime size,stored as a size x 1 DynamicMatrix
+     */
+    template <class Type>
+    class DynamicVector{
+    public:
+        using value_type = Type;
+        using iterator = Type *;
+        using const_iterator = const Type *;
+
+        DynamicVector() = default;
+        explicit DynamicVector(size_t size)
+            :m_data(size,1){}
+        DynamicVector(size_t size,Type value)
+            :m_data(size,1,value){}
+        DynamicVector(std::initializer_list<Type> list)
+            :m_data(list.size(),1,list){}
+        template <size_t Count>
+        explicit DynamicVector(const Vector<Type,Count> &vec)
+            :m_data(DynamicMatrixView<const Type>(vec.data(),Count,1)){}
+        ///takes over a n x 1 matrix
+        explicit DynamicVector(DynamicMatrix<Type> &&mat)noexcept
+            :m_data(std::move(mat)){}
+
+        size_t count()const noexcept{
+            return m_data.count();
+        }
+        size_t size()const noexcept{
+            return m_data.count();
+        }
+
+        Type &operator[](size_t index)noexcept{
+            return m_data[index];
+        }
+        const Type &operator[](size_t index)const noexcept{
+            return m_data[index];
+        }
+        Type *data()noexcept{
+            return m_data.data();
+        }
+        const Type *data()const noexcept{
+            return m_data.data();
+        }
+
+        ///the vector as a size x 1 matrix
+        DynamicMatrixView<Type> view()noexcept{
+            return m_data.view();
+        }
+        DynamicMatrixView<const Type> view()const noexcept{
+            return m_data.view();
+        }
+        const DynamicMatrix<Type> &toCol()const noexcept{
+            return m_data;
+        }
+        DynamicMatrix<Type> toRow()const{
+            return m_data.transpose();
+        }
+
+        friend DynamicVector operator+(const DynamicVector &lhs,const DynamicVector &rhs){
+            return DynamicVector(lhs.m_data + rhs.m_data);
+        }
+        friend DynamicVector operator-(const DynamicVector &lhs,const DynamicVector &rhs){
+            return DynamicVector(lhs.m_data - rhs.m_data);
+        }
+        friend DynamicVector operator*(const DynamicVector &lhs,const DynamicVector &rhs){
+            return DynamicVector(lhs.m_data * rhs.m_data);
+        }
+        friend DynamicVector operator/(const DynamicVector &lhs,const DynamicVector &rhs){
+            return DynamicVector(lhs.m_data / rhs.m_data);
+        }
+        friend DynamicVector operator+(const DynamicVector &lhs,const Type &value){
+            return DynamicVector(lhs.m_data + value);
+        }
+        friend DynamicVector operator-(const DynamicVector &lhs,const Type &value){
+            return DynamicVector(lhs.m_data - value);
+        }
+        friend DynamicVector operator*(const DynamicVector &lhs,const Type &value){
+            return DynamicVector(lhs.m_data * value);
+        }
+        friend DynamicVector operator/(const DynamicVector &lhs,const Type &value){
+            return DynamicVector(lhs.m_data / value);
+        }
+        friend DynamicVector operator-(const DynamicVector &vec){
+            return DynamicVector(-vec.m_data);
+        }
+
+        bool operator==(const DynamicVector &vec)const noexcept{
+            return m_data == vec.m_data;
+        }
+        bool operator!=(const DynamicVector &vec)const noexcept{
+            return m_data != vec.m_data;
+        }
+
+        Type dot(const DynamicVector &vec)const noexcept{
+            Type ans = 0;
+            for(size_t i = 0;i < size() && i < vec.size();++i){
+                ans += m_data[i] * vec.m_data[i];
+            }
+            return ans;
+        }
+        Type length2()const noexcept{
+            return dot(*this);
+        }
+        Type length()const noexcept{
+            return std::sqrt(length2());
+        }
+        DynamicVector normalize()const{
+            return *this / length();
+        }
+
+        iterator begin()noexcept{
+            return m_data.begin();
+        }
+        iterator end()noexcept{
+            return m_data.end();
+        }
+        const_iterator begin()const noexcept{
+            return m_data.begin();
+        }
+        const_iterator end()const noexcept{
+            return m_data.end();
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const DynamicVector &vec){
+            os << '[';
+            for(size_t i = 0;i < vec.size();++i){
+                os << vec[i] << (i + 1 == vec.size() ? "" : ",");
+            }
+            os << ']';
+            return os;
+        }
+    private:
+        DynamicMatrix<Type> m_data;
+    };
+
+    namespace detail{
+        /**@name dense_traits
+         * @note the operands accepted by the DynamicMatrix product:
+         *       fixed and dynamic matrices/vectors and views,all seen as a DynamicMatrixView
+         */
+        template <class T>
+        struct dense_traits{
+            static constexpr bool is_dense = false;
+            static constexpr bool is_dynamic = false;
+            static constexpr bool is_vector = false;
+            using value_type = void;
+        };
+        template <class Type,size_t Row,size_t Col>
+        struct dense_traits<Matrix<Type,Row,Col>>{
+            static constexpr bool is_dense = true;
+            static constexpr bool is_dynamic = false;
+            static constexpr bool is_vector = false;
+            using value_type = Type;
+            static DynamicMatrixView<const Type> view(const Matrix<Type,Row,Col> &mat)noexcept{
+                return DynamicMatrixView<const Type>(mat);
+            }
+        };
+        template <class Type,size_t Count>
+        struct dense_traits<Vector<Type,Count>>{
+            static constexpr bool is_dense = true;
+            static constexpr bool is_dynamic = false;
+            static constexpr bool is_vector = true;
+            using value_type = Type;
+            static DynamicMatrixView<const Type> view(const Vector<Type,Count> &vec)noexcept{
+                return DynamicMatrixView<const Type>(vec.data(),Count,1);
+            }
+        };
+        template <class Type>
+        struct dense_traits<DynamicMatrix<Type>>{
+            static constexpr bool is_dense = true;
+            static constexpr bool is_dynamic = true;
+            static constexpr bool is_vector = false;
+            using value_type = Type;
+            static DynamicMatrixView<const Type> view(const DynamicMatrix<Type> &mat)noexcept{
+                return mat.view();
+            }
+        };
+        template <class Type>
+        struct dense_traits<DynamicVector<Type>>{
+            static constexpr bool is_dense = true;
+            static constexpr bool is_dynamic = true;
+            static constexpr bool is_vector = true;
+            using value_type = Type;
+            static DynamicMatrixView<const Type> view(const DynamicVector<Type> &vec)noexcept{
+                return vec.view();
+            }
+        };
+        template <class Type>
+        struct dense_traits<DynamicMatrixView<Type>>{
+            static constexpr bool is_dense = true;
+            static constexpr bool is_dynamic = true;
+            static constexpr bool is_vector = false;
+            using value_type = std::remove_const_t<Type>;
+            static DynamicMatrixView<const value_type> view(const DynamicMatrixView<Type> &mat)noexcept{
+                return mat;
+            }
+        };
+
+        template <class Lhs,class Rhs>
+        constexpr bool is_dynamic_product_v =
+                dense_traits<Lhs>::is_dense && dense_traits<Rhs>::is_dense &&
+                (dense_traits<Lhs>::is_dynamic || dense_traits<Rhs>::is_dynamic) &&
+                std::is_same<typename dense_traits<Lhs>::value_type,typename dense_traits<Rhs>::value_type>::value;
+
+        template <class Type>
+        DynamicMatrix<Type> dynamicProduct(DynamicMatrixView<const Type> lhs,DynamicMatrixView<const Type> rhs){
+            if(lhs.getColCount() != rhs.getRowCount()){
+                return DynamicMatrix<Type>();
+            }
+            DynamicMatrix<Type> res(lhs.getRowCount(),rhs.getColCount());
+            gemm<Type>(lhs.getRowCount(),rhs.getColCount(),lhs.getColCount(),
+                       lhs.data(),lhs.getStride(),
+                       rhs.data(),rhs.getStride(),
+                       res.data(),res.getColCount());
+            return res;
+        }
+    }
+
+    /**@name operator%
+     * @note matrix product of any two of Matrix,Vector,DynamicMatrix,DynamicVector,DynamicMatrixView
+     *       where at least one side is dynamic
+     * @return a DynamicVector if rhs is a vector,a DynamicMatrix otherwise
+     */
+    template <class Lhs,class Rhs,class = std::enable_if_t<detail::is_dynamic_product_v<Lhs,Rhs>>>
+    auto operator%(const Lhs &lhs,const Rhs &rhs)
+    -> std::conditional_t<detail::dense_traits<Rhs>::is_vector,
+                          DynamicVector<typename detail::dense_traits<Lhs>::value_type>,
+                          DynamicMatrix<typename detail::dense_traits<Lhs>::value_type>>{
+        using Type = typename detail::dense_traits<Lhs>::value_type;
+        using Result = std::conditional_t<detail::dense_traits<Rhs>::is_vector,DynamicVector<Type>,DynamicMatrix<Type>>;
+        return Result(detail::dynamicProduct<Type>(detail::dense_traits<Lhs>::view(lhs),
+                                                   detail::dense_traits<Rhs>::view(rhs)));
+    }
+
+    using DynamicMatrixf = DynamicMatrix<float>;
+    using DynamicMatrixd = DynamicMatrix<double>;
+    using DynamicMatrixi = DynamicMatrix<int>;
+    using DynamicMatrixui = DynamicMatrix<unsigned int>;
+
+    using DynamicVectorf = DynamicVector<float>;
+    using DynamicVectord = DynamicVector<double>;
+    using DynamicVectori = DynamicVector<int>;
+    using DynamicVectorui = DynamicVector<unsigned int>;
+}
+
+#endif //_XMATH_DYNAMICMATRIX_H_
@@ -0,0 +1,429 @@
+#ifndef _XMATH_EXPRESSION_H_
+#define _XMATH_EXPRESSION_H_
+
+#include <cstddef>
+#include <numeric>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include "SIMD.h"
+
+namespace xmath{
+    /**@name expression_traits
+     * @note every type usable as an operand of the element-wise operators
+     *       (+,-,*,/) specialises this: Matrix, Vector and the expression nodes below
+     * @note result_type is the concrete Matrix/Vector an expression evaluates to
+     * @note lvalue leaves (Matrix,Vector) are held by reference inside an expression,
+     *       temporaries and nodes are held by value, see expression_operand_t
+     */
+    template <class T>
+    struct expression_traits{
+        static constexpr bool is_expression = false;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = false;
+        using value_type = void;
+        using result_type = void;
+    };
+
+    ///an operand held by reference has the traits of what it refers to
+    template <class T>
+    struct expression_traits<const T &> : expression_traits<T>{};
+
+    template <class T>
+    constexpr bool is_expression_v = expression_traits<std::remove_cvref_t<T>>::is_expression;
+
+    /// true if Expr is a lazy expression node (not a leaf) evaluating to Result
+    template <class Expr,class Result>
+    constexpr bool is_expression_of_v =
+            expression_traits<std::remove_cvref_t<Expr>>::is_expression &&
+            !expression_traits<std::remove_cvref_t<Expr>>::is_leaf &&
+            std::is_same<typename expression_traits<std::remove_cvref_t<Expr>>::result_type,Result>::value;
+
+    /// true if Lhs and Rhs can be combined element-wise
+    template <class Lhs,class Rhs>
+    constexpr bool is_compatible_expression_v =
+            is_expression_v<Lhs> && is_expression_v<Rhs> &&
+            !expression_traits<std::remove_cvref_t<Lhs>>::is_scalar &&
+            !expression_traits<std::remove_cvref_t<Rhs>>::is_scalar &&
+            std::is_same<typename expression_traits<std::remove_cvref_t<Lhs>>::result_type,
+                         typename expression_traits<std::remove_cvref_t<Rhs>>::result_type>::value;
+
+    /// value_type of an operand as deduced by a forwarding reference
+    template <class T>
+    using expression_value_t = typename expression_traits<std::remove_cvref_t<T>>::value_type;
+
+    /**@name expression_operand_t
+     * @note how a node holds an operand deduced as T by a forwarding reference:
+     *       lvalue leaves by const reference, rvalue leaves (e.g. the result of normalize()) by value
+     *       so 'auto e = a + b.normalize();' stays valid, nodes always by value
+     */
+    template <class T>
+    using expression_operand_t = std::conditional_t<
+            std::is_lvalue_reference_v<T> && expression_traits<std::remove_cvref_t<T>>::is_leaf,
+            const std::remove_cvref_t<T> &,std::remove_cvref_t<T>>;
+
+    template <class Op,class Lhs,class Rhs>
+    class BinaryExpression;
+    template <class Op,class Operand>
+    class UnaryExpression;
+
+    namespace detail{
+        struct Add{
+            template <class T>
+            static constexpr T apply(const T &lhs,const T &rhs)noexcept{
+                return lhs + rhs;
+            }
+        };
+        struct Sub{
+            template <class T>
+            static constexpr T apply(const T &lhs,const T &rhs)noexcept{
+                return lhs - rhs;
+            }
+        };
+        struct Mul{
+            template <class T>
+            static constexpr T apply(const T &lhs,const T &rhs)noexcept{
+                return lhs * rhs;
+            }
+        };
+        struct Div{
+            template <class T>
+            static constexpr T apply(const T &lhs,const T &rhs)noexcept{
+                return lhs / rhs;
+            }
+        };
+        struct Negate{
+            template <class T>
+            static constexpr T apply(const T &value)noexcept{
+                return -value;
+            }
+        };
+
+        /**@name packet_lanes
+         * @note how many of the Count lanes of Expr can be loaded as one Packet,
+         *       leaves are contiguous, strided views (Matrix.h) limit it to what stays in one of their rows
+         */
+        template <class Expr,size_t Count>
+        struct packet_lanes : std::integral_constant<size_t,Count>{};
+        template <class Expr,size_t Count>
+        struct packet_lanes<const Expr &,Count> : packet_lanes<Expr,Count>{};
+        template <class Op,class Lhs,class Rhs,size_t Count>
+        struct packet_lanes<BinaryExpression<Op,Lhs,Rhs>,Count>
+            : std::integral_constant<size_t,std::gcd(packet_lanes<Lhs,Count>::value,packet_lanes<Rhs,Count>::value)>{};
+        template <class Op,class Operand,size_t Count>
+        struct packet_lanes<UnaryExpression<Op,Operand>,Count> : packet_lanes<Operand,Count>{};
+
+        /**@name aliases
+         * @note true if evaluating expr may read [first,last) out of element order,
+         *       only strided views (Matrix.h) answer true, leaves read element i for element i
+         */
+        template <class Expr,class = void>
+        struct has_aliases : std::false_type{};
+        template <class Expr>
+        struct has_aliases<Expr,std::void_t<decltype(std::declval<const Expr &>().aliases(nullptr,nullptr))>>
+            : std::true_type{};
+
+        template <class Expr>
+        constexpr bool aliases(const Expr &expr,const void *first,const void *last)noexcept{
+            if constexpr (has_aliases<Expr>::value){
+                return expr.aliases(first,last);
+            }else{
+                return false;
+            }
+        }
+
+        /**@name evaluate
+         * @note the single fused loop every expression ends up in,
+         *       run a whole Packet at a time when Count allows it
+         *       (element by element while constant-evaluated)
+         * @note straight-line code up to XMATH_UNROLL_LIMIT packets, see unroll()
+         */
+        template <size_t Count,class Type,class Expr>
+        constexpr void evaluate(Type *dst,const Expr &expr)noexcept{
+            if(std::is_constant_evaluated()){
+                unroll<Count>([&](auto i){
+                    dst[i] = expr[i];
+                });
+                return;
+            }
+            //runs of Lanes (a row of a strided view) as their own loop so the index math folds away
+            constexpr size_t Lanes = packet_lanes<Expr,Count>::value;
+            using P = packet_for_t<Type,Lanes>;
+            unroll<Count / Lanes,Count / P::size>([&](auto i){
+                unroll<Lanes / P::size>([&](auto j){
+                    const size_t index = i * Lanes + j * P::size;
+                    expr.template packet<P>(index).store(dst + index);
+                });
+            });
+        }
+    }
+
+    template <class Type>
+    class ScalarExpression{
+    public:
+        using value_type = Type;
+
+        constexpr explicit ScalarExpression(const Type &value)noexcept
+            :m_value(value){}
+
+        constexpr const Type &operator[](size_t)const noexcept{
+            return m_value;
+        }
+
+        template <class Packet>
+        Packet packet(size_t)const noexcept{
+            return Packet::broadcast(m_value);
+        }
+    private:
+        Type m_value;
+    };
+
+    template <class Type>
+    struct expression_traits<ScalarExpression<Type>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = true;
+        using value_type = Type;
+        using result_type = void;
+    };
+
+    /**@name ExpressionNode
+     * @note the base of the lazy nodes (BinaryExpression, UnaryExpression, ExtendExpression),
+     *       forwards the everyday Matrix/Vector members and % to eval(),
+     *       so '(a - b).normalize()' or '(a + b) % m' work as they did when the operators returned a Matrix/Vector
+     * @note each of them evaluates the whole node first, assign to a Matrix/Vector to reuse the result
+     */
+    namespace detail{
+        ///common to every ExpressionNode<Derived>
+        struct ExpressionNodeTag{};
+    }
+
+    template <class Derived>
+    class ExpressionNode : public detail::ExpressionNodeTag{
+    public:
+        //Vector
+        template <class... Args>
+        constexpr auto dot(const Args &...args)const noexcept{
+            return self().eval().dot(args...);
+        }
+        template <class Vec>
+        constexpr auto cross(const Vec &vec)const noexcept{
+            return self().eval().cross(vec);
+        }
+        constexpr auto length()const noexcept{
+            return self().eval().length();
+        }
+        constexpr auto length2()const noexcept{
+            return self().eval().length2();
+        }
+        constexpr auto normalize()const noexcept{
+            return self().eval().normalize();
+        }
+        constexpr auto toRow()const noexcept{
+            return self().eval().toRow();
+        }
+        constexpr auto toCol()const noexcept{
+            return self().eval().toCol();
+        }
+
+        //Matrix
+        constexpr auto det()const noexcept{
+            return self().eval().det();
+        }
+        template <class... Args>
+        constexpr auto inverse(Args &...args)const noexcept{
+            return self().eval().inverse(args...);
+        }
+        constexpr auto adjoint()const noexcept{
+            return self().eval().adjoint();
+        }
+        constexpr auto cofactor(size_t x,size_t y)const noexcept{
+            return self().eval().cofactor(x,y);
+        }
+        constexpr auto transpose()const noexcept{
+            return self().eval().transpose();
+        }
+        constexpr auto operator~()const noexcept{
+            return self().eval().transpose();
+        }
+        template <size_t Row2,size_t Col2>
+        constexpr auto sub(size_t x,size_t y)const noexcept{
+            return self().eval().template sub<Row2,Col2>(x,y);
+        }
+        constexpr auto row(size_t r)const noexcept{
+            return self().eval().row(r);
+        }
+        constexpr auto col(size_t c)const noexcept{
+            return self().eval().col(c);
+        }
+
+        ///the product of the evaluated node, whichever side it is on (Node defers the check until Derived is complete)
+        template <class Rhs,class Node = Derived>
+        friend constexpr auto operator%(const Derived &lhs,const Rhs &rhs)noexcept
+        -> decltype(std::declval<const Node &>().eval() % rhs){
+            return lhs.eval() % rhs;
+        }
+        template <class Lhs,class Node = Derived,class = std::enable_if_t<!std::is_base_of<detail::ExpressionNodeTag,Lhs>::value>>
+        friend constexpr auto operator%(const Lhs &lhs,const Derived &rhs)noexcept
+        -> decltype(lhs % std::declval<const Node &>().eval()){
+            return lhs % rhs.eval();
+        }
+    private:
+        constexpr const Derived &self()const noexcept{
+            return static_cast<const Derived &>(*this);
+        }
+    };
+
+    /**@name BinaryExpression
+     * @note a lazy element-wise Op applied to Lhs and Rhs
+     * @note nothing is computed until it is assigned to (or constructs) a Matrix/Vector,
+     *       Lhs and Rhs are expression_operand_t: a const reference to an lvalue leaf or a value,
+     *       so one must not outlive the named Matrix/Vector it refers to
+     */
+    template <class Op,class Lhs,class Rhs>
+    class BinaryExpression : public ExpressionNode<BinaryExpression<Op,Lhs,Rhs>>{
+    public:
+        using value_type = std::conditional_t<expression_traits<Lhs>::is_scalar,
+                typename expression_traits<Rhs>::value_type,
+                typename expression_traits<Lhs>::value_type>;
+        using result_type = std::conditional_t<expression_traits<Lhs>::is_scalar,
+                typename expression_traits<Rhs>::result_type,
+                typename expression_traits<Lhs>::result_type>;
+
+        constexpr BinaryExpression(Lhs lhs,Rhs rhs)noexcept
+            :m_lhs(std::forward<Lhs>(lhs)),m_rhs(std::forward<Rhs>(rhs)){}
+
+        constexpr value_type operator[](size_t index)const noexcept{
+            return Op::apply(static_cast<value_type>(m_lhs[index]),static_cast<value_type>(m_rhs[index]));
+        }
+
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            return Op::apply(m_lhs.template packet<Packet>(index),m_rhs.template packet<Packet>(index));
+        }
+
+        constexpr bool aliases(const void *first,const void *last)const noexcept{
+            return detail::aliases(m_lhs,first,last) || detail::aliases(m_rhs,first,last);
+        }
+
+        constexpr result_type eval()const noexcept{
+            return result_type(*this);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const BinaryExpression &expr){
+            return os << expr.eval();
+        }
+    private:
+        Lhs m_lhs;
+        Rhs m_rhs;
+    };
+
+    template <class Op,class Lhs,class Rhs>
+    struct expression_traits<BinaryExpression<Op,Lhs,Rhs>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = false;
+        using value_type = typename BinaryExpression<Op,Lhs,Rhs>::value_type;
+        using result_type = typename BinaryExpression<Op,Lhs,Rhs>::result_type;
+    };
+
+    template <class Op,class Operand>
+    class UnaryExpression : public ExpressionNode<UnaryExpression<Op,Operand>>{
+    public:
+        using value_type = typename expression_traits<Operand>::value_type;
+        using result_type = typename expression_traits<Operand>::result_type;
+
+        constexpr explicit UnaryExpression(Operand operand)noexcept
+            :m_operand(std::forward<Operand>(operand)){}
+
+        constexpr value_type operator[](size_t index)const noexcept{
+            return Op::apply(static_cast<value_type>(m_operand[index]));
+        }
+
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            return Op::apply(m_operand.template packet<Packet>(index));
+        }
+
+        constexpr bool aliases(const void *first,const void *last)const noexcept{
+            return detail::aliases(m_operand,first,last);
+        }
+
+        constexpr result_type eval()const noexcept{
+            return result_type(*this);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const UnaryExpression &expr){
+            return os << expr.eval();
+        }
+    private:
+        Operand m_operand;
+    };
+
+    template <class Op,class Operand>
+    struct expression_traits<UnaryExpression<Op,Operand>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = false;
+        using value_type = typename UnaryExpression<Op,Operand>::value_type;
+        using result_type = typename UnaryExpression<Op,Operand>::result_type;
+    };
+
+    //expression op expression, see expression_operand_t for how the operands are held
+    template <class Lhs,class Rhs,class = std::enable_if_t<is_compatible_expression_v<Lhs,Rhs>>>
+    constexpr auto operator+(Lhs &&lhs,Rhs &&rhs)noexcept{
+        return BinaryExpression<detail::Add,expression_operand_t<Lhs>,expression_operand_t<Rhs>>(
+                std::forward<Lhs>(lhs),std::forward<Rhs>(rhs));
+    }
+    template <class Lhs,class Rhs,class = std::enable_if_t<is_compatible_expression_v<Lhs,Rhs>>>
+    constexpr auto operator-(Lhs &&lhs,Rhs &&rhs)noexcept{
+        return BinaryExpression<detail::Sub,expression_operand_t<Lhs>,expression_operand_t<Rhs>>(
+                std::forward<Lhs>(lhs),std::forward<Rhs>(rhs));
+    }
+    template <class Lhs,class Rhs,class = std::enable_if_t<is_compatible_expression_v<Lhs,Rhs>>>
+    constexpr auto operator*(Lhs &&lhs,Rhs &&rhs)noexcept{
+        return BinaryExpression<detail::Mul,expression_operand_t<Lhs>,expression_operand_t<Rhs>>(
+                std::forward<Lhs>(lhs),std::forward<Rhs>(rhs));
+    }
+    template <class Lhs,class Rhs,class = std::enable_if_t<is_compatible_expression_v<Lhs,Rhs>>>
+    constexpr auto operator/(Lhs &&lhs,Rhs &&rhs)noexcept{
+        return BinaryExpression<detail::Div,expression_operand_t<Lhs>,expression_operand_t<Rhs>>(
+                std::forward<Lhs>(lhs),std::forward<Rhs>(rhs));
+    }
+
+    //expression op scalar
+    template <class Lhs,class = std::enable_if_t<is_expression_v<Lhs>>>
+    constexpr auto operator+(Lhs &&lhs,const expression_value_t<Lhs> &value)noexcept{
+        using Scalar = ScalarExpression<expression_value_t<Lhs>>;
+        return BinaryExpression<detail::Add,expression_operand_t<Lhs>,Scalar>(std::forward<Lhs>(lhs),Scalar(value));
+    }
+    template <class Lhs,class = std::enable_if_t<is_expression_v<Lhs>>>
+    constexpr auto operator-(Lhs &&lhs,const expression_value_t<Lhs> &value)noexcept{
+        using Scalar = ScalarExpression<expression_value_t<Lhs>>;
+        return BinaryExpression<detail::Sub,expression_operand_t<Lhs>,Scalar>(std::forward<Lhs>(lhs),Scalar(value));
+    }
+    template <class Lhs,class = std::enable_if_t<is_expression_v<Lhs>>>
+    constexpr auto operator*(Lhs &&lhs,const expression_value_t<Lhs> &value)noexcept{
+        using Scalar = ScalarExpression<expression_value_t<Lhs>>;
+        return BinaryExpression<detail::Mul,expression_operand_t<Lhs>,Scalar>(std::forward<Lhs>(lhs),Scalar(value));
+    }
+    template <class Lhs,class = std::enable_if_t<is_expression_v<Lhs>>>
+    constexpr auto operator/(Lhs &&lhs,const expression_value_t<Lhs> &value)noexcept{
+        using Scalar = ScalarExpression<expression_value_t<Lhs>>;
+        return BinaryExpression<detail::Div,expression_operand_t<Lhs>,Scalar>(std::forward<Lhs>(lhs),Scalar(value));
+    }
+
+    //scalar * expression
+    template <class Rhs,class = std::enable_if_t<is_expression_v<Rhs>>>
+    constexpr auto operator*(const expression_value_t<Rhs> &value,Rhs &&rhs)noexcept{
+        using Scalar = ScalarExpression<expression_value_t<Rhs>>;
+        return BinaryExpression<detail::Mul,Scalar,expression_operand_t<Rhs>>(Scalar(value),std::forward<Rhs>(rhs));
+    }
+
+    template <class Operand,class = std::enable_if_t<is_expression_v<Operand>>>
+    constexpr auto operator-(Operand &&operand)noexcept{
+        return UnaryExpression<detail::Negate,expression_operand_t<Operand>>(std::forward<Operand>(operand));
+    }
+}
+
+#endif //_XMATH_EXPRESSION_H_
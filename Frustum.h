@@ -0,0 +1,190 @@
+#ifndef _XMATH_FRUSTUM_H_
+#define _XMATH_FRUSTUM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include "Matrix.h"
+#include "Vector.h"
+#include "VectorBatch.h"
+
+namespace xmath{
+    /**@name ClipDepth
+     * @note the clip space depth range of a projection: negative_one for [-w,w] (OpenGL and
+     *       Vector::frustum()/ortho()), zero for [0,w] (Direct3D,Vulkan,Metal)
+     */
+    enum class ClipDepth{
+        negative_one,
+        zero
+    };
+
+    /**@name Frustum
+     * @note the six planes bounding the volume a view-projection matrix maps into clip space,
+     *       extracted from its rows (Gribb & Hartmann), every plane (a,b,c,d) normalized and facing inwards:
+     *       a point p is inside it when a * p.x + b * p.y + c * p.z + d >= 0
+     * @note the matrix is used as mat % [x,y,z,1] like every product in XMath,
+     *       planes come out in the space the matrix maps from (world space for proj % view)
+     * @note cullSpheres()/cullBoxes() test structure-of-arrays inputs a Packet of objects at a time
+     *       and write the indices of the objects not entirely outside any plane, in order
+     */
+    template <class Type>
+    class Frustum{
+    public:
+        enum Plane : size_t{
+            left,
+            right,
+            bottom,
+            top,
+            near_clip,
+            far_clip
+        };
+
+        constexpr Frustum() = default;
+        constexpr explicit Frustum(const Matrix<Type,4,4> &mat,ClipDepth depth = ClipDepth::negative_one)noexcept{
+            for(size_t i = 0;i < 4;++i){
+                const Type x = mat(0,i),y = mat(1,i),z = mat(2,i),w = mat(3,i);
+                m_planes[left][i] = w + x;
+                m_planes[right][i] = w - x;
+                m_planes[bottom][i] = w + y;
+                m_planes[top][i] = w - y;
+                m_planes[near_clip][i] = depth == ClipDepth::zero ? z : w + z;
+                m_planes[far_clip][i] = w - z;
+            }
+            for(auto &plane : m_planes){
+                const Type inv_length = Type(1) / detail::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+                plane = Vector<Type,4>(plane * inv_length);
+            }
+        }
+
+        constexpr const Vector<Type,4> &plane(size_t index)const noexcept{
+            return m_planes[index];
+        }
+        constexpr const Vector<Type,4> &operator[](size_t index)const noexcept{
+            return m_planes[index];
+        }
+
+        constexpr bool contains(const Vector<Type,3> &point)const noexcept{
+            return intersectsSphere(point,Type(0));
+        }
+        ///false only if the sphere is entirely outside one of the planes
+        constexpr bool intersectsSphere(const Vector<Type,3> &center,Type radius)const noexcept{
+            for(const auto &plane : m_planes){
+                if(distance(plane,center) + radius < 0){
+                    return false;
+                }
+            }
+            return true;
+        }
+        /**@name intersectsBox
+         * @note the axis-aligned box center +- extent, false only if it is entirely outside one of the planes
+         * @note conservative like every plane test: a box near a frustum corner may pass although outside
+         */
+        constexpr bool intersectsBox(const Vector<Type,3> &center,const Vector<Type,3> &extent)const noexcept{
+            for(const auto &plane : m_planes){
+                const Type reach = detail::abs(plane[0]) * extent[0] + detail::abs(plane[1]) * extent[1] + detail::abs(plane[2]) * extent[2];
+                if(distance(plane,center) + reach < 0){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**@name cullSpheres
+         * @note sphere i is (x[i],y[i],z[i]) with radius[i], the indices of the intersecting ones
+         *       are written to visible (room for n indices), returns how many
+         */
+        size_t cullSpheres(const Type *x,const Type *y,const Type *z,const Type *radius,size_t n,uint32_t *visible)const noexcept{
+            size_t count = 0;
+            detail::packetFor<Type>(n,[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                const P px = P::load(x + i),py = P::load(y + i),pz = P::load(z + i);
+                const P pr = P::load(radius + i);
+                //the smallest signed distance of the sphere's far side over all planes
+                P worst = distance<P>(m_planes[0],px,py,pz) + pr;
+                for(size_t k = 1;k < 6;++k){
+                    worst = min(worst,distance<P>(m_planes[k],px,py,pz) + pr);
+                }
+                count = compact<P>(cmpge(worst,P::broadcast(Type(0))),i,visible,count);
+            });
+            return count;
+        }
+        size_t cullSpheres(const VectorBatch<Type,3> &centers,const Type *radius,uint32_t *visible)const noexcept{
+            return cullSpheres(centers.component(0),centers.component(1),centers.component(2),radius,centers.size(),visible);
+        }
+
+        /**@name cullBoxes
+         * @note box i is center (cx[i],cy[i],cz[i]) +- extent (ex[i],ey[i],ez[i]), see intersectsBox(),
+         *       the indices of the intersecting ones are written to visible (room for n indices), returns how many
+         */
+        size_t cullBoxes(const Type *cx,const Type *cy,const Type *cz,
+                         const Type *ex,const Type *ey,const Type *ez,size_t n,uint32_t *visible)const noexcept{
+            Type reach[6][3];
+            for(size_t k = 0;k < 6;++k){
+                for(size_t c = 0;c < 3;++c){
+                    reach[k][c] = detail::abs(m_planes[k][c]);
+                }
+            }
+            size_t count = 0;
+            detail::packetFor<Type>(n,[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                const P px = P::load(cx + i),py = P::load(cy + i),pz = P::load(cz + i);
+                const P qx = P::load(ex + i),qy = P::load(ey + i),qz = P::load(ez + i);
+                //the signed distance of the box corner furthest along each plane normal
+                const auto far_side = [&](size_t k){
+                    return madd(P::broadcast(reach[k][0]),qx,
+                                madd(P::broadcast(reach[k][1]),qy,
+                                     madd(P::broadcast(reach[k][2]),qz,distance<P>(m_planes[k],px,py,pz))));
+                };
+                P worst = far_side(0);
+                for(size_t k = 1;k < 6;++k){
+                    worst = min(worst,far_side(k));
+                }
+                count = compact<P>(cmpge(worst,P::broadcast(Type(0))),i,visible,count);
+            });
+            return count;
+        }
+        size_t cullBoxes(const VectorBatch<Type,3> &centers,const VectorBatch<Type,3> &extents,uint32_t *visible)const noexcept{
+            return cullBoxes(centers.component(0),centers.component(1),centers.component(2),
+                             extents.component(0),extents.component(1),extents.component(2),
+                             std::min(centers.size(),extents.size()),visible);
+        }
+
+        constexpr bool operator==(const Frustum &frustum)const noexcept{
+            for(size_t i = 0;i < 6;++i){
+                if(m_planes[i] != frustum.m_planes[i]){
+                    return false;
+                }
+            }
+            return true;
+        }
+        constexpr bool operator!=(const Frustum &frustum)const noexcept{
+            return !(*this == frustum);
+        }
+    protected:
+    private:
+        static constexpr Type distance(const Vector<Type,4> &plane,const Vector<Type,3> &point)noexcept{
+            return plane[0] * point[0] + plane[1] * point[1] + plane[2] * point[2] + plane[3];
+        }
+        template <class P>
+        static P distance(const Vector<Type,4> &plane,const P &x,const P &y,const P &z)noexcept{
+            return madd(P::broadcast(plane[0]),x,
+                        madd(P::broadcast(plane[1]),y,
+                             madd(P::broadcast(plane[2]),z,P::broadcast(plane[3]))));
+        }
+        ///appends index + lane for every set lane of mask, branch free: every lane is stored, only the kept ones advance count
+        template <class P>
+        static size_t compact(unsigned mask,size_t index,uint32_t *visible,size_t count)noexcept{
+            for(size_t lane = 0;lane < P::size;++lane){
+                visible[count] = static_cast<uint32_t>(index + lane);
+                count += (mask >> lane) & 1u;
+            }
+            return count;
+        }
+
+        Vector<Type,4> m_planes[6];
+    };
+
+    using Frustumf = Frustum<float>;
+    using Frustumd = Frustum<double>;
+}
+
+#endif //_XMATH_FRUSTUM_H_
@@ -0,0 +1,395 @@
+#ifndef _XMATH_HALF_H_
+#define _XMATH_HALF_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "SIMD.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+#if defined(__F16C__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace xmath{
+    namespace detail{
+        ///IEEE binary16 bits of value, rounded to nearest even
+        constexpr uint16_t floatToHalf(float value)noexcept{
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            const uint32_t sign = (bits >> 16) & 0x8000u;
+            const uint32_t abs = bits & 0x7FFFFFFFu;
+            if(abs >= 0x7F800000u){
+                //inf stays inf, nan stays a quiet nan with the top payload bits
+                return static_cast<uint16_t>(sign | 0x7C00u | (abs > 0x7F800000u ? 0x200u | ((abs >> 13) & 0x3FFu) : 0u));
+            }
+            if(abs >= 0x477FF000u){
+                //65520 and above round past the largest half (65504)
+                return static_cast<uint16_t>(sign | 0x7C00u);
+            }
+            if(abs < 0x38800000u){
+                //below 2^-14: a subnormal half m * 2^-24, or zero under 2^-25
+                if(abs < 0x33000000u){
+                    return static_cast<uint16_t>(sign);
+                }
+                const uint32_t shift = 126 - (abs >> 23);
+                const uint32_t mantissa = (abs & 0x7FFFFFu) | 0x800000u;
+                uint32_t res = mantissa >> shift;
+                const uint32_t rest = mantissa & ((1u << shift) - 1);
+                const uint32_t halfway = 1u << (shift - 1);
+                if(rest > halfway || (rest == halfway && (res & 1u))){
+                    ++res;
+                }
+                return static_cast<uint16_t>(sign | res);
+            }
+            //rebias the exponent from 127 to 15, a carry out of the mantissa bumps the exponent
+            uint32_t res = (abs - 0x38000000u) >> 13;
+            const uint32_t rest = abs & 0x1FFFu;
+            if(rest > 0x1000u || (rest == 0x1000u && (res & 1u))){
+                ++res;
+            }
+            return static_cast<uint16_t>(sign | res);
+        }
+
+        constexpr float halfToFloat(uint16_t bits)noexcept{
+            const uint32_t sign = static_cast<uint32_t>(bits & 0x8000u) << 16;
+            const uint32_t exponent = (bits >> 10) & 0x1Fu;
+            const uint32_t mantissa = bits & 0x3FFu;
+            if(exponent == 0x1F){
+                //a nan comes out quiet, like F16C
+                return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13) | (mantissa ? 0x400000u : 0u));
+            }
+            if(exponent == 0){
+                //subnormal (or zero): mantissa * 2^-24 is exact in float
+                const float res = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+                return sign ? -res : res;
+            }
+            return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+
+        ///the upper half of value's bits, rounded to nearest even
+        constexpr uint16_t floatToBfloat16(float value)noexcept{
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            if((bits & 0x7FFFFFFFu) > 0x7F800000u){
+                return static_cast<uint16_t>((bits >> 16) | 0x40u);
+            }
+            return static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+        }
+
+        constexpr float bfloat16ToFloat(uint16_t bits)noexcept{
+            return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+        }
+    }
+
+    /**@name half
+     * @note IEEE binary16 storage: 1 sign, 5 exponent and 10 mantissa bits
+     * @note converts to float for every operation, so half + half is a float
+     *       and a Matrix<half,...> computes in float and rounds once when stored
+     */
+    class half{
+    public:
+        half() = default;
+        constexpr half(float value)noexcept
+            :m_bits(0){
+#if defined(__F16C__)
+            if(!std::is_constant_evaluated()){
+                m_bits = static_cast<uint16_t>(_cvtss_sh(value,_MM_FROUND_TO_NEAREST_INT));
+                return;
+            }
+#endif
+            m_bits = detail::floatToHalf(value);
+        }
+
+        constexpr operator float()const noexcept{
+#if defined(__F16C__)
+            if(!std::is_constant_evaluated()){
+                return _cvtsh_ss(m_bits);
+            }
+#endif
+            return detail::halfToFloat(m_bits);
+        }
+
+        ///computed in float, rounded once
+        constexpr half &operator+=(float value)noexcept{
+            return *this = half(static_cast<float>(*this) + value);
+        }
+        constexpr half &operator-=(float value)noexcept{
+            return *this = half(static_cast<float>(*this) - value);
+        }
+        constexpr half &operator*=(float value)noexcept{
+            return *this = half(static_cast<float>(*this) * value);
+        }
+        constexpr half &operator/=(float value)noexcept{
+            return *this = half(static_cast<float>(*this) / value);
+        }
+
+        static constexpr half fromBits(uint16_t bits)noexcept{
+            half res;
+            res.m_bits = bits;
+            return res;
+        }
+        constexpr uint16_t bits()const noexcept{
+            return m_bits;
+        }
+    private:
+        uint16_t m_bits;
+    };
+
+    /**@name bfloat16
+     * @note the upper 16 bits of a float: float's range with 8 mantissa bits
+     * @note converts to float for every operation like half
+     */
+    class bfloat16{
+    public:
+        bfloat16() = default;
+        constexpr bfloat16(float value)noexcept
+            :m_bits(detail::floatToBfloat16(value)){}
+
+        constexpr operator float()const noexcept{
+            return detail::bfloat16ToFloat(m_bits);
+        }
+
+        ///computed in float, rounded once
+        constexpr bfloat16 &operator+=(float value)noexcept{
+            return *this = bfloat16(static_cast<float>(*this) + value);
+        }
+        constexpr bfloat16 &operator-=(float value)noexcept{
+            return *this = bfloat16(static_cast<float>(*this) - value);
+        }
+        constexpr bfloat16 &operator*=(float value)noexcept{
+            return *this = bfloat16(static_cast<float>(*this) * value);
+        }
+        constexpr bfloat16 &operator/=(float value)noexcept{
+            return *this = bfloat16(static_cast<float>(*this) / value);
+        }
+
+        static constexpr bfloat16 fromBits(uint16_t bits)noexcept{
+            bfloat16 res;
+            res.m_bits = bits;
+            return res;
+        }
+        constexpr uint16_t bits()const noexcept{
+            return m_bits;
+        }
+    private:
+        uint16_t m_bits;
+    };
+
+    namespace detail{
+        template <>
+        struct promote_type<half>{
+            using type = float;
+        };
+        template <>
+        struct promote_type<bfloat16>{
+            using type = float;
+        };
+    }
+
+    namespace detail{
+        /**@name StoragePacket
+         * @note the Packet of a storage-only type: widened to Packet<float,Size> on load,
+         *       every operation runs on that, rounded back (to nearest even) on store
+         * @note Packet<half,4/8> need F16C, Packet<bfloat16,4> SSE4.1 and Packet<bfloat16,8> AVX2
+         */
+        template <class Storage,size_t Size>
+        struct StoragePacket{
+            using Derived = Packet<Storage,Size>;
+            static constexpr size_t size = Size;
+            Packet<float,Size> value;
+
+            static Derived load(const Storage *ptr)noexcept{
+                return Derived{{Derived::widen(ptr)}};
+            }
+            static Derived broadcast(const Storage &value)noexcept{
+                return Derived{{Packet<float,Size>::broadcast(static_cast<float>(value))}};
+            }
+            void store(Storage *ptr)const noexcept{
+                Derived::narrow(value,ptr);
+            }
+
+            friend Derived operator+(const Derived &lhs,const Derived &rhs)noexcept{
+                return Derived{{lhs.value + rhs.value}};
+            }
+            friend Derived operator-(const Derived &lhs,const Derived &rhs)noexcept{
+                return Derived{{lhs.value - rhs.value}};
+            }
+            friend Derived operator*(const Derived &lhs,const Derived &rhs)noexcept{
+                return Derived{{lhs.value * rhs.value}};
+            }
+            friend Derived operator/(const Derived &lhs,const Derived &rhs)noexcept{
+                return Derived{{lhs.value / rhs.value}};
+            }
+            friend Derived operator-(const Derived &packet)noexcept{
+                return Derived{{-packet.value}};
+            }
+            friend Derived sqrt(const Derived &packet)noexcept{
+                return Derived{{sqrt(packet.value)}};
+            }
+            friend Derived madd(const Derived &a,const Derived &b,const Derived &c)noexcept{
+                return Derived{{madd(a.value,b.value,c.value)}};
+            }
+        };
+
+#if defined(__F16C__)
+        template <>
+        struct Packet<half,4> : StoragePacket<half,4>{
+            static Packet<float,4> widen(const half *ptr)noexcept{
+                return Packet<float,4>{_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ptr)))};
+            }
+            static void narrow(const Packet<float,4> &value,half *ptr)noexcept{
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(ptr),_mm_cvtps_ph(value.value,_MM_FROUND_TO_NEAREST_INT));
+            }
+        };
+        template <>
+        struct has_packet<half,4> : std::true_type{};
+
+        template <>
+        struct Packet<half,8> : StoragePacket<half,8>{
+            static Packet<float,8> widen(const half *ptr)noexcept{
+                return Packet<float,8>{_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)))};
+            }
+            static void narrow(const Packet<float,8> &value,half *ptr)noexcept{
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr),_mm256_cvtps_ph(value.value,_MM_FROUND_TO_NEAREST_INT));
+            }
+        };
+        template <>
+        struct has_packet<half,8> : std::true_type{};
+#endif
+
+#if defined(__SSE4_1__)
+        ///the bfloat16 bits of 4 floats in the low 16 bits of each lane, rounded to nearest even
+        inline __m128i roundBfloat16(__m128 value)noexcept{
+            const __m128i bits = _mm_castps_si128(value);
+            const __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits,16),_mm_set1_epi32(1));
+            const __m128i rounded = _mm_srli_epi32(_mm_add_epi32(bits,_mm_add_epi32(_mm_set1_epi32(0x7FFF),lsb)),16);
+            const __m128i nan = _mm_or_si128(_mm_srli_epi32(bits,16),_mm_set1_epi32(0x40));
+            return _mm_blendv_epi8(rounded,nan,_mm_castps_si128(_mm_cmpunord_ps(value,value)));
+        }
+
+        template <>
+        struct Packet<bfloat16,4> : StoragePacket<bfloat16,4>{
+            static Packet<float,4> widen(const bfloat16 *ptr)noexcept{
+                const __m128i bits = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(ptr));
+                return Packet<float,4>{_mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(),bits))};
+            }
+            static void narrow(const Packet<float,4> &value,bfloat16 *ptr)noexcept{
+                const __m128i rounded = roundBfloat16(value.value);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(ptr),_mm_packus_epi32(rounded,rounded));
+            }
+        };
+        template <>
+        struct has_packet<bfloat16,4> : std::true_type{};
+#endif
+
+#if defined(__AVX2__)
+        template <>
+        struct Packet<bfloat16,8> : StoragePacket<bfloat16,8>{
+            static Packet<float,8> widen(const bfloat16 *ptr)noexcept{
+                const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+                return Packet<float,8>{_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bits),16))};
+            }
+            ///roundBfloat16 on all 8 lanes at once, packus works per 128-bit lane so the halves are joined after
+            static void narrow(const Packet<float,8> &value,bfloat16 *ptr)noexcept{
+                const __m256i bits = _mm256_castps_si256(value.value);
+                const __m256i high = _mm256_srli_epi32(bits,16);
+                const __m256i lsb = _mm256_and_si256(high,_mm256_set1_epi32(1));
+                const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits,_mm256_add_epi32(_mm256_set1_epi32(0x7FFF),lsb)),16);
+                const __m256i nan = _mm256_or_si256(high,_mm256_set1_epi32(0x40));
+                const __m256i res = _mm256_blendv_epi8(rounded,nan,_mm256_castps_si256(_mm256_cmp_ps(value.value,value.value,_CMP_UNORD_Q)));
+                const __m256i packed = _mm256_packus_epi32(res,res);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr),_mm256_castsi256_si128(_mm256_permute4x64_epi64(packed,0x08)));
+            }
+        };
+        template <>
+        struct has_packet<bfloat16,8> : std::true_type{};
+#endif
+
+        template <class Storage>
+        void convertStorage(const float *src,Storage *dst,size_t n)noexcept{
+            using P = widest_packet_t<Storage>;
+            size_t i = 0;
+            if constexpr (P::size > 1){
+                for(const size_t body = n - n % P::size;i < body;i += P::size){
+                    P::narrow(Packet<float,P::size>::load(src + i),dst + i);
+                }
+            }
+            for(;i < n;++i){
+                dst[i] = Storage(src[i]);
+            }
+        }
+        template <class Storage>
+        void convertStorage(const Storage *src,float *dst,size_t n)noexcept{
+            using P = widest_packet_t<Storage>;
+            size_t i = 0;
+            if constexpr (P::size > 1){
+                for(const size_t body = n - n % P::size;i < body;i += P::size){
+                    P::widen(src + i).store(dst + i);
+                }
+            }
+            for(;i < n;++i){
+                dst[i] = static_cast<float>(src[i]);
+            }
+        }
+    }
+
+    /**@name convert
+     * @note bulk conversion between float arrays and half/bfloat16 arrays of n values,
+     *       a widest Packet<half/bfloat16> at a time (F16C for half, SSE4.1/AVX2 for bfloat16),
+     *       one value at a time for the tail or without those
+     * @note rounding is to nearest even in every path, so the results do not depend on the target
+     */
+    inline void convert(const float *src,half *dst,size_t n)noexcept{
+        detail::convertStorage(src,dst,n);
+    }
+    inline void convert(const half *src,float *dst,size_t n)noexcept{
+        detail::convertStorage(src,dst,n);
+    }
+    inline void convert(const float *src,bfloat16 *dst,size_t n)noexcept{
+        detail::convertStorage(src,dst,n);
+    }
+    inline void convert(const bfloat16 *src,float *dst,size_t n)noexcept{
+        detail::convertStorage(src,dst,n);
+    }
+
+    ///converts n matrices at once, Matrix arrays are contiguous arrays of their elements
+    template <class From,class To,size_t Row,size_t Col>
+    void convert(const Matrix<From,Row,Col> *src,Matrix<To,Row,Col> *dst,size_t n)noexcept{
+        static_assert(sizeof(Matrix<From,Row,Col>) == sizeof(From) * Row * Col &&
+                      sizeof(Matrix<To,Row,Col>) == sizeof(To) * Row * Col,"Matrix must be tightly packed");
+        convert(src->data(),dst->data(),n * Row * Col);
+    }
+    ///converts n vectors at once, Vector arrays are contiguous arrays of their elements
+    template <class From,class To,size_t Count>
+    void convert(const Vector<From,Count> *src,Vector<To,Count> *dst,size_t n)noexcept{
+        static_assert(sizeof(Vector<From,Count>) == sizeof(From) * Count &&
+                      sizeof(Vector<To,Count>) == sizeof(To) * Count,"Vector must be tightly packed");
+        convert(src->data(),dst->data(),n * Count);
+    }
+
+    template <size_t Count>
+    using Vectorh = Vector<half,Count>;
+    template <size_t Count>
+    using Vectorbf = Vector<bfloat16,Count>;
+
+    using Vector2h = Vector<half,2>;
+    using Vector3h = Vector<half,3>;
+    using Vector4h = Vector<half,4>;
+
+    using Vector2bf = Vector<bfloat16,2>;
+    using Vector3bf = Vector<bfloat16,3>;
+    using Vector4bf = Vector<bfloat16,4>;
+
+    using Matrix3x4h = Matrix<half,3,4>;
+    using Matrix2h = Matrix<half,2,2>;
+    using Matrix3h = Matrix<half,3,3>;
+    using Matrix4h = Matrix<half,4,4>;
+
+    using Matrix3x4bf = Matrix<bfloat16,3,4>;
+    using Matrix2bf = Matrix<bfloat16,2,2>;
+    using Matrix3bf = Matrix<bfloat16,3,3>;
+    using Matrix4bf = Matrix<bfloat16,4,4>;
+}
+
+#endif //_XMATH_HALF_H_
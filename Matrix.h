@@ -1,7 +1,16 @@
 #ifndef _XMATH_MATRIX_H_
 #define _XMATH_MATRIX_H_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include "ConstMath.h"
+#include "Expression.h"
 
 #if !defined(XMATH_EPS)
 #define XMATH_EPS 1e-5
@@ -15,6 +24,225 @@ namespace xmath{
         down
     };
 
+    /**@name no_init
+     * @note Matrix(no_init)/Vector(no_init) leave the elements uninitialised,
+     *       for results that are about to be overwritten in full
+     */
+    struct no_init_t{
+        explicit no_init_t() = default;
+    };
+    constexpr no_init_t no_init{};
+
+    /**@name NoInitAllocator
+     * @note value-initialisation through it (std::vector<T>(n),resize(n)) constructs T(no_init),
+     *       so large std::vector<Matrix4f> buffers skip the zeroing pass
+     * @note every other construct() call is forwarded to Base
+     */
+    template <class Type,class Base = std::allocator<Type>>
+    class NoInitAllocator : public Base{
+        using traits = std::allocator_traits<Base>;
+    public:
+        template <class Type2>
+        struct rebind{
+            using other = NoInitAllocator<Type2,typename traits::template rebind_alloc<Type2>>;
+        };
+
+        using Base::Base;
+
+        template <class Type2>
+        void construct(Type2 *ptr)noexcept(std::is_nothrow_default_constructible<Type2>::value){
+            if constexpr (std::is_constructible<Type2,no_init_t>::value){
+                ::new(static_cast<void *>(ptr)) Type2(no_init);
+            }else{
+                ::new(static_cast<void *>(ptr)) Type2;
+            }
+        }
+        template <class Type2,class... Args>
+        void construct(Type2 *ptr,Args &&...args){
+            traits::construct(static_cast<Base &>(*this),ptr,std::forward<Args>(args)...);
+        }
+    };
+
+    namespace detail{
+        ///integer matrices are decomposed in double
+        template <class Type>
+        using compute_t = std::conditional_t<std::is_floating_point<Type>::value,Type,double>;
+
+        template <class Type,class Compute>
+        constexpr auto computeCast(const Compute &value)noexcept
+        -> std::enable_if_t<std::is_integral<Type>::value,Type>{
+            return static_cast<Type>(detail::round(value));
+        }
+        template <class Type,class Compute>
+        constexpr auto computeCast(const Compute &value)noexcept
+        -> std::enable_if_t<!std::is_integral<Type>::value,Type>{
+            return static_cast<Type>(value);
+        }
+
+        ///max |data[i]| for Beg <= i < End, split in halves so the comparisons form a tree rather than one chain
+        template <class Compute,size_t Beg,size_t End,class Type>
+        constexpr Compute maxAbsTree(const Type *data)noexcept{
+            if constexpr (End - Beg == 1){
+                return static_cast<Compute>(detail::abs(data[Beg]));
+            }else{
+                constexpr size_t Mid = Beg + (End - Beg) / 2;
+                return std::max(maxAbsTree<Compute,Beg,Mid>(data),maxAbsTree<Compute,Mid,End>(data));
+            }
+        }
+
+        ///the scale of the singularity tolerances, a tree up to 4x4 where it is on the critical path of inverse()
+        template <class Compute,size_t Count,class Type>
+        constexpr Compute maxAbs(const Type *data)noexcept{
+            if constexpr (Count <= 16){
+                return maxAbsTree<Compute,0,Count>(data);
+            }else{
+                Compute res = 0;
+                unroll<Count>([&](auto i){
+                    res = std::max(res,static_cast<Compute>(detail::abs(data[i])));
+                });
+                return res;
+            }
+        }
+
+        /**@name inverse3x3
+         * @note the closed-form inverse of the 3x3 A in the first three columns of the row-major src
+         *       (rows Stride apart), the columns of its adjugate are the cross products of the rows:
+         *       adj = [r1 x r2,r2 x r0,r0 x r1] and |A| = r0 . (r1 x r2)
+         * @note Stride == 4 reads src as [A | t] and also writes the last column, -A^-1 t, of the affine inverse
+         * @note computed in promote_t<Type>, scaled by 1/|A| (integers divide) and rounded to Type once
+         * @return false (and dst untouched) if A is singular
+         */
+        template <class Type,size_t Stride>
+        constexpr bool inverse3x3(const Type *src,Type *dst)noexcept{
+            using Compute = compute_t<Type>;
+            using Promote = promote_t<Type>;
+            std::array<Promote,9> a,adj;
+            unroll<9>([&](auto i){
+                a[i] = static_cast<Promote>(src[i / 3 * Stride + i % 3]);
+            });
+            unroll<3>([&](auto i){
+                const size_t j = (i + 1) % 3,k = (i + 2) % 3;
+                adj[i * 3]     = a[3 + j] * a[6 + k] - a[3 + k] * a[6 + j];
+                adj[i * 3 + 1] = a[6 + j] * a[k] - a[6 + k] * a[j];
+                adj[i * 3 + 2] = a[j] * a[3 + k] - a[k] * a[3 + j];
+            });
+            const Promote d = a[0] * adj[0] + a[1] * adj[3] + a[2] * adj[6];
+            const auto scale = maxAbs<Compute,9>(a.data());
+            if(!(detail::abs(static_cast<Compute>(d)) > 3 * std::numeric_limits<Compute>::epsilon() * scale * scale * scale)){
+                return false;
+            }
+            if constexpr (std::is_floating_point<Promote>::value){
+                const Promote inv = Promote(1) / d;
+                unroll<9>([&](auto i){
+                    adj[i] *= inv;
+                });
+            }else{
+                unroll<9>([&](auto i){
+                    adj[i] /= d;
+                });
+            }
+            unroll<9>([&](auto i){
+                dst[i / 3 * Stride + i % 3] = static_cast<Type>(adj[i]);
+            });
+            if constexpr (Stride == 4){
+                unroll<3>([&](auto i){
+                    dst[i * 4 + 3] = static_cast<Type>(-(adj[i * 3] * static_cast<Promote>(src[3])
+                                                       + adj[i * 3 + 1] * static_cast<Promote>(src[7])
+                                                       + adj[i * 3 + 2] * static_cast<Promote>(src[11])));
+                });
+            }
+            return true;
+        }
+
+        /**@name luDecompose
+         * @note in-place LU decomposition with partial pivoting of the N x N row-major lu,
+         *       afterwards lu holds L (unit diagonal,below) and U (on and above the diagonal)
+         *       and row i of lu is row perm[i] of the input
+         * @param sign the sign of the permutation
+         * @param tolerance pivots not larger than this are treated as zero
+         * @return false if the matrix is singular
+         */
+        template <class Type,size_t N>
+        constexpr bool luDecompose(Type *lu,size_t *perm,int &sign,Type tolerance)noexcept{
+            sign = 1;
+            for(size_t i = 0;i < N;++i){
+                perm[i] = i;
+            }
+            for(size_t k = 0;k < N;++k){
+                size_t pivot = k;
+                Type max = detail::abs(lu[k * N + k]);
+                for(size_t i = k + 1;i < N;++i){
+                    if(detail::abs(lu[i * N + k]) > max){
+                        pivot = i;
+                        max = detail::abs(lu[i * N + k]);
+                    }
+                }
+                if(max <= tolerance){
+                    return false;
+                }
+                if(pivot != k){
+                    std::swap_ranges(lu + k * N,lu + k * N + N,lu + pivot * N);
+                    std::swap(perm[k],perm[pivot]);
+                    sign = -sign;
+                }
+                const Type inv_pivot = Type(1) / lu[k * N + k];
+                for(size_t i = k + 1;i < N;++i){
+                    const Type factor = lu[i * N + k] *= inv_pivot;
+                    for(size_t j = k + 1;j < N;++j){
+                        lu[i * N + j] -= factor * lu[k * N + j];
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**@name luSolve
+         * @note solves A x = b for Cols right-hand sides (b and x are N x Cols, row-major)
+         *       given the output of luDecompose for A
+         */
+        template <class Type,size_t N,size_t Cols>
+        constexpr void luSolve(const Type *lu,const size_t *perm,const Type *b,Type *x)noexcept{
+            for(size_t i = 0;i < N;++i){
+                for(size_t c = 0;c < Cols;++c){
+                    x[i * Cols + c] = b[perm[i] * Cols + c];
+                }
+            }
+            for(size_t i = 1;i < N;++i){
+                for(size_t k = 0;k < i;++k){
+                    for(size_t c = 0;c < Cols;++c){
+                        x[i * Cols + c] -= lu[i * N + k] * x[k * Cols + c];
+                    }
+                }
+            }
+            for(size_t i = N;i-- > 0;){
+                for(size_t k = i + 1;k < N;++k){
+                    for(size_t c = 0;c < Cols;++c){
+                        x[i * Cols + c] -= lu[i * N + k] * x[k * Cols + c];
+                    }
+                }
+                const Type inv_diag = Type(1) / lu[i * N + i];
+                for(size_t c = 0;c < Cols;++c){
+                    x[i * Cols + c] *= inv_diag;
+                }
+            }
+        }
+    }
+
+    template <class Type,size_t Row,size_t Col>
+    class Matrix;
+
+    template <class Type,size_t Row,size_t Col,size_t RowStride,size_t ColStride>
+    class MatrixView;
+
+    template <class Type,size_t Row,size_t Col>
+    struct expression_traits<Matrix<Type,Row,Col>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = true;
+        static constexpr bool is_scalar = false;
+        using value_type = Type;
+        using result_type = Matrix<Type,Row,Col>;
+    };
+
     template <class Type,size_t Row,size_t Col>
     class Matrix{
     public:
@@ -29,28 +257,29 @@ namespace xmath{
             return Count;
         }
 
-        Matrix(){
-            for(auto &itr : m_data){
-                itr = 0;
-            }
-        }
-        explicit Matrix(Type value){
-            for(auto &itr : m_data){
-                itr = value;
-            }
-        }
-        explicit Matrix(const Type *ptr){
-            for(int i = 0;i < Count;++i){
+        constexpr Matrix(){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = 0;
+            });
+        }
+        constexpr explicit Matrix(no_init_t)noexcept{}
+        constexpr explicit Matrix(Type value){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = value;
+            });
+        }
+        constexpr explicit Matrix(const Type *ptr){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = ptr[i];
-            }
+            });
         }
         template <class Iterator>
-        Matrix(Iterator beg,Iterator end){
+        constexpr Matrix(Iterator beg,Iterator end){
             for(auto itr = m_data.begin();beg != end && itr != m_data.end();++itr,++beg){
                 *itr = *beg;
             }
         }
-        Matrix(std::initializer_list<Type> list){
+        constexpr Matrix(std::initializer_list<Type> list){
             for(auto itr1 = list.begin(),itr2 = m_data.begin();
                 itr1 != list.end() && itr2 != m_data.end();
                 ++itr1,++itr2){
@@ -58,17 +287,21 @@ namespace xmath{
             }
         }
         template<class Type2,size_t Row2,size_t Col2>
-        explicit Matrix(const Matrix<Type2,Row2,Col2> &mat){
+        constexpr explicit Matrix(const Matrix<Type2,Row2,Col2> &mat){
             static_assert(Count == Row2 * Col2,"The count of the Matrix must be equal");
-            for(auto i = 0; i < Count;++i){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = static_cast<Type>(mat[i]);
-            }
+            });
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,Matrix>>>
+        constexpr Matrix(const Expr &expr)noexcept{
+            detail::evaluate<Count>(m_data.data(),expr);
         }
         Matrix(const Matrix &mat) = default;
         Matrix(Matrix &&mat)noexcept = default;
         ~Matrix() = default;
 
-        Matrix &operator=(std::initializer_list<Type> list){
+        constexpr Matrix &operator=(std::initializer_list<Type> list){
             for(auto itr1 = list.begin(),itr2 = m_data.begin();
                 itr1 != list.end() && itr2 != m_data.end();
                 ++itr1,++itr2){
@@ -78,11 +311,23 @@ namespace xmath{
         }
 
         template <class Type2,size_t Row2,size_t Col2>
-        Matrix &operator=(const Matrix<Type2,Row2,Col2> &mat){
+        constexpr Matrix &operator=(const Matrix<Type2,Row2,Col2> &mat){
             static_assert(Count == Row2 * Col2,"The count of the Matrix must be equal");
-            for(auto i = 0; i < Count;++i){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = static_cast<Type>(mat[i]);
+            });
+            return *this;
+        }
+        /**@name operator=
+         * @note evaluated in place, unless expr reads this matrix through a view (e.g. m += m.transposeView()),
+         *       then through a temporary so no element is read after it was overwritten
+         */
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,Matrix>>>
+        constexpr Matrix &operator=(const Expr &expr)noexcept{
+            if(detail::aliases(expr,data(),data() + Count)){
+                return *this = Matrix(expr);
             }
+            detail::evaluate<Count>(m_data.data(),expr);
             return *this;
         }
         Matrix &operator=(const Matrix &mat) = default;
@@ -95,382 +340,490 @@ namespace xmath{
             return Col;
         }
 
-        Type &operator()(size_t x,size_t y)noexcept{
+        constexpr Type &operator()(size_t x,size_t y)noexcept{
             return m_data[x * Col + y];
         }
-        const Type &operator()(size_t x,size_t y)const noexcept {
+        constexpr const Type &operator()(size_t x,size_t y)const noexcept {
             return m_data[x * Col + y];
         }
 
-        Type &operator[](size_t index) noexcept{
+        constexpr Type &operator[](size_t index) noexcept{
             return m_data[index];
         }
-        const Type &operator[](size_t index) const noexcept {
+        constexpr const Type &operator[](size_t index) const noexcept {
             return m_data[index];
         }
 
-        operator Type *()noexcept {
+        constexpr operator Type *()noexcept {
             return m_data.data();
         }
-        operator const Type *()const noexcept {
+        constexpr operator const Type *()const noexcept {
             return m_data.data();
         }
 
-        Type *data()noexcept {
+        constexpr Type *data()noexcept {
             return m_data.data();
         }
-        const Type *data()const noexcept {
+        constexpr const Type *data()const noexcept {
             return m_data.data();
         }
 
+        ///the Packet starting at element index, used by the expression evaluator
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            return Packet::load(m_data.data() + index);
+        }
+
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto identity()
+        constexpr auto identity()const
         -> std::enable_if_t<Row2 == Col2,Matrix<Type2,Row2,Col2>>{
             Matrix<Type2,Row2,Col2> res;
-            for(size_t i = 0;i < Row2;++i){
+            detail::unroll<Row2>([&](auto i){
                 res(i,i) = 1;
-            }
+            });
             return res;
         }
 
-        Matrix operator+(const Matrix &mat)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] + mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Matrix operator+(const Type &val)const noexcept {
-            Matrix ans;
-            for(size_t i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] + val;
-            }
-        }
-
-        Matrix operator-(const Matrix &mat)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] - mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Matrix operator-(const Type &value)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] - value;
-            }
-            return ans;
-        }
-        Matrix operator-()const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = -m_data[i];
-            }
-            return ans;
-        }
-
-        Matrix operator*(const Matrix &mat)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] * mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Matrix operator*(const Type &value)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] * value;
-            }
-            return ans;
-        }
-
-        Matrix operator/(const Matrix &mat)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] / mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Matrix operator/(const Type &value)const noexcept{
-            Matrix ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] / value;
-            }
-            return ans;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Matrix &operator+=(const Expr &expr)noexcept{
+            return *this = *this + expr;
         }
-
-        Matrix &operator+=(const Matrix &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data += mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Matrix &operator-=(const Expr &expr)noexcept {
+            return *this = *this - expr;
         }
-        Matrix &operator-=(const Matrix &mat)noexcept {
-            for(size_t i = 0;i < Count;++i){
-                m_data -= mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Matrix &operator*=(const Expr &expr)noexcept{
+            return *this = *this * expr;
         }
-        Matrix &operator*=(const Matrix &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data *= mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Matrix &operator/=(const Expr &expr)noexcept{
+            return *this = *this / expr;
         }
-        Matrix &operator/=(const Matrix &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data /= mat.m_data[i];
-            }
-            return *this;
+        constexpr Matrix &operator+=(const Type &value)noexcept{
+            return *this = *this + value;
         }
-        Matrix &operator+=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data += value;
-            }
-            return *this;
+        constexpr Matrix &operator-=(const Type &value)noexcept {
+            return *this = *this - value;
         }
-        Matrix &operator-=(const Type &value)noexcept {
-            for(size_t i = 0;i < Count;++i){
-                m_data -= value;
-            }
-            return *this;
+        constexpr Matrix &operator*=(const Type &value)noexcept{
+            return *this = *this * value;
         }
-        Matrix &operator*=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data *= value;
-            }
-            return *this;
-        }
-        Matrix &operator/=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data /= value;
-            }
-            return *this;
+        constexpr Matrix &operator/=(const Type &value)noexcept{
+            return *this = *this / value;
         }
 
 
-        bool operator==(const Matrix &mat)const noexcept {
-            for(auto itr1 = m_data.begin(),
-                        itr2 = mat.m_data.begin();
-                itr1 != m_data.end();
-                ++itr1,++itr2){
-                if(std::abs(*itr1 - *itr2) > XMATH_EPS){
-                    return false;
-                }
-            }
-            return true;
-        }
-        bool operator!=(const Matrix &mat)const noexcept {
+        constexpr bool operator==(const Matrix &mat)const noexcept {
+            bool equal = true;
+            detail::unroll<Count>([&](auto i){
+                equal &= detail::abs(m_data[i] - mat.m_data[i]) <= XMATH_EPS;
+            });
+            return equal;
+        }
+        constexpr bool operator!=(const Matrix &mat)const noexcept {
             return !(*this == mat);
         }
 
         template <size_t Col2>
-        Matrix<Type,Row,Col2> operator%(const Matrix<Type,Col,Col2> &mat)const noexcept{
-            Matrix<Type,Row,Col2> res;
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col2;++j){
-                    for(size_t k = 0;k < Col;++k){
-                        res(i,j) += (*this)(i,k) * mat(k,j);
-                    }
-                }
-            }
+        constexpr Matrix<Type,Row,Col2> operator%(const Matrix<Type,Col,Col2> &mat)const noexcept{
+            Matrix<Type,Row,Col2> res(no_init);
+            detail::product<Type,Row,Col,Col2>(data(),mat.data(),res.data());
             return res;
         }
 
         template <Direction dir = Direction::right,class Type2 = Type,size_t Row2,size_t Col2>
-        auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
+        constexpr auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
         -> std::enable_if_t<dir == Direction::right && Row == Row2,Matrix<Type2,Row,Col+Col2>>{
-            Matrix<Type2,Row,Col+Col2> res;
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col;++j){
-                    res(i,j) = (*this)(i,j);
-                }
-            }
-            for(size_t i = 0;i < Row2;++i){
-                for(size_t j = 0;j < Col2;++j){
-                    res(i,j + Col) = mat(i,j);
-                }
-            }
+            Matrix<Type2,Row,Col+Col2> res(no_init);
+            detail::unrollGrid<Row,Col>([&](auto i,auto j){
+                res(i,j) = (*this)(i,j);
+            });
+            detail::unrollGrid<Row2,Col2>([&](auto i,auto j){
+                res(i,j + Col) = mat(i,j);
+            });
             return res;
         }
         template <Direction dir,class Type2 = Type,size_t Row2,size_t Col2>
-        auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
+        constexpr auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
         -> std::enable_if_t<dir == Direction::left && Row == Row2,Matrix<Type2,Row,Col+Col2>>{
-            Matrix<Type2,Row,Col+Col2> res;
-            for(size_t i = 0;i < Row2;++i){
-                for(size_t j = 0;j < Col2;++j){
-                    res(i,j) = mat(i,j);
-                }
-            }
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col;++j){
-                    res(i,j + Col2) = (*this)(i,j);
-                }
-            }
+            Matrix<Type2,Row,Col+Col2> res(no_init);
+            detail::unrollGrid<Row2,Col2>([&](auto i,auto j){
+                res(i,j) = mat(i,j);
+            });
+            detail::unrollGrid<Row,Col>([&](auto i,auto j){
+                res(i,j + Col2) = (*this)(i,j);
+            });
             return res;
         }
         template <Direction dir,class Type2 = Type,size_t Row2,size_t Col2>
-        auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
+        constexpr auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
         -> std::enable_if_t<dir == Direction::up && Col == Col2,Matrix<Type2,Row+Row2,Col>>{
-            Matrix<Type2,Row+Row2,Col> res;
-            for(size_t i = 0;i < Row2;++i){
-                for(size_t j = 0;j < Col2;++j){
-                    res(i,j) = mat(i,j);
-                }
-            }
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col;++j){
-                    res(i + Row2,j) = (*this)(i,j);
-                }
-            }
+            Matrix<Type2,Row+Row2,Col> res(no_init);
+            detail::unroll<Row2 * Col2>([&](auto index){
+                res[index] = mat[index];
+            });
+            detail::unroll<Count>([&](auto index){
+                res[index + Row2 * Col2] = m_data[index];
+            });
             return res;
         }
         template <Direction dir,class Type2 = Type,size_t Row2,size_t Col2>
-        auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
+        constexpr auto extend(const Matrix<Type2,Row2,Col2> &mat)const noexcept
         -> std::enable_if_t<dir == Direction::down && Col == Col2,Matrix<Type2,Row+Row2,Col>>{
-            Matrix<Type2,Row+Row2,Col> res;
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col;++j){
-                    res(i,j) = (*this)(i,j);
-                }
-            }
-            for(size_t i = 0;i < Row2;++i){
-                for(size_t j = 0;j < Col2;++j){
-                    res(i + Row,j) = mat(i,j);
-                }
-            }
+            Matrix<Type2,Row+Row2,Col> res(no_init);
+            detail::unroll<Count>([&](auto index){
+                res[index] = m_data[index];
+            });
+            detail::unroll<Row2 * Col2>([&](auto index){
+                res[index + Count] = mat[index];
+            });
             return res;
         }
 
         template<class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto cofactor(size_t x,size_t y)const noexcept
+        constexpr auto cofactor(size_t x,size_t y)const noexcept
         -> std::enable_if_t<(Row2 > 1 && Col2 > 1),Matrix<Type2,Row2-1,Col2-1>>{
-            Matrix<Type2,Row2-1,Col2-1> res;
-            size_t k = 0;
-            for(size_t i = 0;i < Row;++i){
-                for(size_t j = 0;j < Col;++j){
-                    if(i == x || j == y)
-                        continue;
-                    res[k++] = (*this)(i,j);
-                }
-            }
+            Matrix<Type2,Row2-1,Col2-1> res(no_init);
+            detail::unrollGrid<Row2 - 1,Col2 - 1>([&](auto i,auto j){
+                res(i,j) = (*this)(i < x ? i : i + 1,j < y ? j : j + 1);
+            });
             return res;
         }
 
+        /**@name det
+         * @note returned in promote_t<Type>, a float for half/bfloat16 whose determinant easily leaves their range
+         */
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto det()const noexcept
-        -> std::enable_if_t<Row2 == 1 && Col2 == 1,Type2>{
+        constexpr auto det()const noexcept
+        -> std::enable_if_t<Row2 == 1 && Col2 == 1,detail::promote_t<Type2>>{
             return m_data[0];
         }
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto det()const noexcept
-        -> std::enable_if_t<Row2 == 2 && Col2 == 2,Type2>{
-            return m_data[0] * m_data[3] - m_data[2] * m_data[1];
+        constexpr auto det()const noexcept
+        -> std::enable_if_t<Row2 == 2 && Col2 == 2,detail::promote_t<Type2>>{
+            using Promote = detail::promote_t<Type2>;
+            return static_cast<Promote>(m_data[0]) * m_data[3] - static_cast<Promote>(m_data[2]) * m_data[1];
         }
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto det()const noexcept
-        -> std::enable_if_t<Row2 == 3 && Col2 == 3,Type2>{
-            return    (*this)(0,0) * (*this)(1,1) * (*this)(2,2)
-                      +(*this)(0,1) * (*this)(1,2) * (*this)(2,0)
-                      +(*this)(0,2) * (*this)(1,0) * (*this)(2,1)
-                      -(*this)(0,0) * (*this)(1,2) * (*this)(2,1)
-                      -(*this)(0,1) * (*this)(1,0) * (*this)(2,2)
-                      -(*this)(0,2) * (*this)(1,1) * (*this)(2,0);
-        }
+        constexpr auto det()const noexcept
+        -> std::enable_if_t<Row2 == 3 && Col2 == 3,detail::promote_t<Type2>>{
+            using Promote = detail::promote_t<Type2>;
+            const auto at = [&](size_t x,size_t y){
+                return static_cast<Promote>((*this)(x,y));
+            };
+            return    at(0,0) * at(1,1) * at(2,2)
+                      +at(0,1) * at(1,2) * at(2,0)
+                      +at(0,2) * at(1,0) * at(2,1)
+                      -at(0,0) * at(1,2) * at(2,1)
+                      -at(0,1) * at(1,0) * at(2,2)
+                      -at(0,2) * at(1,1) * at(2,0);
+        }
+        ///from the twelve 2x2 sub-determinants of the upper and lower two rows, as inverse()
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto det()const noexcept
-        -> std::enable_if_t<(Row2 == Col2 && Row2 > 3 && Col2 > 3),Type2>{
-            Type2 res = 0.0;
-            for(size_t i = 0; i < Row2;++i){
-                res += (*this)(0,i) * cofactor(0,i).det() * (i % 2 == 0 ? 1.0 : -1.0);
+        constexpr auto det()const noexcept
+        -> std::enable_if_t<Row2 == 4 && Col2 == 4,detail::promote_t<Type2>>{
+            detail::promote_t<Type2> s[6],c[6];
+            return detail::minors4x4(m_data.data(),s,c);
+        }
+        /**@name det
+         * @note LU decomposition with partial pivoting, O(N^3)
+         */
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto det()const noexcept
+        -> std::enable_if_t<(Row2 == Col2 && Row2 > 4 && Col2 > 4),detail::promote_t<Type2>>{
+            using Compute = detail::compute_t<Type2>;
+            std::array<Compute,Count> lu;
+            std::array<size_t,Row2> perm;
+            int sign;
+            for(size_t i = 0;i < Count;++i){
+                lu[i] = static_cast<Compute>(m_data[i]);
             }
-            return res;
+            if(!detail::luDecompose<Compute,Row2>(lu.data(),perm.data(),sign,Compute(0))){
+                return detail::promote_t<Type2>(0);
+            }
+            Compute res = sign;
+            for(size_t i = 0;i < Row2;++i){
+                res *= lu[i * Row2 + i];
+            }
+            return detail::computeCast<detail::promote_t<Type2>>(res);
         }
 
 
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto adjoint()const noexcept
+        constexpr auto adjoint()const noexcept
         -> std::enable_if_t<Row2 == Col2,Matrix<Type2,Row2,Col2>>{
-            Matrix<Type2,Row2,Col2> res;
-            for(int i = 0;i < Row2;++i){
-                for(int j = 0;j < Col2;++j){
-                    res(i,j) = (i + j) % 2 == 1 ? -cofactor(i,j).det() : cofactor(i,j).det();
-                }
-            }
-            return res.transpose();
+            Matrix<Type2,Row2,Col2> res(no_init);
+            //transposed on the fly: res(j,i) is the (i,j) cofactor
+            detail::unrollGrid<Row2,Col2>([&](auto i,auto j){
+                const auto minor = cofactor(i,j).det();
+                res(j,i) = static_cast<Type2>((i + j) % 2 == 1 ? -minor : minor);
+            });
+            return res;
         }
 
+        /**@name inverse
+         * @note closed forms up to 4x4, LU decomposition with partial pivoting above
+         * @param invertible set to false (and a zero Matrix returned) if the matrix is singular
+         */
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverse(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && Row2 == 1,Matrix<Type2,Row2,Col2>>{
+            invertible = m_data[0] != Type2(0);
+            if(!invertible){
+                return Matrix<Type2,Row2,Col2>();
+            }
+            return Matrix<Type2,Row2,Col2>(Type2(1) / m_data[0]);
+        }
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverse(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && Row2 == 2,Matrix<Type2,Row2,Col2>>{
+            using Compute = detail::compute_t<Type2>;
+            using Promote = detail::promote_t<Type2>;
+            const std::array<Promote,Count> a{m_data[0],m_data[1],m_data[2],m_data[3]};
+            std::array<Promote,Count> adj{a[3],-a[1],-a[2],a[0]};
+            const Promote d = a[0] * a[3] - a[2] * a[1];
+            const auto scale = detail::maxAbs<Compute,Count>(a.data());
+            invertible = detail::abs(static_cast<Compute>(d)) > 2 * std::numeric_limits<Compute>::epsilon() * scale * scale;
+            if(!invertible){
+                return Matrix<Type2,Row2,Col2>();
+            }
+            //scaled by 1/d before it is rounded to Type2, integers divide
+            Matrix<Type2,Row2,Col2> res(no_init);
+            if constexpr (std::is_floating_point<Promote>::value){
+                const Promote inv = Promote(1) / d;
+                detail::unroll<Count>([&](auto i){
+                    res[i] = static_cast<Type2>(adj[i] * inv);
+                });
+            }else{
+                detail::unroll<Count>([&](auto i){
+                    res[i] = static_cast<Type2>(adj[i] / d);
+                });
+            }
+            return res;
+        }
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverse(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && Row2 == 3,Matrix<Type2,Row2,Col2>>{
+            Matrix<Type2,Row2,Col2> res(no_init);
+            invertible = detail::inverse3x3<Type2,3>(m_data.data(),res.data());
+            if(!invertible){
+                return Matrix<Type2,Row2,Col2>();
+            }
+            return res;
+        }
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverse(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && Row2 == 4,Matrix<Type2,Row2,Col2>>{
+            using Compute = detail::compute_t<Type2>;
+            Matrix<Type2,Row2,Col2> res(no_init);
+            const auto d = detail::Inverse4x4Kernel<Type2>::run(m_data.data(),res.data());
+            Compute tolerance = Row2 * std::numeric_limits<Compute>::epsilon();
+            const auto scale = detail::maxAbs<Compute,Count>(m_data.data());
+            detail::unroll<Row2>([&](auto){
+                tolerance *= scale;
+            });
+            invertible = detail::abs(static_cast<Compute>(d)) > tolerance;
+            if(!invertible){
+                return Matrix<Type2,Row2,Col2>();
+            }
+            return res;
+        }
         template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
-        auto inverse()const noexcept
+        constexpr auto inverse(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && (Row2 > 4),Matrix<Type2,Row2,Col2>>{
+            Matrix<Type2,Row2,Col2> id;
+            for(size_t i = 0;i < Row2;++i){
+                id(i,i) = 1;
+            }
+            return solve(id,invertible);
+        }
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverse()const noexcept
         -> std::enable_if_t<Row2 == Col2,Matrix<Type2,Row2,Col2>>{
-            return adjoint() / det();
+            bool invertible;
+            return inverse(invertible);
         }
 
-        Matrix<Type,Col,Row> transpose()const noexcept{
-            Matrix<Type,Col,Row> res;
-            for(size_t i = 0; i < Row;++i){
-                for(size_t j = 0; j < Col;++j){
-                    res(j,i) = (*this)(i,j);
-                }
+        /**@name inverseAffine
+         * @note for a 4x4 whose last row is [0,0,0,1]: | A t |^-1 = | A^-1 -A^-1 t |
+         *                                             | 0 1 |      | 0     1      |
+         * @param invertible set to false (and a zero Matrix returned) if A is singular
+         */
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverseAffine(bool &invertible)const noexcept
+        -> std::enable_if_t<Row2 == 4 && Col2 == 4,Matrix<Type2,4,4>>{
+            Matrix<Type2,4,4> res(no_init);
+            invertible = detail::inverse3x3<Type2,4>(m_data.data(),res.data());
+            if(!invertible){
+                return Matrix<Type2,4,4>();
             }
+            res(3,0) = res(3,1) = res(3,2) = 0;
+            res(3,3) = 1;
             return res;
         }
-        Matrix<Type,Col,Row> operator~()const noexcept{
-            return transpose();
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverseAffine()const noexcept
+        -> std::enable_if_t<Row2 == 4 && Col2 == 4,Matrix<Type2,4,4>>{
+            bool invertible;
+            return inverseAffine(invertible);
         }
 
-        template <size_t Row2,size_t Col2>
-        Matrix<Type,Row2,Col2> sub(size_t x,size_t y)const noexcept{
-            Matrix<Type,Row2,Col2> res;
-            for(size_t i = 0;i < Row2;++i){
-                for(size_t j = 0;j < Col2; ++j){
-                    res(i,j) = (*this)(x+i,y+j);
-                }
+        /**@name inverseRigid
+         * @note for a rotation + translation only: | R t |^-1 = | R^T -R^T t |
+         *                                          | 0 1 |      | 0    1     |
+         */
+        template <class Type2 = Type,size_t Row2 = Row,size_t Col2 = Col>
+        constexpr auto inverseRigid()const noexcept
+        -> std::enable_if_t<Row2 == 4 && Col2 == 4,Matrix<Type2,4,4>>{
+            Matrix<Type2,4,4> res(no_init);
+            detail::unroll<3>([&](auto i){
+                detail::unroll<3>([&](auto j){
+                    res(i,j) = (*this)(j,i);
+                });
+                res(i,3) = -((*this)(0,i) * (*this)(0,3) + (*this)(1,i) * (*this)(1,3) + (*this)(2,i) * (*this)(2,3));
+            });
+            res(3,0) = res(3,1) = res(3,2) = 0;
+            res(3,3) = 1;
+            return res;
+        }
+
+        /**@name solve
+         * @note solves (*this) % x = b by LU decomposition with partial pivoting
+         * @param solvable set to false (and a zero Matrix returned) if the matrix is singular
+         */
+        template <size_t Col2,size_t Row2 = Row,size_t Col3 = Col>
+        constexpr auto solve(const Matrix<Type,Row,Col2> &b,bool &solvable)const noexcept
+        -> std::enable_if_t<Row2 == Col3,Matrix<Type,Row,Col2>>{
+            using Compute = detail::compute_t<Type>;
+            std::array<Compute,Count> lu;
+            std::array<size_t,Row> perm;
+            int sign;
+            for(size_t i = 0;i < Count;++i){
+                lu[i] = static_cast<Compute>(m_data[i]);
+            }
+            const Compute tolerance = Row * std::numeric_limits<Compute>::epsilon()
+                                    * detail::maxAbs<Compute,Count>(m_data.data());
+            solvable = detail::luDecompose<Compute,Row>(lu.data(),perm.data(),sign,tolerance);
+            if(!solvable){
+                return Matrix<Type,Row,Col2>();
+            }
+            std::array<Compute,Row * Col2> rhs,x;
+            for(size_t i = 0;i < Row * Col2;++i){
+                rhs[i] = static_cast<Compute>(b[i]);
+            }
+            detail::luSolve<Compute,Row,Col2>(lu.data(),perm.data(),rhs.data(),x.data());
+            Matrix<Type,Row,Col2> res(no_init);
+            for(size_t i = 0;i < Row * Col2;++i){
+                res[i] = detail::computeCast<Type>(x[i]);
             }
             return res;
         }
+        template <size_t Col2,size_t Row2 = Row,size_t Col3 = Col>
+        constexpr auto solve(const Matrix<Type,Row,Col2> &b)const noexcept
+        -> std::enable_if_t<Row2 == Col3,Matrix<Type,Row,Col2>>{
+            bool solvable;
+            return solve(b,solvable);
+        }
 
+        constexpr Matrix<Type,Col,Row> transpose()const noexcept{
+            Matrix<Type,Col,Row> res(no_init);
+            detail::TransposeKernel<Type,Row,Col>::run(data(),res.data());
+            return res;
+        }
+        constexpr Matrix<Type,Col,Row> operator~()const noexcept{
+            return transpose();
+        }
 
-        Matrix<Type,1,Col> row(size_t r)const noexcept{
-            return sub<1,Col>(r,0);
+        template <size_t Row2,size_t Col2>
+        constexpr Matrix<Type,Row2,Col2> sub(size_t x,size_t y)const noexcept{
+            return Matrix<Type,Row2,Col2>(subView<Row2,Col2>(x,y));
         }
 
-        Matrix<Type,Row,1> col(size_t c)const noexcept{
-            return sub<Row,1>(0,c);
+
+        constexpr Matrix<Type,1,Col> row(size_t r)const noexcept{
+            return Matrix<Type,1,Col>(rowView(r));
+        }
+
+        constexpr Matrix<Type,Row,1> col(size_t c)const noexcept{
+            return Matrix<Type,Row,1>(colView(c));
         }
 
-        iterator begin()noexcept{
+        /**@name view
+         * @note the non-copying counterparts of sub(),row(),col(),transpose() and extend(),
+         *       see MatrixView
+         */
+        constexpr MatrixView<Type,Row,Col,Col,1> view()noexcept{
+            return MatrixView<Type,Row,Col,Col,1>(data());
+        }
+        constexpr MatrixView<const Type,Row,Col,Col,1> view()const noexcept{
+            return MatrixView<const Type,Row,Col,Col,1>(data());
+        }
+        template <size_t Row2,size_t Col2>
+        constexpr MatrixView<Type,Row2,Col2,Col,1> subView(size_t x,size_t y)noexcept{
+            return view().template sub<Row2,Col2>(x,y);
+        }
+        template <size_t Row2,size_t Col2>
+        constexpr MatrixView<const Type,Row2,Col2,Col,1> subView(size_t x,size_t y)const noexcept{
+            return view().template sub<Row2,Col2>(x,y);
+        }
+        constexpr MatrixView<Type,1,Col,Col,1> rowView(size_t r)noexcept{
+            return view().row(r);
+        }
+        constexpr MatrixView<const Type,1,Col,Col,1> rowView(size_t r)const noexcept{
+            return view().row(r);
+        }
+        constexpr MatrixView<Type,Row,1,Col,1> colView(size_t c)noexcept{
+            return view().col(c);
+        }
+        constexpr MatrixView<const Type,Row,1,Col,1> colView(size_t c)const noexcept{
+            return view().col(c);
+        }
+        constexpr MatrixView<Type,Col,Row,1,Col> transposeView()noexcept{
+            return view().transpose();
+        }
+        constexpr MatrixView<const Type,Col,Row,1,Col> transposeView()const noexcept{
+            return view().transpose();
+        }
+        template <Direction dir = Direction::right,class Expr>
+        constexpr auto extendView(Expr &&expr)const noexcept{
+            return view().template extend<dir>(std::forward<Expr>(expr));
+        }
+
+        constexpr iterator begin()noexcept{
+            return m_data.begin();
+        }
+        constexpr iterator end()noexcept {
+            return m_data.end();
+        }
+        constexpr const_iterator begin()const noexcept{
             return m_data.begin();
         }
-        iterator end()noexcept {
+        constexpr const_iterator end()const noexcept{
             return m_data.end();
         }
-        const_iterator cbegin()const noexcept{
+        constexpr const_iterator cbegin()const noexcept{
             return m_data.cbegin();
         }
-        const_iterator cend()const noexcept{
+        constexpr const_iterator cend()const noexcept{
             return m_data.cend();
         }
-        reverse_iterator rbegin()noexcept{
+        constexpr reverse_iterator rbegin()noexcept{
             return m_data.rbegin();
         }
-        reverse_iterator rend()noexcept{
+        constexpr reverse_iterator rend()noexcept{
             return m_data.rend();
         }
-        const_reverse_iterator crbegin()const noexcept{
-            return m_data,crbegin();
+        constexpr const_reverse_iterator crbegin()const noexcept{
+            return m_data.crbegin();
         }
-        const_reverse_iterator crend()const noexcept{
+        constexpr const_reverse_iterator crend()const noexcept{
             return m_data.crend();
         }
 
 
         friend std::ostream &operator<<(std::ostream &os,const Matrix &mat){
-            auto i = 0;
+            size_t i = 0;
             for(const auto &itr : mat.m_data){
                 if(i == 0){
                     os << '[';
@@ -492,6 +845,325 @@ namespace xmath{
         std::array<value_type,Count> m_data;
     };
 
+    namespace detail{
+        template <class Type>
+        struct matrix_shape;
+        template <class Type,size_t Row,size_t Col>
+        struct matrix_shape<Matrix<Type,Row,Col>>{
+            static constexpr size_t rows = Row;
+            static constexpr size_t cols = Col;
+        };
+
+        ///expr shifted by offset elements, so one row of a strided view can be evaluated on its own
+        template <class Expr>
+        class OffsetExpression{
+        public:
+            constexpr OffsetExpression(const Expr &expr,size_t offset)noexcept
+                :m_expr(expr),m_offset(offset){}
+
+            constexpr auto operator[](size_t index)const noexcept{
+                return m_expr[index + m_offset];
+            }
+            template <class Packet>
+            Packet packet(size_t index)const noexcept{
+                return m_expr.template packet<Packet>(index + m_offset);
+            }
+        private:
+            const Expr &m_expr;
+            size_t m_offset;
+        };
+        template <class Expr,size_t Count>
+        struct packet_lanes<OffsetExpression<Expr>,Count>
+            : std::integral_constant<size_t,std::gcd(packet_lanes<Expr,Count>::value,Count)>{};
+    }
+
+    template <bool Horizontal,class First,class Second>
+    class ExtendExpression;
+
+    template <bool Horizontal,class First,class Second>
+    struct expression_traits<ExtendExpression<Horizontal,First,Second>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = false;
+        using value_type = typename ExtendExpression<Horizontal,First,Second>::value_type;
+        using result_type = typename ExtendExpression<Horizontal,First,Second>::result_type;
+    };
+
+    /**@name ExtendExpression
+     * @note the lazy form of extend(): First and Second side by side (Horizontal) or stacked,
+     *       both are matrix expressions of the same value_type
+     * @note like the other expressions it refers to lvalue Matrix operands, so it must not outlive them
+     */
+    template <bool Horizontal,class First,class Second>
+    class ExtendExpression : public ExpressionNode<ExtendExpression<Horizontal,First,Second>>{
+        using first_shape = detail::matrix_shape<typename expression_traits<First>::result_type>;
+        using second_shape = detail::matrix_shape<typename expression_traits<Second>::result_type>;
+        static constexpr size_t Row1 = first_shape::rows,Col1 = first_shape::cols;
+        static constexpr size_t Row2 = second_shape::rows,Col2 = second_shape::cols;
+        static_assert(Horizontal ? Row1 == Row2 : Col1 == Col2,"The extended sides must be the same length");
+    public:
+        using value_type = typename expression_traits<First>::value_type;
+        static constexpr size_t Row = Horizontal ? Row1 : Row1 + Row2;
+        static constexpr size_t Col = Horizontal ? Col1 + Col2 : Col1;
+        using result_type = Matrix<value_type,Row,Col>;
+
+        constexpr ExtendExpression(First first,Second second)noexcept
+            :m_first(std::forward<First>(first)),m_second(std::forward<Second>(second)){}
+
+        constexpr value_type operator()(size_t x,size_t y)const noexcept{
+            return (*this)[x * Col + y];
+        }
+        constexpr value_type operator[](size_t index)const noexcept{
+            if constexpr (Horizontal){
+                const size_t x = index / Col,y = index % Col;
+                return y < Col1 ? m_first[x * Col1 + y] : m_second[x * Col2 + y - Col1];
+            }else{
+                return index < Row1 * Col1 ? m_first[index] : m_second[index - Row1 * Col1];
+            }
+        }
+
+        ///packet_lanes keeps every Packet on one side of the seam
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            if constexpr (Horizontal){
+                const size_t x = index / Col,y = index % Col;
+                return y < Col1 ? m_first.template packet<Packet>(x * Col1 + y)
+                                : m_second.template packet<Packet>(x * Col2 + y - Col1);
+            }else{
+                return index < Row1 * Col1 ? m_first.template packet<Packet>(index)
+                                           : m_second.template packet<Packet>(index - Row1 * Col1);
+            }
+        }
+
+        constexpr bool aliases(const void *first,const void *last)const noexcept{
+            return detail::aliases(m_first,first,last) || detail::aliases(m_second,first,last);
+        }
+
+        constexpr result_type eval()const noexcept{
+            return result_type(*this);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const ExtendExpression &expr){
+            return os << expr.eval();
+        }
+    private:
+        First m_first;
+        Second m_second;
+    };
+
+    namespace detail{
+        template <bool Horizontal,class First,class Second,size_t Count>
+        struct packet_lanes<ExtendExpression<Horizontal,First,Second>,Count>{
+            using first_shape = matrix_shape<typename expression_traits<First>::result_type>;
+            using second_shape = matrix_shape<typename expression_traits<Second>::result_type>;
+            static constexpr size_t first_count = first_shape::rows * first_shape::cols;
+            static constexpr size_t second_count = second_shape::rows * second_shape::cols;
+            static constexpr size_t value = std::gcd(
+                    std::gcd(packet_lanes<First,first_count>::value,packet_lanes<Second,second_count>::value),
+                    Horizontal ? std::gcd(first_shape::cols,second_shape::cols) : first_count);
+        };
+    }
+
+    template <class Type,size_t Row,size_t Col,size_t RowStride,size_t ColStride>
+    struct expression_traits<MatrixView<Type,Row,Col,RowStride,ColStride>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = false;
+        static constexpr bool is_scalar = false;
+        using value_type = std::remove_const_t<Type>;
+        using result_type = Matrix<value_type,Row,Col>;
+    };
+
+    /**@name MatrixView
+     * @note a non-owning Row x Col window onto Matrix storage, element (x,y) is
+     *       data()[x * RowStride + y * ColStride], Type may be const for read-only views
+     * @note it is an expression of Matrix<Type,Row,Col>: it can be used with the element-wise operators,
+     *       %, and constructs/assigns a Matrix, nothing is copied before that
+     * @note assigning to a view writes through to the viewed elements,
+     *       the right-hand side must not overlap the view in a different order (e.g. m.transposeView() = m),
+     *       Matrix::operator= and the compound operators check for views of themselves, see aliases()
+     */
+    template <class Type,size_t Row,size_t Col,size_t RowStride,size_t ColStride>
+    class MatrixView{
+    public:
+        using value_type = std::remove_const_t<Type>;
+        static constexpr size_t Count = Row * Col;
+        ///element i of the view is data()[i]
+        static constexpr bool is_contiguous = ColStride == 1 && (RowStride == Col || Row == 1);
+
+        constexpr explicit MatrixView(Type *data)noexcept
+            :m_data(data){}
+        MatrixView(const MatrixView &) = default;
+        template <class Type2 = Type,class = std::enable_if_t<std::is_const<Type2>::value>>
+        constexpr MatrixView(const MatrixView<value_type,Row,Col,RowStride,ColStride> &view)noexcept
+            :m_data(view.data()){}
+        ~MatrixView() = default;
+
+        constexpr MatrixView &operator=(const MatrixView &view)noexcept{
+            assign(view);
+            return *this;
+        }
+        template <class Expr,class = std::enable_if_t<
+                std::is_same<typename expression_traits<Expr>::result_type,Matrix<value_type,Row,Col>>::value>>
+        constexpr MatrixView &operator=(const Expr &expr)noexcept{
+            assign(expr);
+            return *this;
+        }
+
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr MatrixView &operator+=(const Expr &expr)noexcept{
+            return *this = *this + expr;
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr MatrixView &operator-=(const Expr &expr)noexcept{
+            return *this = *this - expr;
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr MatrixView &operator*=(const Expr &expr)noexcept{
+            return *this = *this * expr;
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr MatrixView &operator/=(const Expr &expr)noexcept{
+            return *this = *this / expr;
+        }
+        constexpr MatrixView &operator+=(const value_type &value)noexcept{
+            return *this = *this + value;
+        }
+        constexpr MatrixView &operator-=(const value_type &value)noexcept{
+            return *this = *this - value;
+        }
+        constexpr MatrixView &operator*=(const value_type &value)noexcept{
+            return *this = *this * value;
+        }
+        constexpr MatrixView &operator/=(const value_type &value)noexcept{
+            return *this = *this / value;
+        }
+
+        constexpr size_t getRowCount()const noexcept{
+            return Row;
+        }
+        constexpr size_t getColCount()const noexcept{
+            return Col;
+        }
+        constexpr size_t count()const noexcept{
+            return Count;
+        }
+
+        constexpr Type &operator()(size_t x,size_t y)const noexcept{
+            return m_data[x * RowStride + y * ColStride];
+        }
+        ///row-major like Matrix::operator[]
+        constexpr Type &operator[](size_t index)const noexcept{
+            return (*this)(index / Col,index % Col);
+        }
+        constexpr Type *data()const noexcept{
+            return m_data;
+        }
+
+        ///packet_lanes keeps every Packet in one row, or single lanes if a row is not contiguous
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            if constexpr (is_contiguous){
+                return Packet::load(m_data + index);
+            }else{
+                return Packet::load(&(*this)[index]);
+            }
+        }
+
+        template <size_t Row2,size_t Col2>
+        constexpr MatrixView<Type,Row2,Col2,RowStride,ColStride> sub(size_t x,size_t y)const noexcept{
+            return MatrixView<Type,Row2,Col2,RowStride,ColStride>(&(*this)(x,y));
+        }
+        constexpr MatrixView<Type,1,Col,RowStride,ColStride> row(size_t r)const noexcept{
+            return sub<1,Col>(r,0);
+        }
+        constexpr MatrixView<Type,Row,1,RowStride,ColStride> col(size_t c)const noexcept{
+            return sub<Row,1>(0,c);
+        }
+        constexpr MatrixView<Type,Col,Row,ColStride,RowStride> transpose()const noexcept{
+            return MatrixView<Type,Col,Row,ColStride,RowStride>(m_data);
+        }
+
+        ///the lazy extend(), dir places expr like Matrix::extend<dir>()
+        template <Direction dir = Direction::right,class Expr>
+        constexpr auto extend(Expr &&expr)const noexcept{
+            using View = MatrixView<const Type,Row,Col,RowStride,ColStride>;
+            using Operand = expression_operand_t<Expr>;
+            if constexpr (dir == Direction::right){
+                return ExtendExpression<true,View,Operand>(View(m_data),std::forward<Expr>(expr));
+            }else if constexpr (dir == Direction::left){
+                return ExtendExpression<true,Operand,View>(std::forward<Expr>(expr),View(m_data));
+            }else if constexpr (dir == Direction::up){
+                return ExtendExpression<false,Operand,View>(std::forward<Expr>(expr),View(m_data));
+            }else{
+                return ExtendExpression<false,View,Operand>(View(m_data),std::forward<Expr>(expr));
+            }
+        }
+
+        ///true if the elements spanned by the view overlap [first,last), always while constant-evaluated
+        constexpr bool aliases(const void *first,const void *last)const noexcept{
+            if(std::is_constant_evaluated()){
+                return true;
+            }
+            const void *const beg = m_data;
+            const void *const end = m_data + (Row - 1) * RowStride + (Col - 1) * ColStride + 1;
+            return std::less<const void *>()(beg,last) && std::less<const void *>()(first,end);
+        }
+
+        constexpr Matrix<value_type,Row,Col> eval()const noexcept{
+            return Matrix<value_type,Row,Col>(*this);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const MatrixView &view){
+            return os << view.eval();
+        }
+    private:
+        template <class Expr>
+        constexpr void assign(const Expr &expr)noexcept{
+            static_assert(!std::is_const<Type>::value,"A view of const elements can not be assigned to");
+            if constexpr (is_contiguous){
+                detail::evaluate<Count>(m_data,expr);
+            }else if constexpr (ColStride == 1){
+                //row by row, each row is contiguous
+                for(size_t i = 0;i < Row;++i){
+                    detail::evaluate<Col>(m_data + i * RowStride,detail::OffsetExpression<Expr>(expr,i * Col));
+                }
+            }else{
+                detail::unroll<Count>([&](auto i){
+                    (*this)[i] = expr[i];
+                });
+            }
+        }
+
+        Type *m_data;
+    };
+
+    namespace detail{
+        template <class Type,size_t Row,size_t Col,size_t RowStride,size_t ColStride,size_t Count>
+        struct packet_lanes<MatrixView<Type,Row,Col,RowStride,ColStride>,Count>
+            : std::integral_constant<size_t,MatrixView<Type,Row,Col,RowStride,ColStride>::is_contiguous ? Count
+                                            : ColStride == 1 ? Col : 1>{};
+    }
+
+    template <class Type1,class Type2,size_t Row,size_t Col,size_t Col2,
+              size_t RowStride1,size_t ColStride1,size_t RowStride2,size_t ColStride2>
+    constexpr auto operator%(const MatrixView<Type1,Row,Col,RowStride1,ColStride1> &lhs,
+                             const MatrixView<Type2,Col,Col2,RowStride2,ColStride2> &rhs)noexcept
+    -> std::enable_if_t<std::is_same<std::remove_const_t<Type1>,std::remove_const_t<Type2>>::value,
+                        Matrix<std::remove_const_t<Type1>,Row,Col2>>{
+        using Type = std::remove_const_t<Type1>;
+        Matrix<Type,Row,Col2> res(no_init);
+        detail::product<Type,Row,Col,Col2,RowStride1,ColStride1,RowStride2,ColStride2>(lhs.data(),rhs.data(),res.data());
+        return res;
+    }
+    template <class Type1,class Type,size_t Row,size_t Col,size_t Col2,size_t RowStride,size_t ColStride>
+    constexpr auto operator%(const MatrixView<Type1,Row,Col,RowStride,ColStride> &lhs,const Matrix<Type,Col,Col2> &rhs)noexcept{
+        return lhs % rhs.view();
+    }
+    template <class Type,class Type2,size_t Row,size_t Col,size_t Col2,size_t RowStride,size_t ColStride>
+    constexpr auto operator%(const Matrix<Type,Row,Col> &lhs,const MatrixView<Type2,Col,Col2,RowStride,ColStride> &rhs)noexcept{
+        return lhs.view() % rhs;
+    }
+
     using Matrix2x2f = Matrix<float,2,2>;
     using Matrix2x3f = Matrix<float,2,3>;
     using Matrix2x4f = Matrix<float,2,4>;
@@ -0,0 +1,339 @@
+#ifndef _XMATH_MATRIXBATCH_H_
+#define _XMATH_MATRIXBATCH_H_
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Matrix.h"
+#include "Aligned.h"
+
+namespace xmath{
+    namespace detail{
+        /**@name batchDet
+         * @note the determinant of the N x N row-major a, element-wise on Packets (one matrix per lane)
+         */
+        template <size_t N,class P>
+        P batchDet(const P *a)noexcept{
+            if constexpr (N == 1){
+                return a[0];
+            }else if constexpr (N == 2){
+                return a[0] * a[3] - a[2] * a[1];
+            }else if constexpr (N == 3){
+                return a[0] * (a[4] * a[8] - a[5] * a[7])
+                     - a[1] * (a[3] * a[8] - a[5] * a[6])
+                     + a[2] * (a[3] * a[7] - a[4] * a[6]);
+            }else{
+                static_assert(N == 4,"batchDet is closed form up to 4x4");
+                const P s0 = a[0] * a[5] - a[4] * a[1],s1 = a[0] * a[6] - a[4] * a[2];
+                const P s2 = a[0] * a[7] - a[4] * a[3],s3 = a[1] * a[6] - a[5] * a[2];
+                const P s4 = a[1] * a[7] - a[5] * a[3],s5 = a[2] * a[7] - a[6] * a[3];
+                const P c5 = a[10] * a[15] - a[14] * a[11],c4 = a[9] * a[15] - a[13] * a[11];
+                const P c3 = a[9] * a[14] - a[13] * a[10],c2 = a[8] * a[15] - a[12] * a[11];
+                const P c1 = a[8] * a[14] - a[12] * a[10],c0 = a[8] * a[13] - a[12] * a[9];
+                return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            }
+        }
+
+        /**@name batchAdjugate
+         * @note adj = the adjugate of the N x N row-major a (inverse * det), element-wise on Packets
+         * @return the determinant of a
+         */
+        template <size_t N,class P>
+        P batchAdjugate(const P *a,P *adj)noexcept{
+            if constexpr (N == 1){
+                adj[0] = P::broadcast(1);
+                return a[0];
+            }else if constexpr (N == 2){
+                adj[0] = a[3];
+                adj[1] = -a[1];
+                adj[2] = -a[2];
+                adj[3] = a[0];
+                return a[0] * a[3] - a[2] * a[1];
+            }else if constexpr (N == 3){
+                adj[0] = a[4] * a[8] - a[5] * a[7];
+                adj[1] = a[2] * a[7] - a[1] * a[8];
+                adj[2] = a[1] * a[5] - a[2] * a[4];
+                adj[3] = a[5] * a[6] - a[3] * a[8];
+                adj[4] = a[0] * a[8] - a[2] * a[6];
+                adj[5] = a[2] * a[3] - a[0] * a[5];
+                adj[6] = a[3] * a[7] - a[4] * a[6];
+                adj[7] = a[1] * a[6] - a[0] * a[7];
+                adj[8] = a[0] * a[4] - a[1] * a[3];
+                return a[0] * adj[0] + a[1] * adj[3] + a[2] * adj[6];
+            }else{
+                static_assert(N == 4,"batchAdjugate is closed form up to 4x4");
+                //the 12 shared 2x2 sub-determinants, as inverse4x4Scalar
+                const P s0 = a[0] * a[5] - a[4] * a[1],s1 = a[0] * a[6] - a[4] * a[2];
+                const P s2 = a[0] * a[7] - a[4] * a[3],s3 = a[1] * a[6] - a[5] * a[2];
+                const P s4 = a[1] * a[7] - a[5] * a[3],s5 = a[2] * a[7] - a[6] * a[3];
+                const P c5 = a[10] * a[15] - a[14] * a[11],c4 = a[9] * a[15] - a[13] * a[11];
+                const P c3 = a[9] * a[14] - a[13] * a[10],c2 = a[8] * a[15] - a[12] * a[11];
+                const P c1 = a[8] * a[14] - a[12] * a[10],c0 = a[8] * a[13] - a[12] * a[9];
+                adj[0]  = a[5] * c5 - a[6] * c4 + a[7] * c3;
+                adj[1]  = a[2] * c4 - a[1] * c5 - a[3] * c3;
+                adj[2]  = a[13] * s5 - a[14] * s4 + a[15] * s3;
+                adj[3]  = a[10] * s4 - a[9] * s5 - a[11] * s3;
+                adj[4]  = a[6] * c2 - a[4] * c5 - a[7] * c1;
+                adj[5]  = a[0] * c5 - a[2] * c2 + a[3] * c1;
+                adj[6]  = a[14] * s2 - a[12] * s5 - a[15] * s1;
+                adj[7]  = a[8] * s5 - a[10] * s2 + a[11] * s1;
+                adj[8]  = a[4] * c4 - a[5] * c2 + a[7] * c0;
+                adj[9]  = a[1] * c2 - a[0] * c4 - a[3] * c0;
+                adj[10] = a[12] * s4 - a[13] * s2 + a[15] * s0;
+                adj[11] = a[9] * s2 - a[8] * s4 - a[11] * s0;
+                adj[12] = a[5] * c1 - a[4] * c3 - a[6] * c0;
+                adj[13] = a[0] * c3 - a[1] * c1 + a[2] * c0;
+                adj[14] = a[13] * s1 - a[12] * s3 - a[14] * s0;
+                adj[15] = a[8] * s3 - a[9] * s1 + a[10] * s0;
+                return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            }
+        }
+    }
+
+    /**@name MatrixBatch
+     * @note an array-of-structures-of-arrays container of Matrix<Type,Row,Col>:
+     *       matrices are grouped in blocks of lanes (the width of the widest Packet for Type),
+     *       a block stores element (r,c) of its lanes matrices contiguously, then element (r,c + 1), ...
+     * @note the batched operations below run one matrix per Packet lane, so every instruction
+     *       advances lanes independent matrices and no lane is wasted on a 3x3
+     * @note the storage is padded to whole blocks, the padding lanes are computed and ignored
+     * @note every batched operation writing into a res argument accepts res == *this
+     */
+    template <class Type,size_t Row,size_t Col>
+    class MatrixBatch{
+    public:
+        static_assert(std::is_floating_point<Type>::value,"MatrixBatch holds float or double matrices");
+
+        using value_type = Type;
+        using matrix_type = Matrix<Type,Row,Col>;
+        using packet_type = detail::widest_packet_t<Type>;
+
+        ///matrices per block
+        static constexpr size_t lanes = packet_type::size;
+        ///values per block
+        static constexpr size_t block_size = Row * Col * lanes;
+
+        MatrixBatch() = default;
+        explicit MatrixBatch(size_t size){
+            resize(size);
+        }
+        template <class Iterator>
+        MatrixBatch(Iterator beg,Iterator end){
+            for(;beg != end;++beg){
+                push_back(*beg);
+            }
+        }
+        MatrixBatch(const MatrixBatch &) = default;
+        MatrixBatch(MatrixBatch &&) noexcept = default;
+        ~MatrixBatch() = default;
+
+        MatrixBatch &operator=(const MatrixBatch &) = default;
+        MatrixBatch &operator=(MatrixBatch &&) noexcept = default;
+
+        size_t size()const noexcept{
+            return m_size;
+        }
+        bool empty()const noexcept{
+            return m_size == 0;
+        }
+        ///the number of blocks holding size() matrices
+        size_t blocks()const noexcept{
+            return (m_size + lanes - 1) / lanes;
+        }
+        void resize(size_t size){
+            m_data.resize((size + lanes - 1) / lanes * block_size);
+            m_size = size;
+        }
+        void reserve(size_t size){
+            m_data.reserve((size + lanes - 1) / lanes * block_size);
+        }
+        void clear()noexcept{
+            m_data.clear();
+            m_size = 0;
+        }
+
+        void push_back(const matrix_type &mat){
+            resize(m_size + 1);
+            set(m_size - 1,mat);
+        }
+
+        matrix_type get(size_t index)const noexcept{
+            matrix_type res(no_init);
+            const Type *ptr = m_data.data() + index / lanes * block_size + index % lanes;
+            for(size_t i = 0;i < Row * Col;++i){
+                res[i] = ptr[i * lanes];
+            }
+            return res;
+        }
+        void set(size_t index,const matrix_type &mat)noexcept{
+            Type *ptr = m_data.data() + index / lanes * block_size + index % lanes;
+            for(size_t i = 0;i < Row * Col;++i){
+                ptr[i * lanes] = mat[i];
+            }
+        }
+
+        ///block b: element (r,c) of matrix b * lanes + l is at data()[b * block_size + (r * Col + c) * lanes + l]
+        Type *data()noexcept{
+            return m_data.data();
+        }
+        const Type *data()const noexcept{
+            return m_data.data();
+        }
+
+        ///res[i] = get(i).transpose()
+        void transpose(MatrixBatch<Type,Col,Row> &res)const{
+            res.resize(size());
+            for(size_t b = 0;b < blocks();++b){
+                packet_type a[Row * Col];
+                load(b,a);
+                for(size_t r = 0;r < Row;++r){
+                    for(size_t c = 0;c < Col;++c){
+                        a[r * Col + c].store(res.data() + b * block_size + (c * Row + r) * lanes);
+                    }
+                }
+            }
+        }
+        MatrixBatch<Type,Col,Row> transpose()const{
+            MatrixBatch<Type,Col,Row> res;
+            transpose(res);
+            return res;
+        }
+
+        ///res[i] = get(i) % batch.get(i) for i < min(size(),batch.size())
+        template <size_t Col2>
+        void multiply(const MatrixBatch<Type,Col,Col2> &batch,MatrixBatch<Type,Row,Col2> &res)const{
+            const size_t n = std::min(size(),batch.size());
+            res.resize(n);
+            for(size_t b = 0;b < res.blocks();++b){
+                //both blocks are read before any result is written, so res may be either operand
+                packet_type lhs[Row * Col],rhs[Col * Col2];
+                load(b,lhs);
+                batch.load(b,rhs);
+                Type *out = res.data() + b * Row * Col2 * lanes;
+                for(size_t i = 0;i < Row;++i){
+                    for(size_t j = 0;j < Col2;++j){
+                        packet_type acc = lhs[i * Col] * rhs[j];
+                        for(size_t k = 1;k < Col;++k){
+                            acc = madd(lhs[i * Col + k],rhs[k * Col2 + j],acc);
+                        }
+                        acc.store(out + (i * Col2 + j) * lanes);
+                    }
+                }
+            }
+        }
+
+        template <size_t Col2>
+        MatrixBatch<Type,Row,Col2> operator%(const MatrixBatch<Type,Col,Col2> &batch)const{
+            MatrixBatch<Type,Row,Col2> res;
+            multiply(batch,res);
+            return res;
+        }
+
+        ///res[i] = get(i).det() for i < size(), closed forms up to 4x4
+        template <size_t Row2 = Row,size_t Col2 = Col>
+        auto det(Type *res)const noexcept
+        -> std::enable_if_t<Row2 == Col2 && (Row2 <= 4)>{
+            for(size_t b = 0;b < blocks();++b){
+                packet_type a[Row * Col];
+                load(b,a);
+                storeLanes(detail::batchDet<Row>(a),res,b);
+            }
+        }
+        template <size_t Row2 = Row,size_t Col2 = Col>
+        auto det()const
+        -> std::enable_if_t<Row2 == Col2 && (Row2 <= 4),std::vector<Type>>{
+            std::vector<Type> res(size());
+            det(res.data());
+            return res;
+        }
+
+        /**@name inverse
+         * @note res[i] = get(i).inverse() for i < size(), from the adjugate up to 4x4
+         * @note like Matrix::inverse() a singular matrix (|det| <= Row * eps * max|a_ij|^Row) gives a zero matrix
+         * @param invertible if not null, invertible[i] is set to whether matrix i is invertible
+         */
+        template <size_t Row2 = Row,size_t Col2 = Col>
+        auto inverse(MatrixBatch &res,bool *invertible = nullptr)const
+        -> std::enable_if_t<Row2 == Col2 && (Row2 <= 4)>{
+            using P = packet_type;
+            res.resize(size());
+            const P one = P::broadcast(1);
+            const P eps = P::broadcast(Row * std::numeric_limits<Type>::epsilon());
+            for(size_t b = 0;b < blocks();++b){
+                P a[Row * Col],adj[Row * Col];
+                load(b,a);
+                const P d = detail::batchAdjugate<Row>(a,adj);
+                P scale = max(a[0],-a[0]);
+                for(size_t i = 1;i < Row * Col;++i){
+                    scale = max(scale,max(a[i],-a[i]));
+                }
+                P tolerance = eps;
+                for(size_t i = 0;i < Row;++i){
+                    tolerance = tolerance * scale;
+                }
+                const unsigned singular = cmpge(tolerance,max(d,-d));
+                P inv_det;
+                if(singular == 0){
+                    inv_det = one / d;
+                }else{
+                    //singular lanes divide by one and scale the adjugate by zero
+                    Type keep[lanes];
+                    for(size_t l = 0;l < lanes;++l){
+                        keep[l] = (singular >> l) & 1u ? Type(0) : Type(1);
+                    }
+                    const P mask = P::load(keep);
+                    inv_det = mask / madd(d,mask,one - mask);
+                }
+                for(size_t i = 0;i < Row * Col;++i){
+                    (adj[i] * inv_det).store(res.data() + b * block_size + i * lanes);
+                }
+                if(invertible != nullptr){
+                    const size_t count = std::min(lanes,size() - b * lanes);
+                    for(size_t l = 0;l < count;++l){
+                        invertible[b * lanes + l] = ((singular >> l) & 1u) == 0;
+                    }
+                }
+            }
+        }
+        template <size_t Row2 = Row,size_t Col2 = Col>
+        auto inverse()const
+        -> std::enable_if_t<Row2 == Col2 && (Row2 <= 4),MatrixBatch>{
+            MatrixBatch res;
+            inverse(res);
+            return res;
+        }
+
+    private:
+        template <class,size_t,size_t>
+        friend class MatrixBatch;
+
+        ///the Row * Col element Packets of block b
+        void load(size_t b,packet_type *a)const noexcept{
+            const Type *ptr = m_data.data() + b * block_size;
+            for(size_t i = 0;i < Row * Col;++i){
+                a[i] = packet_type::load(ptr + i * lanes);
+            }
+        }
+        ///res[b * lanes + l] = value[l] for the lanes of block b below size()
+        void storeLanes(const packet_type &value,Type *res,size_t b)const noexcept{
+            if((b + 1) * lanes <= m_size){
+                value.store(res + b * lanes);
+                return;
+            }
+            Type tmp[lanes];
+            value.store(tmp);
+            std::copy(tmp,tmp + (m_size - b * lanes),res + b * lanes);
+        }
+
+        std::vector<Type,AlignedAllocator<Type>> m_data;
+        size_t m_size = 0;
+    };
+
+    using MatrixBatch3f = MatrixBatch<float,3,3>;
+    using MatrixBatch4f = MatrixBatch<float,4,4>;
+    using MatrixBatch3d = MatrixBatch<double,3,3>;
+    using MatrixBatch4d = MatrixBatch<double,4,4>;
+}
+
+#endif //_XMATH_MATRIXBATCH_H_
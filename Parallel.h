@@ -0,0 +1,83 @@
+#ifndef _XMATH_PARALLEL_H_
+#define _XMATH_PARALLEL_H_
+
+#include "ThreadPool.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "DynamicMatrix.h"
+
+namespace xmath{
+    /**@name parallelTransform
+     * @note out[i] = mat % in[i] for i < n, spread over pool
+     * @note in and out may be the same array
+     * @note Type and Count come from in/out, mat may be an AffineMatrix or a structured 4x4
+     */
+    template <class Type,size_t Count>
+    void parallelTransform(const std::type_identity_t<Matrix<Type,Count,Count>> &mat,
+                           const Vector<Type,Count> *in,Vector<Type,Count> *out,size_t n,
+                           ThreadPool &pool = ThreadPool::global()){
+        pool.parallelFor(0,n,[&](size_t beg,size_t end){
+            for(size_t i = beg;i < end;++i){
+                out[i] = mat % in[i];
+            }
+        });
+    }
+
+    /**@name parallelProduct
+     * @note out[i] = lhs[i] % rhs[i] for i < n, spread over pool
+     */
+    template <class Type,size_t Row,size_t Col,size_t Col2>
+    void parallelProduct(const Matrix<Type,Row,Col> *lhs,const Matrix<Type,Col,Col2> *rhs,
+                         Matrix<Type,Row,Col2> *out,size_t n,
+                         ThreadPool &pool = ThreadPool::global()){
+        pool.parallelFor(0,n,[&](size_t beg,size_t end){
+            for(size_t i = beg;i < end;++i){
+                out[i] = lhs[i] % rhs[i];
+            }
+        });
+    }
+    ///out[i] = lhs % rhs[i] for i < n, e.g. one view-projection against many model matrices
+    template <class Type,size_t Row,size_t Col,size_t Col2>
+    void parallelProduct(const std::type_identity_t<Matrix<Type,Row,Col>> &lhs,const Matrix<Type,Col,Col2> *rhs,
+                         Matrix<Type,Row,Col2> *out,size_t n,
+                         ThreadPool &pool = ThreadPool::global()){
+        pool.parallelFor(0,n,[&](size_t beg,size_t end){
+            for(size_t i = beg;i < end;++i){
+                out[i] = lhs % rhs[i];
+            }
+        });
+    }
+
+    /**@name parallelProduct
+     * @note lhs % rhs for large dynamic matrices, the rows of the result are handed out
+     *       in blocks of 64 and every block runs the blocked gemm on its own
+     * @note returns an empty matrix if the dimensions do not match, like operator%
+     */
+    template <class Type>
+    DynamicMatrix<Type> parallelProduct(DynamicMatrixView<const Type> lhs,DynamicMatrixView<const Type> rhs,
+                                        ThreadPool &pool = ThreadPool::global()){
+        if(lhs.getColCount() != rhs.getRowCount()){
+            return DynamicMatrix<Type>();
+        }
+        constexpr size_t Block = 64;
+        const size_t m = lhs.getRowCount();
+        const size_t n = rhs.getColCount();
+        DynamicMatrix<Type> res(m,n);
+        pool.parallelFor(0,(m + Block - 1) / Block,1,[&](size_t beg,size_t end){
+            const size_t row = beg * Block;
+            const size_t rows = std::min(end * Block,m) - row;
+            detail::gemm<Type>(rows,n,lhs.getColCount(),
+                               lhs.data() + row * lhs.getStride(),lhs.getStride(),
+                               rhs.data(),rhs.getStride(),
+                               res.data() + row * n,n);
+        });
+        return res;
+    }
+    template <class Type>
+    DynamicMatrix<Type> parallelProduct(const DynamicMatrix<Type> &lhs,const DynamicMatrix<Type> &rhs,
+                                        ThreadPool &pool = ThreadPool::global()){
+        return parallelProduct<Type>(lhs.view(),rhs.view(),pool);
+    }
+}
+
+#endif //_XMATH_PARALLEL_H_
@@ -4,19 +4,78 @@
 #include "Vector.h"
 
 namespace xmath{
+    enum class Interpolation{
+        exact,
+        fast
+    };
+
+    template <class Type>
+    class Quaternion;
+
+    ///element-wise arithmetic on a Quaternion yields a Vector<Type,4>
+    template <class Type>
+    struct expression_traits<Quaternion<Type>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = true;
+        static constexpr bool is_scalar = false;
+        using value_type = Type;
+        using result_type = Vector<Type,4>;
+    };
+
     template <class Type>
     class Quaternion : public Vector<Type,4>{
     public:
-        Quaternion():Vector<Type,4>(){}
-        explicit Quaternion(Type val):Vector<Type,4>(val){}
-        explicit Quaternion(const Type *ptr):Vector<Type,4>(ptr){}
-        explicit Quaternion(std::initializer_list<Type> list):Vector<Type,4>(list){}
-        explicit Quaternion(const Matrix<Type,4,4> &mat)
-            :Vector<Type,4>(){
-            (*this)[3] = std::sqrt(1.0 + mat(0,0) + mat(1,1) + mat(2,2))/2.0;
-            (*this)[0] = (mat(2,1) - mat(1,2)) / (*this)[3] / 4.0;
-            (*this)[1] = (mat(0,2) - mat(2,0)) / (*this)[3] / 4.0;
-            (*this)[2] = (mat(1,0) - mat(0,1)) / (*this)[3] / 4.0;
+        constexpr Quaternion():Vector<Type,4>(){}
+        constexpr explicit Quaternion(no_init_t)noexcept:Vector<Type,4>(no_init){}
+        constexpr explicit Quaternion(Type val):Vector<Type,4>(val){}
+        constexpr explicit Quaternion(const Type *ptr):Vector<Type,4>(ptr){}
+        constexpr explicit Quaternion(std::initializer_list<Type> list):Vector<Type,4>(list){}
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,Vector<Type,4>>>>
+        constexpr explicit Quaternion(const Expr &expr):Vector<Type,4>(expr){}
+        constexpr explicit Quaternion(const Vector<Type,4> &vec):Vector<Type,4>(vec){}
+        /**@name Quaternion
+         * @note from the rotation in the upper 3x3 of mat,
+         *       divides by the largest of |x|,|y|,|z|,|w| so 180 degree turns stay finite
+         */
+        constexpr explicit Quaternion(const Matrix<Type,4,4> &mat)
+            :Vector<Type,4>(no_init){
+            const auto trace = mat(0,0) + mat(1,1) + mat(2,2);
+            if(trace > 0){
+                (*this)[3] = detail::sqrt(1.0 + trace)/2.0;
+                (*this)[0] = (mat(2,1) - mat(1,2)) / (*this)[3] / 4.0;
+                (*this)[1] = (mat(0,2) - mat(2,0)) / (*this)[3] / 4.0;
+                (*this)[2] = (mat(1,0) - mat(0,1)) / (*this)[3] / 4.0;
+            }else if(mat(0,0) >= mat(1,1) && mat(0,0) >= mat(2,2)){
+                (*this)[0] = detail::sqrt(1.0 + mat(0,0) - mat(1,1) - mat(2,2))/2.0;
+                (*this)[1] = (mat(0,1) + mat(1,0)) / (*this)[0] / 4.0;
+                (*this)[2] = (mat(0,2) + mat(2,0)) / (*this)[0] / 4.0;
+                (*this)[3] = (mat(2,1) - mat(1,2)) / (*this)[0] / 4.0;
+            }else if(mat(1,1) >= mat(2,2)){
+                (*this)[1] = detail::sqrt(1.0 - mat(0,0) + mat(1,1) - mat(2,2))/2.0;
+                (*this)[0] = (mat(0,1) + mat(1,0)) / (*this)[1] / 4.0;
+                (*this)[2] = (mat(1,2) + mat(2,1)) / (*this)[1] / 4.0;
+                (*this)[3] = (mat(0,2) - mat(2,0)) / (*this)[1] / 4.0;
+            }else{
+                (*this)[2] = detail::sqrt(1.0 - mat(0,0) - mat(1,1) + mat(2,2))/2.0;
+                (*this)[0] = (mat(0,2) + mat(2,0)) / (*this)[2] / 4.0;
+                (*this)[1] = (mat(1,2) + mat(2,1)) / (*this)[2] / 4.0;
+                (*this)[3] = (mat(1,0) - mat(0,1)) / (*this)[2] / 4.0;
+            }
+        }
+        ///from Euler angles [x,y,z] in radians, the same rotation as angles.rotate<order>()
+        constexpr Quaternion(const Vector<Type,3> &angles,EulerOrder order)
+            :Vector<Type,4>(no_init){
+            const Type sx = detail::sin(angles[0] / 2),sy = detail::sin(angles[1] / 2),sz = detail::sin(angles[2] / 2);
+            const Type cx = detail::cos(angles[0] / 2),cy = detail::cos(angles[1] / 2),cz = detail::cos(angles[2] / 2);
+            Type *res = this->data();
+            switch(order){
+                case EulerOrder::xyz:detail::eulerQuaternion<EulerOrder::xyz>(sx,sy,sz,cx,cy,cz,res);break;
+                case EulerOrder::xzy:detail::eulerQuaternion<EulerOrder::xzy>(sx,sy,sz,cx,cy,cz,res);break;
+                case EulerOrder::yxz:detail::eulerQuaternion<EulerOrder::yxz>(sx,sy,sz,cx,cy,cz,res);break;
+                case EulerOrder::yzx:detail::eulerQuaternion<EulerOrder::yzx>(sx,sy,sz,cx,cy,cz,res);break;
+                case EulerOrder::zxy:detail::eulerQuaternion<EulerOrder::zxy>(sx,sy,sz,cx,cy,cz,res);break;
+                case EulerOrder::zyx:detail::eulerQuaternion<EulerOrder::zyx>(sx,sy,sz,cx,cy,cz,res);break;
+            }
         }
         Quaternion(const Quaternion &vec) = default;
         Quaternion(Quaternion &&) = default;
@@ -25,39 +84,123 @@ namespace xmath{
         Quaternion &operator=(const Quaternion &mat) = default;
         Quaternion &operator=(Quaternion &&) noexcept = default;
 
-        Quaternion cross(const Quaternion &qut)const noexcept{
-            return Quaternion{
-                    (*this)[3] * qut[0] + (*this)[0] * qut[3] + (*this)[1] * qut[2] - (*this)[2] * qut[1],
-                    (*this)[3] * qut[1] + (*this)[1] * qut[3] + (*this)[2] * qut[0] - (*this)[0] * qut[2],
-                    (*this)[3] * qut[2] + (*this)[2] * qut[3] + (*this)[0] * qut[1] - (*this)[1] * qut[0],
-                    (*this)[3] * qut[3] - (*this)[0] * qut[0] - (*this)[1] * qut[1] - (*this)[2] * qut[2]
-            };
+        constexpr Quaternion cross(const Quaternion &qut)const noexcept{
+            Quaternion res(no_init);
+            res[0] = (*this)[3] * qut[0] + (*this)[0] * qut[3] + (*this)[1] * qut[2] - (*this)[2] * qut[1];
+            res[1] = (*this)[3] * qut[1] + (*this)[1] * qut[3] + (*this)[2] * qut[0] - (*this)[0] * qut[2];
+            res[2] = (*this)[3] * qut[2] + (*this)[2] * qut[3] + (*this)[0] * qut[1] - (*this)[1] * qut[0];
+            res[3] = (*this)[3] * qut[3] - (*this)[0] * qut[0] - (*this)[1] * qut[1] - (*this)[2] * qut[2];
+            return res;
+        }
+
+        ///*this = cross(qut) in place
+        constexpr Quaternion &operator%=(const Quaternion &qut)noexcept{
+            const Type x = (*this)[0],y = (*this)[1],z = (*this)[2],w = (*this)[3];
+            (*this)[0] = w * qut[0] + x * qut[3] + y * qut[2] - z * qut[1];
+            (*this)[1] = w * qut[1] + y * qut[3] + z * qut[0] - x * qut[2];
+            (*this)[2] = w * qut[2] + z * qut[3] + x * qut[1] - y * qut[0];
+            (*this)[3] = w * qut[3] - x * qut[0] - y * qut[1] - z * qut[2];
+            return *this;
         }
 
-        Quaternion conjugate()const noexcept{
-            return Quaternion{-(*this)[0],-(*this)[1],-(*this)[2],(*this)[3]};
+        constexpr Quaternion conjugate()const noexcept{
+            Quaternion res(no_init);
+            res[0] = -(*this)[0];
+            res[1] = -(*this)[1];
+            res[2] = -(*this)[2];
+            res[3] = (*this)[3];
+            return res;
         }
 
-        Quaternion inverse()const noexcept{
+        constexpr Quaternion inverse()const noexcept{
             return Quaternion(conjugate() / this->length());
         }
 
-        Quaternion normalize()const noexcept{
-            return Quaternion(this->operator/(this->length()));
+        constexpr Quaternion normalize()const noexcept{
+            return Quaternion(*this / this->length());
+        }
+
+        /**@name rotate
+         * @note rotates vec by this unit quaternion as vec + w * t + q.xyz x t with t = 2 * (q.xyz x vec),
+         *       the same rotation rotate() builds a matrix for, in 15 multiply-adds
+         */
+        constexpr Vector<Type,3> rotate(const Vector<Type,3> &vec)const noexcept{
+            const Type x = (*this)[0],y = (*this)[1],z = (*this)[2],w = (*this)[3];
+            const Type tx = 2 * (y * vec[2] - z * vec[1]);
+            const Type ty = 2 * (z * vec[0] - x * vec[2]);
+            const Type tz = 2 * (x * vec[1] - y * vec[0]);
+            Vector<Type,3> res(no_init);
+            res[0] = vec[0] + w * tx + (y * tz - z * ty);
+            res[1] = vec[1] + w * ty + (z * tx - x * tz);
+            res[2] = vec[2] + w * tz + (x * ty - y * tx);
+            return res;
+        }
+
+        /**@name nlerp
+         * @note normalize((1 - t) * this + t * to) along the shorter arc,
+         *       not constant speed but close for small angles
+         */
+        constexpr Quaternion nlerp(const Quaternion &to,Type t)const noexcept{
+            const Type from_w = 1 - t;
+            const Type to_w = this->dot(to) < 0 ? -t : t;
+            Quaternion res(no_init);
+            for(size_t i = 0;i < 4;++i){
+                res[i] = from_w * (*this)[i] + to_w * to[i];
+            }
+            return res.normalize();
         }
 
-        Matrix<Type,4,4> rotate()const noexcept{
+        /**@name slerp
+         * @note spherical linear interpolation between unit quaternions along the shorter arc
+         * @tparam mode Interpolation::exact follows the arc at constant angular speed,
+         *              Interpolation::fast is nlerp with t corrected by a polynomial fit
+         *              (A. Kapoulkine, "Approximating slerp"), no trigonometry
+         */
+        template <Interpolation mode = Interpolation::exact>
+        constexpr Quaternion slerp(const Quaternion &to,Type t)const noexcept{
+            const Type d = this->dot(to);
+            if constexpr (mode == Interpolation::fast){
+                const Type a = detail::abs(d);
+                const Type k1 = Type(1.0904) + a * (Type(-3.2452) + a * (Type(3.5479) + a * Type(-1.4354)));
+                const Type k2 = Type(0.848) + a * (Type(-1.06) + a * Type(0.215));
+                const Type k = k1 * (t - Type(0.5)) * (t - Type(0.5)) + k2;
+                return nlerp(to,t + t * (t - Type(0.5)) * (t - 1) * k);
+            }else{
+                const Type cos_theta = detail::abs(d);
+                if(cos_theta > 1 - XMATH_EPS){
+                    return nlerp(to,t);
+                }
+                const Type theta = detail::acos(cos_theta);
+                const Type inv_sin = 1 / detail::sin(theta);
+                const Type from_w = detail::sin((1 - t) * theta) * inv_sin;
+                const Type to_w = (d < 0 ? -1 : 1) * detail::sin(t * theta) * inv_sin;
+                Quaternion res(no_init);
+                for(size_t i = 0;i < 4;++i){
+                    res[i] = from_w * (*this)[i] + to_w * to[i];
+                }
+                return res;
+            }
+        }
+
+        constexpr RotationMatrix<Type> rotate()const noexcept{
             Type x = (*this)[0];
             Type y = (*this)[1];
             Type z = (*this)[2];
             Type w = (*this)[3];
-            return Matrix<Type,4,4>{
-                1.0-2.0*y*y-2.0*z*z,2.0*x*y-2.0*z*w,2.0*x*z+2.0*y*w,0.0,
-                2.0*x*y+2.0*z*w,1.0-2.0*x*x-2.0*z*z,2.0*y*z-2.0*x*w,0.0,
-                2.0*x*z-2.0*y*w,2.0*y*z+2.0*x*w,1.0-2.0*x*x-2.0*y*y,0.0,
-                0.0,0.0,0.0,1.0
+            return RotationMatrix<Type>{
+                1-2*y*y-2*z*z,2*x*y-2*z*w,2*x*z+2*y*w,
+                2*x*y+2*z*w,1-2*x*x-2*z*z,2*y*z-2*x*w,
+                2*x*z-2*y*w,2*y*z+2*x*w,1-2*x*x-2*y*y
             };
         }
+
+        ///composition, lhs % rhs applies rhs first (same as lhs.cross(rhs))
+        friend constexpr Quaternion operator%(const Quaternion &lhs,const Quaternion &rhs)noexcept{
+            return lhs.cross(rhs);
+        }
+        friend constexpr Vector<Type,3> operator%(const Quaternion &qut,const Vector<Type,3> &vec)noexcept{
+            return qut.rotate(vec);
+        }
     protected:
     private:
     };
@@ -0,0 +1,825 @@
+#ifndef _XMATH_SIMD_H_
+#define _XMATH_SIMD_H_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE__) || defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#if !defined(XMATH_UNROLL_LIMIT)
+#define XMATH_UNROLL_LIMIT 64
+#endif
+
+namespace xmath{
+    namespace detail{
+        /**@name Packet
+         * @note Size lanes of Type processed by one instruction
+         * @note Packet<Type,1> is the scalar fallback used for every Type/target
+         *       without a vector unit (including NEON builds)
+         * @note which packets exist is decided at compile time from the target macros
+         *       (__SSE__,__SSE2__,__AVX__,__AVX512F__,__FMA__)
+         */
+        template <class Type,size_t Size>
+        struct Packet;
+
+        /**@name promote_type
+         * @note the type arithmetic on stored Type values is carried out in,
+         *       storage-only types (half,bfloat16) specialise it to float
+         */
+        template <class Type>
+        struct promote_type{
+            using type = Type;
+        };
+        template <class Type>
+        using promote_t = typename promote_type<Type>::type;
+
+        template <class Type,size_t Size>
+        struct has_packet : std::false_type{};
+
+        template <class Type>
+        struct Packet<Type,1>{
+            using value_type = promote_t<Type>;
+            static constexpr size_t size = 1;
+            value_type value;
+
+            static Packet load(const Type *ptr)noexcept{
+                return Packet{static_cast<value_type>(*ptr)};
+            }
+            static Packet broadcast(const Type &value)noexcept{
+                return Packet{static_cast<value_type>(value)};
+            }
+            void store(Type *ptr)const noexcept{
+                *ptr = static_cast<Type>(value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{static_cast<value_type>(lhs.value + rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{static_cast<value_type>(lhs.value - rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{static_cast<value_type>(lhs.value * rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{static_cast<value_type>(lhs.value / rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+                return Packet{static_cast<value_type>(-packet.value)};
+            }
+            ///a * b + c
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+                return Packet{static_cast<value_type>(a.value * b.value + c.value)};
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{static_cast<value_type>(std::sqrt(packet.value))};
+            }
+            ///lhs < rhs ? lhs : rhs, like minps
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{lhs.value < rhs.value ? lhs.value : rhs.value};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{lhs.value > rhs.value ? lhs.value : rhs.value};
+            }
+            ///bit i set where lhs[i] >= rhs[i] (false for NaN)
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return lhs.value >= rhs.value ? 1u : 0u;
+            }
+        };
+        template <class Type>
+        struct has_packet<Type,1> : std::true_type{};
+
+#if defined(__SSE__)
+        template <>
+        struct Packet<float,4>{
+            static constexpr size_t size = 4;
+            __m128 value;
+
+            static Packet load(const float *ptr)noexcept{
+                return Packet{_mm_loadu_ps(ptr)};
+            }
+            static Packet broadcast(float value)noexcept{
+                return Packet{_mm_set1_ps(value)};
+            }
+            void store(float *ptr)const noexcept{
+                _mm_storeu_ps(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_add_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_sub_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_mul_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_div_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+                return Packet{_mm_xor_ps(packet.value,_mm_set1_ps(-0.0f))};
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm_sqrt_ps(packet.value)};
+            }
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_min_ps(lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_max_ps(lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpge_ps(lhs.value,rhs.value)));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+#if defined(__FMA__)
+                return Packet{_mm_fmadd_ps(a.value,b.value,c.value)};
+#else
+                return Packet{_mm_add_ps(_mm_mul_ps(a.value,b.value),c.value)};
+#endif
+            }
+        };
+        template <>
+        struct has_packet<float,4> : std::true_type{};
+#endif
+
+#if defined(__SSE2__)
+        template <>
+        struct Packet<double,2>{
+            static constexpr size_t size = 2;
+            __m128d value;
+
+            static Packet load(const double *ptr)noexcept{
+                return Packet{_mm_loadu_pd(ptr)};
+            }
+            static Packet broadcast(double value)noexcept{
+                return Packet{_mm_set1_pd(value)};
+            }
+            void store(double *ptr)const noexcept{
+                _mm_storeu_pd(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_add_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_sub_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_mul_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_div_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+                return Packet{_mm_xor_pd(packet.value,_mm_set1_pd(-0.0))};
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm_sqrt_pd(packet.value)};
+            }
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_min_pd(lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm_max_pd(lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpge_pd(lhs.value,rhs.value)));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+#if defined(__FMA__)
+                return Packet{_mm_fmadd_pd(a.value,b.value,c.value)};
+#else
+                return Packet{_mm_add_pd(_mm_mul_pd(a.value,b.value),c.value)};
+#endif
+            }
+        };
+        template <>
+        struct has_packet<double,2> : std::true_type{};
+#endif
+
+#if defined(__AVX__)
+        template <>
+        struct Packet<float,8>{
+            static constexpr size_t size = 8;
+            __m256 value;
+
+            static Packet load(const float *ptr)noexcept{
+                return Packet{_mm256_loadu_ps(ptr)};
+            }
+            static Packet broadcast(float value)noexcept{
+                return Packet{_mm256_set1_ps(value)};
+            }
+            void store(float *ptr)const noexcept{
+                _mm256_storeu_ps(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_add_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_sub_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_mul_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_div_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+                return Packet{_mm256_xor_ps(packet.value,_mm256_set1_ps(-0.0f))};
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm256_sqrt_ps(packet.value)};
+            }
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_min_ps(lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_max_ps(lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(lhs.value,rhs.value,_CMP_GE_OQ)));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+#if defined(__FMA__)
+                return Packet{_mm256_fmadd_ps(a.value,b.value,c.value)};
+#else
+                return Packet{_mm256_add_ps(_mm256_mul_ps(a.value,b.value),c.value)};
+#endif
+            }
+        };
+        template <>
+        struct has_packet<float,8> : std::true_type{};
+
+        template <>
+        struct Packet<double,4>{
+            static constexpr size_t size = 4;
+            __m256d value;
+
+            static Packet load(const double *ptr)noexcept{
+                return Packet{_mm256_loadu_pd(ptr)};
+            }
+            static Packet broadcast(double value)noexcept{
+                return Packet{_mm256_set1_pd(value)};
+            }
+            void store(double *ptr)const noexcept{
+                _mm256_storeu_pd(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_add_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_sub_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_mul_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_div_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+                return Packet{_mm256_xor_pd(packet.value,_mm256_set1_pd(-0.0))};
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm256_sqrt_pd(packet.value)};
+            }
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_min_pd(lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm256_max_pd(lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(lhs.value,rhs.value,_CMP_GE_OQ)));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+#if defined(__FMA__)
+                return Packet{_mm256_fmadd_pd(a.value,b.value,c.value)};
+#else
+                return Packet{_mm256_add_pd(_mm256_mul_pd(a.value,b.value),c.value)};
+#endif
+            }
+        };
+        template <>
+        struct has_packet<double,4> : std::true_type{};
+#endif
+
+#if defined(__AVX512F__)
+        template <>
+        struct Packet<float,16>{
+            static constexpr size_t size = 16;
+            __m512 value;
+
+            static Packet load(const float *ptr)noexcept{
+                return Packet{_mm512_loadu_ps(ptr)};
+            }
+            static Packet broadcast(float value)noexcept{
+                return Packet{_mm512_set1_ps(value)};
+            }
+            void store(float *ptr)const noexcept{
+                _mm512_storeu_ps(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_add_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_sub_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mul_ps(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_div_ps(lhs.value,rhs.value)};
+            }
+            ///flips the sign bit like the SSE/AVX packets, so -(+0) is -0 (xor_ps needs AVX512DQ)
+            friend Packet operator-(const Packet &packet)noexcept{
+#if defined(__AVX512DQ__)
+                return Packet{_mm512_xor_ps(packet.value,_mm512_set1_ps(-0.0f))};
+#else
+                return Packet{_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(packet.value),
+                                                                   _mm512_castps_si512(_mm512_set1_ps(-0.0f))))};
+#endif
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm512_sqrt_ps(packet.value)};
+            }
+            //the masked form with every lane set, the plain one reads _mm512_undefined_ps() and trips -Wuninitialized on gcc 12
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mask_min_ps(lhs.value,static_cast<__mmask16>(-1),lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mask_max_ps(lhs.value,static_cast<__mmask16>(-1),lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm512_cmp_ps_mask(lhs.value,rhs.value,_CMP_GE_OQ));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+                return Packet{_mm512_fmadd_ps(a.value,b.value,c.value)};
+            }
+        };
+        template <>
+        struct has_packet<float,16> : std::true_type{};
+
+        template <>
+        struct Packet<double,8>{
+            static constexpr size_t size = 8;
+            __m512d value;
+
+            static Packet load(const double *ptr)noexcept{
+                return Packet{_mm512_loadu_pd(ptr)};
+            }
+            static Packet broadcast(double value)noexcept{
+                return Packet{_mm512_set1_pd(value)};
+            }
+            void store(double *ptr)const noexcept{
+                _mm512_storeu_pd(ptr,value);
+            }
+
+            friend Packet operator+(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_add_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_sub_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator*(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mul_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator/(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_div_pd(lhs.value,rhs.value)};
+            }
+            friend Packet operator-(const Packet &packet)noexcept{
+#if defined(__AVX512DQ__)
+                return Packet{_mm512_xor_pd(packet.value,_mm512_set1_pd(-0.0))};
+#else
+                return Packet{_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(packet.value),
+                                                                   _mm512_castpd_si512(_mm512_set1_pd(-0.0))))};
+#endif
+            }
+            friend Packet sqrt(const Packet &packet)noexcept{
+                return Packet{_mm512_sqrt_pd(packet.value)};
+            }
+            friend Packet min(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mask_min_pd(lhs.value,static_cast<__mmask8>(-1),lhs.value,rhs.value)};
+            }
+            friend Packet max(const Packet &lhs,const Packet &rhs)noexcept{
+                return Packet{_mm512_mask_max_pd(lhs.value,static_cast<__mmask8>(-1),lhs.value,rhs.value)};
+            }
+            friend unsigned cmpge(const Packet &lhs,const Packet &rhs)noexcept{
+                return static_cast<unsigned>(_mm512_cmp_pd_mask(lhs.value,rhs.value,_CMP_GE_OQ));
+            }
+            friend Packet madd(const Packet &a,const Packet &b,const Packet &c)noexcept{
+                return Packet{_mm512_fmadd_pd(a.value,b.value,c.value)};
+            }
+        };
+        template <>
+        struct has_packet<double,8> : std::true_type{};
+#endif
+
+        /**@name packet_for
+         * @note the widest available Packet whose lane count divides Count
+         */
+        template <class Type,size_t Count,size_t Size = 16>
+        struct packet_for{
+            using type = std::conditional_t<has_packet<Type,Size>::value && Count % Size == 0,
+                    Packet<Type,Size>,
+                    typename packet_for<Type,Count,Size / 2>::type>;
+        };
+        template <class Type,size_t Count>
+        struct packet_for<Type,Count,1>{
+            using type = Packet<Type,1>;
+        };
+        template <class Type,size_t Count>
+        using packet_for_t = typename packet_for<Type,Count>::type;
+
+        ///the widest Packet available for Type
+        template <class Type>
+        using widest_packet_t = packet_for_t<Type,16>;
+
+        template <class P>
+        struct packet_tag{
+            using type = P;
+        };
+
+        template <class Func,size_t... I>
+        constexpr void unrollSequence(Func &func,std::index_sequence<I...>){
+            (func(std::integral_constant<size_t,I>{}),...);
+        }
+
+        /**@name unroll
+         * @note calls func(i) for i in [0,N): as straight-line code with i a std::integral_constant
+         *       if Cost <= XMATH_UNROLL_LIMIT, as a plain loop over a size_t i above it
+         * @note Cost is the work of the whole loop nest the call stands for, N unless given
+         */
+        template <size_t N,size_t Cost = N,class Func>
+        constexpr void unroll(Func &&func){
+            if constexpr (Cost <= XMATH_UNROLL_LIMIT){
+                unrollSequence(func,std::make_index_sequence<N>{});
+            }else{
+                for(size_t i = 0;i < N;++i){
+                    func(i);
+                }
+            }
+        }
+        /**@name unrollGrid
+         * @note calls func(i,j) over a Row x Col grid row by row: straight-line code if Cost <= XMATH_UNROLL_LIMIT,
+         *       otherwise a loop over the rows, each row still unrolled if its share Cost / Row fits
+         * @note Cost is the work of the whole grid, Row * Col unless given
+         */
+        template <size_t Row,size_t Col,size_t Cost = Row * Col,class Func>
+        constexpr void unrollGrid(Func &&func){
+            unroll<Row,Cost>([&](auto i){
+                unroll<Col,Cost / Row>([&](auto j){
+                    func(i,j);
+                });
+            });
+        }
+
+        /**@name packetFor
+         * @note calls kernel(packet_tag<P>,index) over [0,size), a widest_packet_t
+         *       at a time and Packet<Type,1> for the tail
+         */
+        template <class Type,class Kernel>
+        void packetFor(size_t size,Kernel &&kernel){
+            using P = widest_packet_t<Type>;
+            size_t i = 0;
+            for(;i + P::size <= size;i += P::size){
+                kernel(packet_tag<P>{},i);
+            }
+            for(;i < size;++i){
+                kernel(packet_tag<Packet<Type,1>>{},i);
+            }
+        }
+
+        /**@name product
+         * @note res = lhs(Row x Col) % rhs(Col x Col2), res is row-major
+         * @note element (i,j) of lhs is lhs[i * LhsRow + j * LhsCol] and likewise for rhs,
+         *       the defaults are plain row-major storage, other strides come from MatrixView
+         * @note each packet of a result row is accumulated in a register,
+         *       res is written exactly once and never read
+         */
+        template <class Type,size_t Row,size_t Col,size_t Col2,
+                  size_t LhsRow = Col,size_t LhsCol = 1,size_t RhsRow = Col2,size_t RhsCol = 1>
+        constexpr void product(const Type *lhs,const Type *rhs,Type *res)noexcept{
+            //a packet needs a row of rhs to be contiguous
+            if(RhsCol != 1 || std::is_constant_evaluated()){
+                unrollGrid<Row,Col2,Row * Col2 * Col>([&](auto i,auto j){
+                    promote_t<Type> acc = lhs[i * LhsRow] * rhs[j * RhsCol];
+                    unroll<Col - 1>([&](auto k){
+                        acc += lhs[i * LhsRow + (k + 1) * LhsCol] * rhs[(k + 1) * RhsRow + j * RhsCol];
+                    });
+                    res[i * Col2 + j] = static_cast<Type>(acc);
+                });
+                return;
+            }
+            using P = packet_for_t<Type,Col2>;
+            constexpr size_t Packets = Col2 / P::size;
+            unrollGrid<Row,Packets,Row * Packets * Col>([&](auto i,auto packet){
+                const size_t j = packet * P::size;
+                auto acc = P::broadcast(lhs[i * LhsRow]) * P::load(rhs + j);
+                unroll<Col - 1>([&](auto k){
+                    acc = madd(P::broadcast(lhs[i * LhsRow + (k + 1) * LhsCol]),P::load(rhs + (k + 1) * RhsRow + j),acc);
+                });
+                acc.store(res + i * Col2 + j);
+            });
+        }
+
+        /**@name scalar kernels
+         * @note the portable forms of the kernels below, also what every specialisation
+         *       runs while constant-evaluated since intrinsics are not constexpr
+         */
+        template <class Type,size_t Count>
+        constexpr void transformScalar(const Type *mat,const Type *vec,Type *res)noexcept{
+            unroll<Count,Count * Count>([&](auto i){
+                promote_t<Type> acc = mat[i * Count] * vec[0];
+                unroll<Count - 1>([&](auto j){
+                    acc += mat[i * Count + j + 1] * vec[j + 1];
+                });
+                res[i] = static_cast<Type>(acc);
+            });
+        }
+        template <class Type,size_t Row,size_t Col>
+        constexpr void transposeScalar(const Type *src,Type *dst)noexcept{
+            unrollGrid<Row,Col>([&](auto i,auto j){
+                dst[j * Row + i] = src[i * Col + j];
+            });
+        }
+
+        /**@name TransformKernel
+         * @note res = mat(Count x Count) % vec
+         */
+        template <class Type,size_t Count>
+        struct TransformKernel{
+            static constexpr void run(const Type *mat,const Type *vec,Type *res)noexcept{
+                transformScalar<Type,Count>(mat,vec,res);
+            }
+        };
+
+        /**@name TransposeKernel
+         * @note dst(Col x Row) = transpose(src(Row x Col))
+         */
+        template <class Type,size_t Row,size_t Col>
+        struct TransposeKernel{
+            static constexpr void run(const Type *src,Type *dst)noexcept{
+                transposeScalar<Type,Row,Col>(src,dst);
+            }
+        };
+
+        /**@name minors4x4
+         * @note the six 2x2 sub-determinants of rows 0,1 (s) and of rows 2,3 (c) of the row-major src
+         *       in promote_t<Type>, shared by det() and inverse4x4Scalar
+         * @return the determinant, s0 c5 - s1 c4 + s2 c3 + s3 c2 - s4 c1 + s5 c0
+         */
+        template <class Type>
+        constexpr promote_t<Type> minors4x4(const Type *src,promote_t<Type> *s,promote_t<Type> *c)noexcept{
+            using Compute = promote_t<Type>;
+            const auto at = [src](size_t i){
+                return static_cast<Compute>(src[i]);
+            };
+            s[0] = at(0) * at(5) - at(4) * at(1);
+            s[1] = at(0) * at(6) - at(4) * at(2);
+            s[2] = at(0) * at(7) - at(4) * at(3);
+            s[3] = at(1) * at(6) - at(5) * at(2);
+            s[4] = at(1) * at(7) - at(5) * at(3);
+            s[5] = at(2) * at(7) - at(6) * at(3);
+
+            c[5] = at(10) * at(15) - at(14) * at(11);
+            c[4] = at(9) * at(15) - at(13) * at(11);
+            c[3] = at(9) * at(14) - at(13) * at(10);
+            c[2] = at(8) * at(15) - at(12) * at(11);
+            c[1] = at(8) * at(14) - at(12) * at(10);
+            c[0] = at(8) * at(13) - at(12) * at(9);
+            return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        }
+
+        /**@name inverse4x4Scalar
+         * @note dst = inverse(src) from the 12 shared 2x2 sub-determinants,
+         *       computed in promote_t<Type> and rounded to Type once
+         * @return the determinant of src, dst is only meaningful if it is not zero
+         */
+        template <class Type>
+        constexpr promote_t<Type> inverse4x4Scalar(const Type *src,Type *dst)noexcept{
+            using Compute = promote_t<Type>;
+            const Compute a00 = src[0], a01 = src[1], a02 = src[2], a03 = src[3];
+            const Compute a10 = src[4], a11 = src[5], a12 = src[6], a13 = src[7];
+            const Compute a20 = src[8], a21 = src[9], a22 = src[10],a23 = src[11];
+            const Compute a30 = src[12],a31 = src[13],a32 = src[14],a33 = src[15];
+
+            Compute s[6],c[6];
+            const Compute det = minors4x4(src,s,c);
+            if(det == Compute(0)){
+                return det;
+            }
+
+            dst[0]  = static_cast<Type>(( a11 * c[5] - a12 * c[4] + a13 * c[3]) / det);
+            dst[1]  = static_cast<Type>((-a01 * c[5] + a02 * c[4] - a03 * c[3]) / det);
+            dst[2]  = static_cast<Type>(( a31 * s[5] - a32 * s[4] + a33 * s[3]) / det);
+            dst[3]  = static_cast<Type>((-a21 * s[5] + a22 * s[4] - a23 * s[3]) / det);
+            dst[4]  = static_cast<Type>((-a10 * c[5] + a12 * c[2] - a13 * c[1]) / det);
+            dst[5]  = static_cast<Type>(( a00 * c[5] - a02 * c[2] + a03 * c[1]) / det);
+            dst[6]  = static_cast<Type>((-a30 * s[5] + a32 * s[2] - a33 * s[1]) / det);
+            dst[7]  = static_cast<Type>(( a20 * s[5] - a22 * s[2] + a23 * s[1]) / det);
+            dst[8]  = static_cast<Type>(( a10 * c[4] - a11 * c[2] + a13 * c[0]) / det);
+            dst[9]  = static_cast<Type>((-a00 * c[4] + a01 * c[2] - a03 * c[0]) / det);
+            dst[10] = static_cast<Type>(( a30 * s[4] - a31 * s[2] + a33 * s[0]) / det);
+            dst[11] = static_cast<Type>((-a20 * s[4] + a21 * s[2] - a23 * s[0]) / det);
+            dst[12] = static_cast<Type>((-a10 * c[3] + a11 * c[1] - a12 * c[0]) / det);
+            dst[13] = static_cast<Type>(( a00 * c[3] - a01 * c[1] + a02 * c[0]) / det);
+            dst[14] = static_cast<Type>((-a30 * s[3] + a31 * s[1] - a32 * s[0]) / det);
+            dst[15] = static_cast<Type>(( a20 * s[3] - a21 * s[1] + a22 * s[0]) / det);
+            return det;
+        }
+
+        template <class Type>
+        struct Inverse4x4Kernel{
+            static constexpr promote_t<Type> run(const Type *src,Type *dst)noexcept{
+                return inverse4x4Scalar(src,dst);
+            }
+        };
+
+#if defined(__SSE__)
+        template <>
+        struct TransformKernel<float,4>{
+            static constexpr void run(const float *mat,const float *vec,float *res)noexcept{
+                if(std::is_constant_evaluated()){
+                    return transformScalar<float,4>(mat,vec,res);
+                }
+                __m128 c0 = _mm_loadu_ps(mat);
+                __m128 c1 = _mm_loadu_ps(mat + 4);
+                __m128 c2 = _mm_loadu_ps(mat + 8);
+                __m128 c3 = _mm_loadu_ps(mat + 12);
+                _MM_TRANSPOSE4_PS(c0,c1,c2,c3);
+                auto acc = Packet<float,4>{c0} * Packet<float,4>::broadcast(vec[0]);
+                acc = madd(Packet<float,4>{c1},Packet<float,4>::broadcast(vec[1]),acc);
+                acc = madd(Packet<float,4>{c2},Packet<float,4>::broadcast(vec[2]),acc);
+                acc = madd(Packet<float,4>{c3},Packet<float,4>::broadcast(vec[3]),acc);
+                acc.store(res);
+            }
+        };
+
+        template <>
+        struct TransposeKernel<float,4,4>{
+            static constexpr void run(const float *src,float *dst)noexcept{
+                if(std::is_constant_evaluated()){
+                    return transposeScalar<float,4,4>(src,dst);
+                }
+                __m128 r0 = _mm_loadu_ps(src);
+                __m128 r1 = _mm_loadu_ps(src + 4);
+                __m128 r2 = _mm_loadu_ps(src + 8);
+                __m128 r3 = _mm_loadu_ps(src + 12);
+                _MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+                _mm_storeu_ps(dst,r0);
+                _mm_storeu_ps(dst + 4,r1);
+                _mm_storeu_ps(dst + 8,r2);
+                _mm_storeu_ps(dst + 12,r3);
+            }
+        };
+
+        /**@name Inverse4x4Kernel<float>
+         * @note block-wise inverse: the 4x4 is split into the 2x2 blocks | A B |
+         *                                                                 | C D |
+         *       each held in one __m128, and the inverse is assembled from
+         *       their adjugates (X#) and determinants (|X|)
+         */
+        template <>
+        struct Inverse4x4Kernel<float>{
+            template <int X,int Y,int Z,int W>
+            static __m128 swizzle(__m128 vec)noexcept{
+                return _mm_shuffle_ps(vec,vec,_MM_SHUFFLE(W,Z,Y,X));
+            }
+            template <int X,int Y,int Z,int W>
+            static __m128 shuffle(__m128 vec1,__m128 vec2)noexcept{
+                return _mm_shuffle_ps(vec1,vec2,_MM_SHUFFLE(W,Z,Y,X));
+            }
+            ///A * B
+            static __m128 mul2(__m128 a,__m128 b)noexcept{
+                return _mm_add_ps(_mm_mul_ps(a,swizzle<0,3,0,3>(b)),
+                                  _mm_mul_ps(swizzle<1,0,3,2>(a),swizzle<2,1,2,1>(b)));
+            }
+            ///A# * B
+            static __m128 adjMul2(__m128 a,__m128 b)noexcept{
+                return _mm_sub_ps(_mm_mul_ps(swizzle<3,3,0,0>(a),b),
+                                  _mm_mul_ps(swizzle<1,1,2,2>(a),swizzle<2,3,0,1>(b)));
+            }
+            ///A * B#
+            static __m128 mulAdj2(__m128 a,__m128 b)noexcept{
+                return _mm_sub_ps(_mm_mul_ps(a,swizzle<3,0,3,0>(b)),
+                                  _mm_mul_ps(swizzle<1,0,3,2>(a),swizzle<2,1,2,1>(b)));
+            }
+
+            static constexpr float run(const float *src,float *dst)noexcept{
+                if(std::is_constant_evaluated()){
+                    return inverse4x4Scalar(src,dst);
+                }
+                const __m128 r0 = _mm_loadu_ps(src);
+                const __m128 r1 = _mm_loadu_ps(src + 4);
+                const __m128 r2 = _mm_loadu_ps(src + 8);
+                const __m128 r3 = _mm_loadu_ps(src + 12);
+
+                const __m128 a = _mm_movelh_ps(r0,r1);
+                const __m128 b = _mm_movehl_ps(r1,r0);
+                const __m128 c = _mm_movelh_ps(r2,r3);
+                const __m128 d = _mm_movehl_ps(r3,r2);
+
+                //(|A|,|B|,|C|,|D|)
+                const __m128 det_sub = _mm_sub_ps(
+                        _mm_mul_ps(shuffle<0,2,0,2>(r0,r2),shuffle<1,3,1,3>(r1,r3)),
+                        _mm_mul_ps(shuffle<1,3,1,3>(r0,r2),shuffle<0,2,0,2>(r1,r3)));
+                const __m128 det_a = swizzle<0,0,0,0>(det_sub);
+                const __m128 det_b = swizzle<1,1,1,1>(det_sub);
+                const __m128 det_c = swizzle<2,2,2,2>(det_sub);
+                const __m128 det_d = swizzle<3,3,3,3>(det_sub);
+
+                const __m128 d_c = adjMul2(d,c);
+                const __m128 a_b = adjMul2(a,b);
+                __m128 x = _mm_sub_ps(_mm_mul_ps(det_d,a),mul2(b,d_c));
+                __m128 w = _mm_sub_ps(_mm_mul_ps(det_a,d),mul2(c,a_b));
+                __m128 y = _mm_sub_ps(_mm_mul_ps(det_b,c),mulAdj2(d,a_b));
+                __m128 z = _mm_sub_ps(_mm_mul_ps(det_c,b),mulAdj2(a,d_c));
+
+                //|M| = |A||D| + |B||C| - tr((A#B)(D#C))
+                __m128 tr = _mm_mul_ps(a_b,swizzle<0,2,1,3>(d_c));
+                tr = _mm_add_ps(tr,_mm_movehl_ps(tr,tr));
+                tr = _mm_add_ss(tr,swizzle<1,1,1,1>(tr));
+                __m128 det = _mm_sub_ss(_mm_add_ss(_mm_mul_ss(det_a,det_d),_mm_mul_ss(det_b,det_c)),tr);
+                const float res = _mm_cvtss_f32(det);
+                if(res == 0.0f){
+                    return res;
+                }
+                det = swizzle<0,0,0,0>(det);
+
+                const __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f,-1.0f,-1.0f,1.0f),det);
+                x = _mm_mul_ps(x,inv_det);
+                y = _mm_mul_ps(y,inv_det);
+                z = _mm_mul_ps(z,inv_det);
+                w = _mm_mul_ps(w,inv_det);
+
+                _mm_storeu_ps(dst,shuffle<3,1,3,1>(x,y));
+                _mm_storeu_ps(dst + 4,shuffle<2,0,2,0>(x,y));
+                _mm_storeu_ps(dst + 8,shuffle<3,1,3,1>(z,w));
+                _mm_storeu_ps(dst + 12,shuffle<2,0,2,0>(z,w));
+                return res;
+            }
+        };
+#endif
+
+#if defined(__AVX__)
+        inline void transpose4(__m256d &r0,__m256d &r1,__m256d &r2,__m256d &r3)noexcept{
+            __m256d t0 = _mm256_unpacklo_pd(r0,r1);
+            __m256d t1 = _mm256_unpackhi_pd(r0,r1);
+            __m256d t2 = _mm256_unpacklo_pd(r2,r3);
+            __m256d t3 = _mm256_unpackhi_pd(r2,r3);
+            r0 = _mm256_permute2f128_pd(t0,t2,0x20);
+            r1 = _mm256_permute2f128_pd(t1,t3,0x20);
+            r2 = _mm256_permute2f128_pd(t0,t2,0x31);
+            r3 = _mm256_permute2f128_pd(t1,t3,0x31);
+        }
+
+        template <>
+        struct TransformKernel<double,4>{
+            static constexpr void run(const double *mat,const double *vec,double *res)noexcept{
+                if(std::is_constant_evaluated()){
+                    return transformScalar<double,4>(mat,vec,res);
+                }
+                __m256d c0 = _mm256_loadu_pd(mat);
+                __m256d c1 = _mm256_loadu_pd(mat + 4);
+                __m256d c2 = _mm256_loadu_pd(mat + 8);
+                __m256d c3 = _mm256_loadu_pd(mat + 12);
+                transpose4(c0,c1,c2,c3);
+                auto acc = Packet<double,4>{c0} * Packet<double,4>::broadcast(vec[0]);
+                acc = madd(Packet<double,4>{c1},Packet<double,4>::broadcast(vec[1]),acc);
+                acc = madd(Packet<double,4>{c2},Packet<double,4>::broadcast(vec[2]),acc);
+                acc = madd(Packet<double,4>{c3},Packet<double,4>::broadcast(vec[3]),acc);
+                acc.store(res);
+            }
+        };
+
+        template <>
+        struct TransposeKernel<double,4,4>{
+            static constexpr void run(const double *src,double *dst)noexcept{
+                if(std::is_constant_evaluated()){
+                    return transposeScalar<double,4,4>(src,dst);
+                }
+                __m256d r0 = _mm256_loadu_pd(src);
+                __m256d r1 = _mm256_loadu_pd(src + 4);
+                __m256d r2 = _mm256_loadu_pd(src + 8);
+                __m256d r3 = _mm256_loadu_pd(src + 12);
+                transpose4(r0,r1,r2,r3);
+                _mm256_storeu_pd(dst,r0);
+                _mm256_storeu_pd(dst + 4,r1);
+                _mm256_storeu_pd(dst + 8,r2);
+                _mm256_storeu_pd(dst + 12,r3);
+            }
+        };
+#endif
+    }
+}
+
+#endif //_XMATH_SIMD_H_
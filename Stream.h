@@ -0,0 +1,331 @@
+#ifndef _XMATH_STREAM_H_
+#define _XMATH_STREAM_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+#include "Aligned.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if !defined(XMATH_STREAM_CHUNK)
+#define XMATH_STREAM_CHUNK 16384
+#endif
+
+namespace xmath{
+    enum class StreamError{
+        none,
+        open,       ///<the input could not be opened or the output created
+        read,       ///<a read failed
+        write,      ///<a write failed, e.g. the disk is full
+        truncated   ///<the input ended inside a record, every whole record before it was processed
+    };
+
+    namespace detail{
+        ///reads until bytes are in or the input ends, returns the bytes read or -1
+        inline ptrdiff_t readFull(int fd,void *data,size_t bytes)noexcept{
+            auto *ptr = static_cast<char *>(data);
+            size_t done = 0;
+            while(done < bytes){
+#if defined(_WIN32)
+                const int res = ::_read(fd,ptr + done,static_cast<unsigned>(std::min<size_t>(bytes - done,1u << 30)));
+#else
+                const ssize_t res = ::read(fd,ptr + done,bytes - done);
+                if(res < 0 && errno == EINTR){
+                    continue;
+                }
+#endif
+                if(res < 0){
+                    return -1;
+                }
+                if(res == 0){
+                    break;
+                }
+                done += static_cast<size_t>(res);
+            }
+            return static_cast<ptrdiff_t>(done);
+        }
+        inline bool writeFull(int fd,const void *data,size_t bytes)noexcept{
+            const auto *ptr = static_cast<const char *>(data);
+            while(bytes > 0){
+#if defined(_WIN32)
+                const int res = ::_write(fd,ptr,static_cast<unsigned>(std::min<size_t>(bytes,1u << 30)));
+#else
+                const ssize_t res = ::write(fd,ptr,bytes);
+                if(res < 0 && errno == EINTR){
+                    continue;
+                }
+#endif
+                if(res <= 0){
+                    return false;
+                }
+                ptr += res;
+                bytes -= static_cast<size_t>(res);
+            }
+            return true;
+        }
+
+        inline int openRead(const char *path)noexcept{
+#if defined(_WIN32)
+            return ::_open(path,_O_RDONLY | _O_BINARY);
+#else
+            return ::open(path,O_RDONLY);
+#endif
+        }
+        inline int openWrite(const char *path)noexcept{
+#if defined(_WIN32)
+            return ::_open(path,_O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,_S_IREAD | _S_IWRITE);
+#else
+            return ::open(path,O_WRONLY | O_CREAT | O_TRUNC,0644);
+#endif
+        }
+        inline bool closeFile(int fd)noexcept{
+#if defined(_WIN32)
+            return ::_close(fd) == 0;
+#else
+            return ::close(fd) == 0;
+#endif
+        }
+    }
+
+    /**@name transformPoints
+     * @note out[i] = mat % [x,y,z,1] for Vector<Type,3>, the last row of mat is ignored (affine),
+     *       out[i] = mat % in[i] for Vector<Type,4>
+     * @note in and out may be the same array
+     */
+    template <class Type>
+    void transformPoints(const AffineMatrix<Type> &mat,const Vector<Type,3> *in,Vector<Type,3> *out,size_t n)noexcept{
+        //the 12 coefficients in registers, one multiply-add chain per component
+        const Type m00 = mat(0,0),m01 = mat(0,1),m02 = mat(0,2),m03 = mat(0,3);
+        const Type m10 = mat(1,0),m11 = mat(1,1),m12 = mat(1,2),m13 = mat(1,3);
+        const Type m20 = mat(2,0),m21 = mat(2,1),m22 = mat(2,2),m23 = mat(2,3);
+        for(size_t i = 0;i < n;++i){
+            const Type x = in[i][0],y = in[i][1],z = in[i][2];
+            out[i][0] = m00 * x + m01 * y + m02 * z + m03;
+            out[i][1] = m10 * x + m11 * y + m12 * z + m13;
+            out[i][2] = m20 * x + m21 * y + m22 * z + m23;
+        }
+    }
+    template <class Type>
+    void transformPoints(const std::type_identity_t<Matrix<Type,4,4>> &mat,const Vector<Type,3> *in,Vector<Type,3> *out,size_t n)noexcept{
+        transformPoints(AffineMatrix<Type>(mat),in,out,n);
+    }
+    template <class Type>
+    void transformPoints(const std::type_identity_t<Matrix<Type,4,4>> &mat,const Vector<Type,4> *in,Vector<Type,4> *out,size_t n)noexcept{
+        for(size_t i = 0;i < n;++i){
+            out[i] = mat % in[i];
+        }
+    }
+
+    /**@name StreamPipeline
+     * @note streams In records from a file descriptor through kernel(const In *in,Out *out,size_t n)
+     *       into another one, chunk records at a time, without ever holding more than two chunks
+     * @note reads, compute and writes overlap: a background I/O thread writes chunk k and reads chunk k + 2
+     *       while the calling thread runs the kernel on chunk k + 1 (double buffering on both sides),
+     *       so the memory used is 2 * chunk * (sizeof(In) + sizeof(Out)) whatever the input size
+     * @note records are raw bytes in the machine's layout, the input is read from the current position
+     *       of in_fd, e.g. lseek past the BinaryHeader of an XMath binary file first
+     * @note the buffers are allocated once by the constructor and reused by every run()
+     */
+    template <class In,class Out = In>
+    class StreamPipeline{
+    public:
+        static_assert(std::is_trivially_copyable_v<In> && std::is_trivially_copyable_v<Out>,"records are streamed as raw bytes");
+
+        explicit StreamPipeline(size_t chunk = XMATH_STREAM_CHUNK)
+            :m_chunk(chunk == 0 ? 1 : chunk){
+            for(size_t i = 0;i < 2;++i){
+                m_in[i].resize(m_chunk);
+                m_out[i].resize(m_chunk);
+            }
+        }
+        StreamPipeline(const StreamPipeline &) = delete;
+        StreamPipeline &operator=(const StreamPipeline &) = delete;
+
+        ///records per chunk
+        size_t chunkSize()const noexcept{
+            return m_chunk;
+        }
+        ///records written by the last run()
+        size_t processed()const noexcept{
+            return m_processed;
+        }
+
+        /**@name run
+         * @note returns once the input is exhausted and every output record is written,
+         *       or at the first read/write error; an exception thrown by kernel stops the I/O thread and is rethrown
+         */
+        template <class Kernel>
+        StreamError run(int in_fd,int out_fd,Kernel &&kernel){
+            State state;
+            m_processed = 0;
+            std::thread io([&]{ioLoop(state,in_fd,out_fd);});
+            try{
+                for(size_t k = 0;;++k){
+                    size_t n;
+                    {
+                        std::unique_lock<std::mutex> lock(state.mutex);
+                        //chunk k is in and the output buffer chunk k - 2 used is written
+                        state.wake.wait(lock,[&]{
+                            return state.error != StreamError::none ||
+                                   ((state.read > k || state.end) && state.written + 2 > k);
+                        });
+                        if(state.error != StreamError::none || state.read == k){
+                            break;
+                        }
+                        n = state.sizes[k & 1];
+                    }
+                    kernel(static_cast<const In *>(m_in[k & 1].data()),m_out[k & 1].data(),n);
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        ++state.computed;
+                    }
+                    state.wake.notify_all();
+                }
+            }catch(...){
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.abort = true;
+                }
+                state.wake.notify_all();
+                io.join();
+                throw;
+            }
+            io.join();
+            return state.error != StreamError::none ? state.error : state.tail;
+        }
+        template <class Kernel>
+        StreamError run(const char *in_path,const char *out_path,Kernel &&kernel){
+            const int in_fd = detail::openRead(in_path);
+            if(in_fd < 0){
+                return StreamError::open;
+            }
+            const int out_fd = detail::openWrite(out_path);
+            if(out_fd < 0){
+                detail::closeFile(in_fd);
+                return StreamError::open;
+            }
+            StreamError res = run(in_fd,out_fd,std::forward<Kernel>(kernel));
+            detail::closeFile(in_fd);
+            if(!detail::closeFile(out_fd) && res == StreamError::none){
+                res = StreamError::write;
+            }
+            return res;
+        }
+    protected:
+    private:
+        ///shared by the calling thread and the I/O thread of one run(), guarded by mutex
+        struct State{
+            std::mutex mutex;
+            std::condition_variable wake;
+            size_t read = 0;        ///<chunks read (only non-empty ones count)
+            size_t computed = 0;    ///<chunks the kernel is done with
+            size_t written = 0;     ///<chunks written
+            size_t sizes[2] = {0,0};///<records in each input buffer
+            bool end = false;       ///<no chunk after the last one read
+            bool abort = false;     ///<the kernel threw
+            StreamError error = StreamError::none;
+            StreamError tail = StreamError::none;
+        };
+
+        ///reads chunk k into buffer k & 1, returns true if there may be more to read
+        bool fetch(State &state,int in_fd,size_t k){
+            const ptrdiff_t bytes = detail::readFull(in_fd,m_in[k & 1].data(),m_chunk * sizeof(In));
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if(bytes < 0){
+                    state.error = StreamError::read;
+                }else{
+                    const size_t n = static_cast<size_t>(bytes) / sizeof(In);
+                    if(static_cast<size_t>(bytes) % sizeof(In) != 0){
+                        state.tail = StreamError::truncated;
+                    }
+                    state.sizes[k & 1] = n;
+                    state.read += n > 0;
+                    state.end = n < m_chunk;
+                }
+            }
+            state.wake.notify_all();
+            return bytes >= 0 && static_cast<size_t>(bytes) == m_chunk * sizeof(In);
+        }
+
+        void ioLoop(State &state,int in_fd,int out_fd){
+            bool more = fetch(state,in_fd,0) && fetch(state,in_fd,1);
+            for(size_t w = 0;;++w){
+                size_t n;
+                {
+                    std::unique_lock<std::mutex> lock(state.mutex);
+                    state.wake.wait(lock,[&]{
+                        return state.abort || state.error != StreamError::none ||
+                               state.computed > w || (state.end && state.read == w);
+                    });
+                    if(state.abort || state.error != StreamError::none || state.computed <= w){
+                        return;
+                    }
+                    n = state.sizes[w & 1];
+                }
+                const bool ok = detail::writeFull(out_fd,m_out[w & 1].data(),n * sizeof(Out));
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    if(ok){
+                        ++state.written;
+                        m_processed += n;
+                    }else{
+                        state.error = StreamError::write;
+                    }
+                }
+                state.wake.notify_all();
+                if(!ok){
+                    return;
+                }
+                //the kernel is done with chunk w, its input buffer takes chunk w + 2
+                if(more){
+                    more = fetch(state,in_fd,w + 2);
+                }
+            }
+        }
+
+        size_t m_chunk;
+        std::vector<In,AlignedAllocator<In>> m_in[2];
+        std::vector<Out,AlignedAllocator<Out>> m_out[2];
+        size_t m_processed = 0;
+    };
+
+    /**@name streamTransform
+     * @note streams Vector<Type,3> or Vector<Type,4> records through transformPoints(mat),
+     *       e.g. streamTransform<Vector3f>("in.bin","out.bin",proj % view % model)
+     * @note Type comes from Record, so mat may be anything that converts to Matrix<Type,4,4>
+     *       (AffineMatrix, TranslationMatrix,...)
+     */
+    template <class Record,class Type = expression_value_t<Record>>
+    StreamError streamTransform(int in_fd,int out_fd,const std::type_identity_t<Matrix<Type,4,4>> &mat,size_t chunk = XMATH_STREAM_CHUNK){
+        StreamPipeline<Record> pipeline(chunk);
+        return pipeline.run(in_fd,out_fd,[&](const Record *in,Record *out,size_t n){
+            transformPoints(mat,in,out,n);
+        });
+    }
+    template <class Record,class Type = expression_value_t<Record>>
+    StreamError streamTransform(const char *in_path,const char *out_path,const std::type_identity_t<Matrix<Type,4,4>> &mat,size_t chunk = XMATH_STREAM_CHUNK){
+        StreamPipeline<Record> pipeline(chunk);
+        return pipeline.run(in_path,out_path,[&](const Record *in,Record *out,size_t n){
+            transformPoints(mat,in,out,n);
+        });
+    }
+}
+
+#endif //_XMATH_STREAM_H_
@@ -0,0 +1,482 @@
+#ifndef _XMATH_STRUCTURED_MATRIX_H_
+#define _XMATH_STRUCTURED_MATRIX_H_
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "AffineMatrix.h"
+
+namespace xmath{
+    template <class Type>
+    class TranslationMatrix;
+    template <class Type>
+    class DiagonalMatrix;
+    template <class Type>
+    class RotationMatrix;
+
+    namespace detail{
+        ///the 4x4 transforms of Type: Matrix<Type,4,4>, AffineMatrix and the structured shapes
+        template <class Type,class Mat>
+        struct is_transform_of : std::false_type{};
+        template <class Type>
+        struct is_transform_of<Type,Matrix<Type,4,4>> : std::true_type{};
+        template <class Type>
+        struct is_transform_of<Type,AffineMatrix<Type>> : std::true_type{};
+        template <class Type>
+        struct is_transform_of<Type,TranslationMatrix<Type>> : std::true_type{};
+        template <class Type>
+        struct is_transform_of<Type,DiagonalMatrix<Type>> : std::true_type{};
+        template <class Type>
+        struct is_transform_of<Type,RotationMatrix<Type>> : std::true_type{};
+        template <class Type,class Mat>
+        constexpr bool is_transform_of_v = is_transform_of<Type,Mat>::value;
+    }
+
+    /**@name structured matrices
+     * @note 4x4 affine matrices whose shape is part of the type, what the builders of Vector and Quaternion return:
+     *       TranslationMatrix (translate()) is | I t |, DiagonalMatrix (scale()) is | S 0 |,
+     *                                          | 0 1 |                           | 0 1 |
+     *       RotationMatrix (rotate()) is | R 0 | and IdentityMatrix is I
+     *                                    | 0 1 |
+     * @note only the varying part is stored and every % between them, with AffineMatrix, Matrix<Type,4,4>
+     *       and Vector is an overload picked at compile time that touches nothing else:
+     *       scale % point is 3 multiplies, translation % translation 3 adds, translation % rotation a copy
+     * @note a product of two different shapes is an AffineMatrix,
+     *       all of them convert implicitly to AffineMatrix and Matrix<Type,4,4>
+     * @note operator()(x,y) reads element (x,y) of the 4x4 and det() is that of the 4x4,
+     *       %= only exists where the shape is kept (T %= T, S %= S, R %= R),
+     *       accumulate mixed products in an AffineMatrix (e.g. 'AffineMatrixf m = t; m %= s;')
+     */
+    template <class Type>
+    class IdentityMatrix{
+    public:
+        using value_type = Type;
+
+        constexpr IdentityMatrix() = default;
+
+        constexpr Type operator()(size_t x,size_t y)const noexcept{
+            return Type(x == y);
+        }
+        constexpr detail::promote_t<Type> det()const noexcept{
+            return detail::promote_t<Type>(1);
+        }
+
+        constexpr IdentityMatrix inverse()const noexcept{
+            return *this;
+        }
+
+        constexpr AffineMatrix<Type> toAffine()const noexcept{
+            return AffineMatrix<Type>();
+        }
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            return Matrix<Type,4,4>().identity();
+        }
+        constexpr operator Matrix<Type,4,4>()const noexcept{
+            return toMatrix();
+        }
+
+        ///the other side unchanged: a 4x4 transform of Type on either side, a point or a Vector<Type,4> on the right
+        template <class Mat,class = std::enable_if_t<detail::is_transform_of_v<Type,Mat>
+                                                   || std::is_same_v<Mat,Vector<Type,3>> || std::is_same_v<Mat,Vector<Type,4>>>>
+        friend constexpr Mat operator%(const IdentityMatrix &,const Mat &mat)noexcept{
+            return mat;
+        }
+        template <class Mat,class = std::enable_if_t<detail::is_transform_of_v<Type,Mat>>>
+        friend constexpr Mat operator%(const Mat &mat,const IdentityMatrix &)noexcept{
+            return mat;
+        }
+        friend constexpr IdentityMatrix operator%(const IdentityMatrix &,const IdentityMatrix &)noexcept{
+            return IdentityMatrix();
+        }
+
+        constexpr bool operator==(const IdentityMatrix &)const noexcept{
+            return true;
+        }
+        constexpr bool operator!=(const IdentityMatrix &)const noexcept{
+            return false;
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const IdentityMatrix &mat){
+            return os << mat.toMatrix();
+        }
+    };
+
+    ///| I t |, the translation t
+    ///| 0 1 |
+    template <class Type>
+    class TranslationMatrix{
+    public:
+        using value_type = Type;
+
+        constexpr TranslationMatrix()
+            :m_translation(){}
+        constexpr explicit TranslationMatrix(const Vector<Type,3> &translation)
+            :m_translation(translation){}
+
+        constexpr const Vector<Type,3> &translation()const noexcept{
+            return m_translation;
+        }
+        constexpr Type operator()(size_t x,size_t y)const noexcept{
+            return y == 3 && x < 3 ? m_translation[x] : Type(x == y);
+        }
+        constexpr detail::promote_t<Type> det()const noexcept{
+            return detail::promote_t<Type>(1);
+        }
+
+        constexpr TranslationMatrix inverse()const noexcept{
+            return TranslationMatrix(Vector<Type,3>(-m_translation));
+        }
+
+        constexpr AffineMatrix<Type> toAffine()const noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) = j == 3 ? m_translation[i] : Type(i == j);
+            });
+            return res;
+        }
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            return toAffine().toMatrix();
+        }
+        constexpr operator Matrix<Type,4,4>()const noexcept{
+            return toMatrix();
+        }
+
+        ///*this = *this % mat, the only product that stays a TranslationMatrix
+        constexpr TranslationMatrix &operator%=(const TranslationMatrix &mat)noexcept{
+            return *this = *this % mat;
+        }
+
+        friend constexpr TranslationMatrix operator%(const TranslationMatrix &lhs,const TranslationMatrix &rhs)noexcept{
+            return TranslationMatrix(Vector<Type,3>(lhs.m_translation + rhs.m_translation));
+        }
+        ///| S t |
+        friend constexpr AffineMatrix<Type> operator%(const TranslationMatrix &lhs,const DiagonalMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) = j == 3 ? lhs.m_translation[i] : (i == j ? rhs.scale()[i] : Type(0));
+            });
+            return res;
+        }
+        ///| R t |
+        friend constexpr AffineMatrix<Type> operator%(const TranslationMatrix &lhs,const RotationMatrix<Type> &rhs)noexcept{
+            return AffineMatrix<Type>(rhs.rotation(),lhs.m_translation);
+        }
+        ///| A t + t2 |
+        friend constexpr AffineMatrix<Type> operator%(const TranslationMatrix &lhs,const AffineMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res = rhs;
+            detail::unroll<3>([&](auto i){
+                res(i,3) += lhs.m_translation[i];
+            });
+            return res;
+        }
+        ///| A t | % translation: | A A % translation + t |
+        friend constexpr AffineMatrix<Type> operator%(const AffineMatrix<Type> &lhs,const TranslationMatrix &rhs)noexcept{
+            AffineMatrix<Type> res = lhs;
+            detail::unroll<3>([&](auto i){
+                res(i,3) = lhs(i,0) * rhs.m_translation[0] + lhs(i,1) * rhs.m_translation[1] + lhs(i,2) * rhs.m_translation[2] + lhs(i,3);
+            });
+            return res;
+        }
+        ///row i += t[i] * row 3
+        friend constexpr Matrix<Type,4,4> operator%(const TranslationMatrix &lhs,const Matrix<Type,4,4> &rhs)noexcept{
+            Matrix<Type,4,4> res = rhs;
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) += lhs.m_translation[i] * rhs(3,j);
+            });
+            return res;
+        }
+        ///column 3 = rhs % [t,1]
+        friend constexpr Matrix<Type,4,4> operator%(const Matrix<Type,4,4> &lhs,const TranslationMatrix &rhs)noexcept{
+            Matrix<Type,4,4> res = lhs;
+            detail::unroll<4>([&](auto i){
+                res(i,3) = lhs(i,0) * rhs.m_translation[0] + lhs(i,1) * rhs.m_translation[1] + lhs(i,2) * rhs.m_translation[2] + lhs(i,3);
+            });
+            return res;
+        }
+        friend constexpr Vector<Type,3> operator%(const TranslationMatrix &mat,const Vector<Type,3> &point)noexcept{
+            return Vector<Type,3>(point + mat.m_translation);
+        }
+        friend constexpr Vector<Type,4> operator%(const TranslationMatrix &mat,const Vector<Type,4> &vec)noexcept{
+            Vector<Type,4> res = vec;
+            detail::unroll<3>([&](auto i){
+                res[i] += mat.m_translation[i] * vec[3];
+            });
+            return res;
+        }
+
+        constexpr bool operator==(const TranslationMatrix &mat)const noexcept{
+            return m_translation == mat.m_translation;
+        }
+        constexpr bool operator!=(const TranslationMatrix &mat)const noexcept{
+            return !(*this == mat);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const TranslationMatrix &mat){
+            return os << mat.toMatrix();
+        }
+    protected:
+    private:
+        Vector<Type,3> m_translation;
+    };
+
+    ///| S 0 |, the diagonal S = [s0,s1,s2] of a scale
+    ///| 0 1 |
+    template <class Type>
+    class DiagonalMatrix{
+    public:
+        using value_type = Type;
+
+        constexpr DiagonalMatrix()
+            :m_scale(Type(1)){}
+        constexpr explicit DiagonalMatrix(const Vector<Type,3> &scale)
+            :m_scale(scale){}
+
+        constexpr const Vector<Type,3> &scale()const noexcept{
+            return m_scale;
+        }
+        constexpr Type operator()(size_t x,size_t y)const noexcept{
+            return x != y ? Type(0) : x < 3 ? m_scale[x] : Type(1);
+        }
+        constexpr detail::promote_t<Type> det()const noexcept{
+            return static_cast<detail::promote_t<Type>>(m_scale[0]) * m_scale[1] * m_scale[2];
+        }
+
+        constexpr DiagonalMatrix inverse()const noexcept{
+            return DiagonalMatrix(Vector<Type,3>{1 / m_scale[0],1 / m_scale[1],1 / m_scale[2]});
+        }
+
+        constexpr AffineMatrix<Type> toAffine()const noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) = i == j ? m_scale[i] : Type(0);
+            });
+            return res;
+        }
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            return toAffine().toMatrix();
+        }
+        constexpr operator Matrix<Type,4,4>()const noexcept{
+            return toMatrix();
+        }
+
+        ///*this = *this % mat, the only product that stays a DiagonalMatrix
+        constexpr DiagonalMatrix &operator%=(const DiagonalMatrix &mat)noexcept{
+            return *this = *this % mat;
+        }
+
+        friend constexpr DiagonalMatrix operator%(const DiagonalMatrix &lhs,const DiagonalMatrix &rhs)noexcept{
+            return DiagonalMatrix(Vector<Type,3>(lhs.m_scale * rhs.m_scale));
+        }
+        ///| S S % t |
+        friend constexpr AffineMatrix<Type> operator%(const DiagonalMatrix &lhs,const TranslationMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) = j == 3 ? lhs.m_scale[i] * rhs.translation()[i] : (i == j ? lhs.m_scale[i] : Type(0));
+            });
+            return res;
+        }
+        ///row i of R times s[i]
+        friend constexpr AffineMatrix<Type> operator%(const DiagonalMatrix &lhs,const RotationMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unroll<3>([&](auto i){
+                detail::unroll<3>([&](auto j){
+                    res(i,j) = lhs.m_scale[i] * rhs.rotation()(i,j);
+                });
+                res(i,3) = 0;
+            });
+            return res;
+        }
+        ///row i times s[i]
+        friend constexpr AffineMatrix<Type> operator%(const DiagonalMatrix &lhs,const AffineMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) = lhs.m_scale[i] * rhs(i,j);
+            });
+            return res;
+        }
+        ///column j < 3 times s[j]
+        friend constexpr AffineMatrix<Type> operator%(const AffineMatrix<Type> &lhs,const DiagonalMatrix &rhs)noexcept{
+            AffineMatrix<Type> res = lhs;
+            detail::unrollGrid<3,3>([&](auto i,auto j){
+                res(i,j) *= rhs.m_scale[j];
+            });
+            return res;
+        }
+        friend constexpr Matrix<Type,4,4> operator%(const DiagonalMatrix &lhs,const Matrix<Type,4,4> &rhs)noexcept{
+            Matrix<Type,4,4> res = rhs;
+            detail::unrollGrid<3,4>([&](auto i,auto j){
+                res(i,j) *= lhs.m_scale[i];
+            });
+            return res;
+        }
+        friend constexpr Matrix<Type,4,4> operator%(const Matrix<Type,4,4> &lhs,const DiagonalMatrix &rhs)noexcept{
+            Matrix<Type,4,4> res = lhs;
+            detail::unrollGrid<4,3>([&](auto i,auto j){
+                res(i,j) *= rhs.m_scale[j];
+            });
+            return res;
+        }
+        friend constexpr Vector<Type,3> operator%(const DiagonalMatrix &mat,const Vector<Type,3> &point)noexcept{
+            return Vector<Type,3>(mat.m_scale * point);
+        }
+        friend constexpr Vector<Type,4> operator%(const DiagonalMatrix &mat,const Vector<Type,4> &vec)noexcept{
+            Vector<Type,4> res = vec;
+            detail::unroll<3>([&](auto i){
+                res[i] *= mat.m_scale[i];
+            });
+            return res;
+        }
+
+        constexpr bool operator==(const DiagonalMatrix &mat)const noexcept{
+            return m_scale == mat.m_scale;
+        }
+        constexpr bool operator!=(const DiagonalMatrix &mat)const noexcept{
+            return !(*this == mat);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const DiagonalMatrix &mat){
+            return os << mat.toMatrix();
+        }
+    protected:
+    private:
+        Vector<Type,3> m_scale;
+    };
+
+    ///| R 0 |, R is expected to be orthonormal: the inverse is its transpose
+    ///| 0 1 |
+    template <class Type>
+    class RotationMatrix{
+    public:
+        using value_type = Type;
+
+        constexpr RotationMatrix()
+            :m_rotation(Matrix<Type,3,3>().identity()){}
+        constexpr explicit RotationMatrix(no_init_t)noexcept
+            :m_rotation(no_init){}
+        ///the 9 values of R, row by row
+        constexpr RotationMatrix(std::initializer_list<Type> list)
+            :m_rotation(list){}
+        constexpr explicit RotationMatrix(const Matrix<Type,3,3> &rotation)
+            :m_rotation(rotation){}
+
+        constexpr const Matrix<Type,3,3> &rotation()const noexcept{
+            return m_rotation;
+        }
+        constexpr Type operator()(size_t x,size_t y)const noexcept{
+            return x < 3 && y < 3 ? m_rotation(x,y) : Type(x == y);
+        }
+        constexpr detail::promote_t<Type> det()const noexcept{
+            return m_rotation.det();
+        }
+
+        constexpr RotationMatrix inverse()const noexcept{
+            return RotationMatrix(m_rotation.transpose());
+        }
+
+        constexpr AffineMatrix<Type> toAffine()const noexcept{
+            return AffineMatrix<Type>(m_rotation,Vector<Type,3>());
+        }
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            return toAffine().toMatrix();
+        }
+        constexpr operator Matrix<Type,4,4>()const noexcept{
+            return toMatrix();
+        }
+
+        ///*this = *this % mat, the only product that stays a RotationMatrix
+        constexpr RotationMatrix &operator%=(const RotationMatrix &mat)noexcept{
+            return *this = *this % mat;
+        }
+
+        friend constexpr RotationMatrix operator%(const RotationMatrix &lhs,const RotationMatrix &rhs)noexcept{
+            return RotationMatrix(lhs.m_rotation % rhs.m_rotation);
+        }
+        ///| R R % t |
+        friend constexpr AffineMatrix<Type> operator%(const RotationMatrix &lhs,const TranslationMatrix<Type> &rhs)noexcept{
+            return AffineMatrix<Type>(lhs.m_rotation,Vector<Type,3>(lhs.m_rotation % rhs.translation()));
+        }
+        ///column j of R times s[j]
+        friend constexpr AffineMatrix<Type> operator%(const RotationMatrix &lhs,const DiagonalMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unroll<3>([&](auto i){
+                detail::unroll<3>([&](auto j){
+                    res(i,j) = lhs.m_rotation(i,j) * rhs.scale()[j];
+                });
+                res(i,3) = 0;
+            });
+            return res;
+        }
+        ///R % [A t] (3x3 % 3x4)
+        friend constexpr AffineMatrix<Type> operator%(const RotationMatrix &lhs,const AffineMatrix<Type> &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::product<Type,3,3,4>(lhs.m_rotation.data(),rhs.data(),res.data());
+            return res;
+        }
+        ///| A % R t |
+        friend constexpr AffineMatrix<Type> operator%(const AffineMatrix<Type> &lhs,const RotationMatrix &rhs)noexcept{
+            AffineMatrix<Type> res(no_init);
+            detail::unrollGrid<3,3>([&](auto i,auto j){
+                res(i,j) = lhs(i,0) * rhs.m_rotation(0,j) + lhs(i,1) * rhs.m_rotation(1,j) + lhs(i,2) * rhs.m_rotation(2,j);
+            });
+            detail::unroll<3>([&](auto i){
+                res(i,3) = lhs(i,3);
+            });
+            return res;
+        }
+        ///rows 0-2 are R % rows 0-2 of rhs (3x3 % 3x4), row 3 is copied
+        friend constexpr Matrix<Type,4,4> operator%(const RotationMatrix &lhs,const Matrix<Type,4,4> &rhs)noexcept{
+            Matrix<Type,4,4> res(no_init);
+            detail::product<Type,3,3,4>(lhs.m_rotation.data(),rhs.data(),res.data());
+            detail::unroll<4>([&](auto j){
+                res(3,j) = rhs(3,j);
+            });
+            return res;
+        }
+        ///columns 0-2 are columns 0-2 of lhs % R, column 3 is copied
+        friend constexpr Matrix<Type,4,4> operator%(const Matrix<Type,4,4> &lhs,const RotationMatrix &rhs)noexcept{
+            Matrix<Type,4,4> res(no_init);
+            detail::unrollGrid<4,3>([&](auto i,auto j){
+                res(i,j) = lhs(i,0) * rhs.m_rotation(0,j) + lhs(i,1) * rhs.m_rotation(1,j) + lhs(i,2) * rhs.m_rotation(2,j);
+            });
+            detail::unroll<4>([&](auto i){
+                res(i,3) = lhs(i,3);
+            });
+            return res;
+        }
+        friend constexpr Vector<Type,3> operator%(const RotationMatrix &mat,const Vector<Type,3> &point)noexcept{
+            return mat.m_rotation % point;
+        }
+        friend constexpr Vector<Type,4> operator%(const RotationMatrix &mat,const Vector<Type,4> &vec)noexcept{
+            Vector<Type,4> res(no_init);
+            detail::unroll<3>([&](auto i){
+                res[i] = mat.m_rotation(i,0) * vec[0] + mat.m_rotation(i,1) * vec[1] + mat.m_rotation(i,2) * vec[2];
+            });
+            res[3] = vec[3];
+            return res;
+        }
+
+        constexpr bool operator==(const RotationMatrix &mat)const noexcept{
+            return m_rotation == mat.m_rotation;
+        }
+        constexpr bool operator!=(const RotationMatrix &mat)const noexcept{
+            return !(*this == mat);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const RotationMatrix &mat){
+            return os << mat.toMatrix();
+        }
+    protected:
+    private:
+        Matrix<Type,3,3> m_rotation;
+    };
+
+    using IdentityMatrixf = IdentityMatrix<float>;
+    using IdentityMatrixd = IdentityMatrix<double>;
+    using TranslationMatrixf = TranslationMatrix<float>;
+    using TranslationMatrixd = TranslationMatrix<double>;
+    using DiagonalMatrixf = DiagonalMatrix<float>;
+    using DiagonalMatrixd = DiagonalMatrix<double>;
+    using RotationMatrixf = RotationMatrix<float>;
+    using RotationMatrixd = RotationMatrix<double>;
+}
+
+#endif //_XMATH_STRUCTURED_MATRIX_H_
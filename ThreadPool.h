@@ -0,0 +1,258 @@
+#ifndef _XMATH_THREADPOOL_H_
+#define _XMATH_THREADPOOL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xmath{
+    /**@name ThreadPool
+     * @note a work-stealing pool running parallelFor() over index ranges
+     * @note [begin,end) is first cut into one contiguous chunk per thread (the calling thread is one of them),
+     *       so each thread keeps walking neighbouring memory; a thread that runs dry steals
+     *       the upper half of the largest remaining chunk it finds
+     * @note nothing is allocated per call: chunks live in per-thread slots created with the pool
+     *       and the job itself is a function pointer + context on the caller's stack
+     * @note one parallelFor() runs at a time, a parallelFor() issued from inside a job runs serially
+     * @note if func throws (on any thread) the sub-ranges not yet started are skipped,
+     *       and the first exception is rethrown by parallelFor() once every thread has stopped
+     */
+    class ThreadPool{
+    public:
+        ///threads == 0 uses std::thread::hardware_concurrency()
+        explicit ThreadPool(size_t threads = 0)
+            :m_slots(std::max<size_t>(threads == 0 ? std::thread::hardware_concurrency() : threads,1)){
+            for(size_t i = 1;i < m_slots.size();++i){
+                m_threads.emplace_back([this,i]{workerLoop(i);});
+            }
+        }
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool(){
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for(auto &itr : m_threads){
+                itr.join();
+            }
+        }
+
+        ///the number of threads working on a job, including the calling thread
+        size_t size()const noexcept{
+            return m_slots.size();
+        }
+
+        /**@name parallelFor
+         * @note calls func(beg,end) on disjoint sub-ranges covering [begin,end),
+         *       returns once all of them are done
+         * @param grain the largest sub-range handed out at once, 0 picks one from the range size
+         */
+        template <class Func>
+        void parallelFor(size_t begin,size_t end,size_t grain,Func &&func){
+            if(end <= begin){
+                return;
+            }
+            const size_t n = end - begin;
+            if(grain == 0){
+                grain = std::max<size_t>(n / (size() * 16),1);
+            }
+            if(inWorker() || size() == 1 || n <= grain){
+                func(begin,end);
+                return;
+            }
+
+            std::lock_guard<std::mutex> submit(m_submit);
+            for(size_t i = 0;i < size();++i){
+                std::lock_guard<std::mutex> lock(m_slots[i].mutex);
+                m_slots[i].begin = begin + n * i / size();
+                m_slots[i].end = begin + n * (i + 1) / size();
+            }
+            using Decayed = std::remove_reference_t<Func>;
+            const Job job{
+                [](const void *ctx,size_t beg,size_t end){
+                    (*static_cast<Decayed *>(const_cast<void *>(ctx)))(beg,end);
+                },
+                &func,
+                grain
+            };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_job = &job;
+                m_error = nullptr;
+                m_finished = 0;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            //job lives on this stack, so the workers are waited for however runJob() returns
+            struct Join{
+                ThreadPool &pool;
+                ~Join(){
+                    inWorker() = false;
+                    std::unique_lock<std::mutex> lock(pool.m_mutex);
+                    pool.m_done.wait(lock,[this]{return pool.m_finished == pool.m_threads.size();});
+                    pool.m_job = nullptr;
+                }
+            };
+            {
+                Join join{*this};
+                inWorker() = true;
+                runJob(0);
+            }
+            if(m_error){
+                std::rethrow_exception(std::exchange(m_error,nullptr));
+            }
+        }
+        template <class Func>
+        void parallelFor(size_t begin,size_t end,Func &&func){
+            parallelFor(begin,end,0,std::forward<Func>(func));
+        }
+
+        ///a process-wide pool with one thread per hardware thread
+        static ThreadPool &global(){
+            static ThreadPool pool;
+            return pool;
+        }
+    private:
+        struct Slot{
+            std::mutex mutex;
+            size_t begin = 0;
+            size_t end = 0;
+            char padding[64];//keep neighbouring slots off the same cache line
+        };
+        struct Job{
+            void (*invoke)(const void *,size_t,size_t);
+            const void *ctx;
+            size_t grain;
+        };
+
+        static bool &inWorker()noexcept{
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        void workerLoop(size_t index){
+            inWorker() = true;
+            size_t seen = 0;
+            for(;;){
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock,[&]{return m_stop || m_generation != seen;});
+                    if(m_stop){
+                        return;
+                    }
+                    seen = m_generation;
+                }
+                runJob(index);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(++m_finished == m_threads.size()){
+                        m_done.notify_all();
+                    }
+                }
+            }
+        }
+
+        void runJob(size_t index){
+            const Job &job = *m_job;
+            size_t beg,end;
+            while(pop(index,job.grain,beg,end) || steal(index,job.grain,beg,end)){
+                try{
+                    job.invoke(job.ctx,beg,end);
+                }catch(...){
+                    cancel(std::current_exception());
+                }
+            }
+        }
+
+        ///keeps the first error for parallelFor() to rethrow and empties every slot
+        void cancel(std::exception_ptr error){
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(!m_error){
+                    m_error = std::move(error);
+                }
+            }
+            for(auto &slot : m_slots){
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                slot.begin = slot.end;
+            }
+        }
+
+        bool pop(size_t index,size_t grain,size_t &beg,size_t &end){
+            auto &slot = m_slots[index];
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if(slot.begin >= slot.end){
+                return false;
+            }
+            beg = slot.begin;
+            end = std::min(slot.begin + grain,slot.end);
+            slot.begin = end;
+            return true;
+        }
+
+        bool steal(size_t thief,size_t grain,size_t &beg,size_t &end){
+            size_t stolen_beg = 0,stolen_end = 0;
+            while(stolen_beg == stolen_end){
+                //pick the victim with the most work left
+                size_t victim = thief;
+                size_t most = 0;
+                for(size_t i = 1;i < size();++i){
+                    const size_t index = (thief + i) % size();
+                    auto &slot = m_slots[index];
+                    std::lock_guard<std::mutex> lock(slot.mutex);
+                    if(slot.end > slot.begin && slot.end - slot.begin > most){
+                        most = slot.end - slot.begin;
+                        victim = index;
+                    }
+                }
+                if(victim == thief){
+                    return false;
+                }
+                //the victim may have drained its chunk since, then look again
+                auto &slot = m_slots[victim];
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                if(slot.begin < slot.end){
+                    stolen_end = slot.end;
+                    stolen_beg = slot.end - slot.begin > grain ? slot.begin + (slot.end - slot.begin) / 2 : slot.begin;
+                    slot.end = stolen_beg;
+                }
+            }
+            {
+                auto &slot = m_slots[thief];
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                slot.begin = stolen_beg;
+                slot.end = stolen_end;
+            }
+            return pop(thief,grain,beg,end);
+        }
+
+        std::vector<Slot> m_slots;
+        std::vector<std::thread> m_threads;
+        std::mutex m_submit;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const Job *m_job = nullptr;
+        std::exception_ptr m_error;
+        size_t m_generation = 0;
+        size_t m_finished = 0;
+        bool m_stop = false;
+    };
+
+    ///ThreadPool::global().parallelFor(begin,end,func)
+    template <class Func>
+    void parallelFor(size_t begin,size_t end,Func &&func){
+        ThreadPool::global().parallelFor(begin,end,std::forward<Func>(func));
+    }
+}
+
+#endif //_XMATH_THREADPOOL_H_
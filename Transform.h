@@ -0,0 +1,156 @@
+#ifndef _XMATH_TRANSFORM_H_
+#define _XMATH_TRANSFORM_H_
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Quaternion.h"
+
+namespace xmath{
+    /**@name Transform
+     * @note translation, rotation and scale kept apart: the matrix is
+     *       translation.translate() % rotation.rotate() % scale.scale()
+     * @note 10 values instead of 16, compose/inverse/transformPoint work on the parts directly
+     * @note like any TRS form, compose and inverse are exact when the scale involved is uniform,
+     *       a non-uniform scale followed by a rotation has shear that a Transform cannot hold
+     * @note rotation is expected to be a unit quaternion
+     */
+    template <class Type>
+    class Transform{
+    public:
+        constexpr Transform()
+            :m_translation(),m_rotation{0,0,0,1},m_scale(Type(1)){}
+        constexpr explicit Transform(no_init_t)noexcept
+            :m_translation(no_init),m_rotation(no_init),m_scale(no_init){}
+        constexpr Transform(const Vector<Type,3> &translation,const Quaternion<Type> &rotation,const Vector<Type,3> &scale)
+            :m_translation(translation),m_rotation(rotation),m_scale(scale){}
+        ///decomposes an affine matrix without shear, a mirroring is put in the x scale
+        constexpr explicit Transform(const Matrix<Type,4,4> &mat)
+            :m_translation{mat(0,3),mat(1,3),mat(2,3)},m_rotation(no_init),m_scale(no_init){
+            for(size_t j = 0;j < 3;++j){
+                m_scale[j] = detail::sqrt(mat(0,j) * mat(0,j) + mat(1,j) * mat(1,j) + mat(2,j) * mat(2,j));
+            }
+            if(mat.template sub<3,3>(0,0).det() < 0){
+                m_scale[0] = -m_scale[0];
+            }
+            Matrix<Type,4,4> rot;
+            for(size_t i = 0;i < 3;++i){
+                for(size_t j = 0;j < 3;++j){
+                    rot(i,j) = mat(i,j) / m_scale[j];
+                }
+            }
+            m_rotation = Quaternion<Type>(rot);
+        }
+        Transform(const Transform &) = default;
+        Transform(Transform &&) noexcept = default;
+        ~Transform() = default;
+
+        Transform &operator=(const Transform &) = default;
+        Transform &operator=(Transform &&) noexcept = default;
+
+        constexpr Vector<Type,3> &translation()noexcept{
+            return m_translation;
+        }
+        constexpr const Vector<Type,3> &translation()const noexcept{
+            return m_translation;
+        }
+        constexpr Quaternion<Type> &rotation()noexcept{
+            return m_rotation;
+        }
+        constexpr const Quaternion<Type> &rotation()const noexcept{
+            return m_rotation;
+        }
+        constexpr Vector<Type,3> &scale()noexcept{
+            return m_scale;
+        }
+        constexpr const Vector<Type,3> &scale()const noexcept{
+            return m_scale;
+        }
+
+        ///translation + rotation.rotate(scale * point)
+        constexpr Vector<Type,3> transformPoint(const Vector<Type,3> &point)const noexcept{
+            Vector<Type,3> res = transformDirection(point);
+            for(size_t i = 0;i < 3;++i){
+                res[i] += m_translation[i];
+            }
+            return res;
+        }
+        ///rotation.rotate(scale * dir)
+        constexpr Vector<Type,3> transformDirection(const Vector<Type,3> &dir)const noexcept{
+            Vector<Type,3> scaled(no_init);
+            for(size_t i = 0;i < 3;++i){
+                scaled[i] = m_scale[i] * dir[i];
+            }
+            return m_rotation.rotate(scaled);
+        }
+
+        /**@name inverse
+         * @note rotation^-1 is the conjugate, scale^-1 is 1 / scale component-wise
+         */
+        constexpr Transform inverse()const noexcept{
+            const Quaternion<Type> rotation = m_rotation.conjugate();
+            const Vector<Type,3> moved = rotation.rotate(m_translation);
+            Transform res(no_init);
+            for(size_t i = 0;i < 3;++i){
+                res.m_scale[i] = 1 / m_scale[i];
+                res.m_translation[i] = -moved[i] * res.m_scale[i];
+            }
+            res.m_rotation = rotation;
+            return res;
+        }
+
+        ///the 4x4 affine matrix for upload or mixing with matrix code
+        constexpr Matrix<Type,4,4> toMatrix()const noexcept{
+            const Type x = m_rotation[0],y = m_rotation[1],z = m_rotation[2],w = m_rotation[3];
+            const Type sx = m_scale[0],sy = m_scale[1],sz = m_scale[2];
+            return Matrix<Type,4,4>{
+                (1-2*y*y-2*z*z)*sx,(2*x*y-2*z*w)*sy,(2*x*z+2*y*w)*sz,m_translation[0],
+                (2*x*y+2*z*w)*sx,(1-2*x*x-2*z*z)*sy,(2*y*z-2*x*w)*sz,m_translation[1],
+                (2*x*z-2*y*w)*sx,(2*y*z+2*x*w)*sy,(1-2*x*x-2*y*y)*sz,m_translation[2],
+                0,0,0,1
+            };
+        }
+
+        ///*this = *this % trans
+        constexpr Transform &operator%=(const Transform &trans)noexcept{
+            return *this = *this % trans;
+        }
+
+        ///composition, lhs % rhs applies rhs first like the matrix product
+        friend constexpr Transform operator%(const Transform &lhs,const Transform &rhs)noexcept{
+            Transform res(no_init);
+            res.m_translation = lhs.transformPoint(rhs.m_translation);
+            res.m_rotation = lhs.m_rotation % rhs.m_rotation;
+            for(size_t i = 0;i < 3;++i){
+                res.m_scale[i] = lhs.m_scale[i] * rhs.m_scale[i];
+            }
+            return res;
+        }
+        friend constexpr Vector<Type,3> operator%(const Transform &trans,const Vector<Type,3> &point)noexcept{
+            return trans.transformPoint(point);
+        }
+
+        constexpr bool operator==(const Transform &trans)const noexcept{
+            return m_translation == trans.m_translation
+                && m_rotation == trans.m_rotation
+                && m_scale == trans.m_scale;
+        }
+        constexpr bool operator!=(const Transform &trans)const noexcept{
+            return !(*this == trans);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os,const Transform &trans){
+            os << "T:" << trans.m_translation << " R:" << trans.m_rotation << " S:" << trans.m_scale;
+            return os;
+        }
+    protected:
+    private:
+        Vector<Type,3> m_translation;
+        Quaternion<Type> m_rotation;
+        Vector<Type,3> m_scale;
+    };
+
+    using Transformf = Transform<float>;
+    using Transformd = Transform<double>;
+}
+
+#endif //_XMATH_TRANSFORM_H_
@@ -5,6 +5,150 @@
 #include "Matrix.h"
 
 namespace xmath{
+    /**@name EulerOrder
+     * @note the order the per-axis rotations of Euler angles [x,y,z] are composed in,
+     *       xyz is Vector{1,0,0}.rotate(x) % Vector{0,1,0}.rotate(y) % Vector{0,0,1}.rotate(z)
+     */
+    enum class EulerOrder{
+        xyz,
+        xzy,
+        yxz,
+        yzx,
+        zxy,
+        zyx
+    };
+
+    namespace detail{
+        /**@name eulerMatrix
+         * @note closed form of the Euler rotation for sin/cos of each angle,
+         *       res is the row-major upper 3x3
+         */
+        template <EulerOrder order,class Type>
+        constexpr void eulerMatrix(Type sx,Type sy,Type sz,Type cx,Type cy,Type cz,Type *res)noexcept{
+            if constexpr (order == EulerOrder::xyz){
+                res[0] = cy * cz;
+                res[1] = cy * sz;
+                res[2] = -sy;
+                res[3] = cz * sx * sy - cx * sz;
+                res[4] = cx * cz + sx * sy * sz;
+                res[5] = cy * sx;
+                res[6] = cx * cz * sy + sx * sz;
+                res[7] = cx * sy * sz - cz * sx;
+                res[8] = cx * cy;
+            }else if constexpr (order == EulerOrder::xzy){
+                res[0] = cy * cz;
+                res[1] = sz;
+                res[2] = -cz * sy;
+                res[3] = sx * sy - cx * cy * sz;
+                res[4] = cx * cz;
+                res[5] = cx * sy * sz + cy * sx;
+                res[6] = cx * sy + cy * sx * sz;
+                res[7] = -cz * sx;
+                res[8] = cx * cy - sx * sy * sz;
+            }else if constexpr (order == EulerOrder::yxz){
+                res[0] = cy * cz - sx * sy * sz;
+                res[1] = cy * sz + cz * sx * sy;
+                res[2] = -cx * sy;
+                res[3] = -cx * sz;
+                res[4] = cx * cz;
+                res[5] = sx;
+                res[6] = cy * sx * sz + cz * sy;
+                res[7] = sy * sz - cy * cz * sx;
+                res[8] = cx * cy;
+            }else if constexpr (order == EulerOrder::yzx){
+                res[0] = cy * cz;
+                res[1] = cx * cy * sz + sx * sy;
+                res[2] = cy * sx * sz - cx * sy;
+                res[3] = -sz;
+                res[4] = cx * cz;
+                res[5] = cz * sx;
+                res[6] = cz * sy;
+                res[7] = cx * sy * sz - cy * sx;
+                res[8] = cx * cy + sx * sy * sz;
+            }else if constexpr (order == EulerOrder::zxy){
+                res[0] = cy * cz + sx * sy * sz;
+                res[1] = cx * sz;
+                res[2] = cy * sx * sz - cz * sy;
+                res[3] = cz * sx * sy - cy * sz;
+                res[4] = cx * cz;
+                res[5] = cy * cz * sx + sy * sz;
+                res[6] = cx * sy;
+                res[7] = -sx;
+                res[8] = cx * cy;
+            }else if constexpr (order == EulerOrder::zyx){
+                res[0] = cy * cz;
+                res[1] = cx * sz + cz * sx * sy;
+                res[2] = sx * sz - cx * cz * sy;
+                res[3] = -cy * sz;
+                res[4] = cx * cz - sx * sy * sz;
+                res[5] = cx * sy * sz + cz * sx;
+                res[6] = sy;
+                res[7] = -cy * sx;
+                res[8] = cx * cy;
+            }
+        }
+
+        /**@name eulerQuaternion
+         * @note closed form of the same rotation as eulerMatrix() as a quaternion (xyzw),
+         *       for sin/cos of each half angle
+         */
+        template <EulerOrder order,class Type>
+        constexpr void eulerQuaternion(Type sx,Type sy,Type sz,Type cx,Type cy,Type cz,Type *res)noexcept{
+            if constexpr (order == EulerOrder::xyz){
+                res[0] = cx * sy * sz - cy * cz * sx;
+                res[1] = -cx * cz * sy - cy * sx * sz;
+                res[2] = cz * sx * sy - cx * cy * sz;
+                res[3] = cx * cy * cz + sx * sy * sz;
+            }else if constexpr (order == EulerOrder::xzy){
+                res[0] = -cx * sy * sz - cy * cz * sx;
+                res[1] = -cx * cz * sy - cy * sx * sz;
+                res[2] = cz * sx * sy - cx * cy * sz;
+                res[3] = cx * cy * cz - sx * sy * sz;
+            }else if constexpr (order == EulerOrder::yxz){
+                res[0] = cx * sy * sz - cy * cz * sx;
+                res[1] = -cx * cz * sy - cy * sx * sz;
+                res[2] = -cx * cy * sz - cz * sx * sy;
+                res[3] = cx * cy * cz - sx * sy * sz;
+            }else if constexpr (order == EulerOrder::yzx){
+                res[0] = cx * sy * sz - cy * cz * sx;
+                res[1] = cy * sx * sz - cx * cz * sy;
+                res[2] = -cx * cy * sz - cz * sx * sy;
+                res[3] = cx * cy * cz + sx * sy * sz;
+            }else if constexpr (order == EulerOrder::zxy){
+                res[0] = -cx * sy * sz - cy * cz * sx;
+                res[1] = cy * sx * sz - cx * cz * sy;
+                res[2] = cz * sx * sy - cx * cy * sz;
+                res[3] = cx * cy * cz + sx * sy * sz;
+            }else if constexpr (order == EulerOrder::zyx){
+                res[0] = -cx * sy * sz - cy * cz * sx;
+                res[1] = cy * sx * sz - cx * cz * sy;
+                res[2] = -cx * cy * sz - cz * sx * sy;
+                res[3] = cx * cy * cz - sx * sy * sz;
+            }
+        }
+    }
+
+    template <class Type,size_t Count>
+    class Vector;
+
+    template <class Type>
+    class AffineMatrix;
+    template <class Type>
+    class TranslationMatrix;
+    template <class Type>
+    class DiagonalMatrix;
+    template <class Type>
+    class RotationMatrix;
+
+    template <class Type,size_t Count>
+    struct expression_traits<Vector<Type,Count>>{
+        static constexpr bool is_expression = true;
+        static constexpr bool is_leaf = true;
+        static constexpr bool is_scalar = false;
+        using value_type = Type;
+        using result_type = Vector<Type,Count>;
+    };
+
     template <class Type,size_t Count>
     class Vector{
     public:
@@ -17,243 +161,163 @@ namespace xmath{
             return Count;
         }
 
-        Vector(){
-            for(auto &itr : m_data){
-                itr = 0;
-            }
+        constexpr Vector(){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = 0;
+            });
         }
-        explicit Vector(Type val){
-            for(auto &itr : m_data){
-                itr = val;
-            }
+        constexpr explicit Vector(no_init_t)noexcept{}
+        constexpr explicit Vector(Type val){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = val;
+            });
         }
-        explicit Vector(const Type *ptr){
-            for(size_t i = 0;i < Count;++i){
+        constexpr explicit Vector(const Type *ptr){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = ptr[i];
-            }
+            });
         }
         template <class Iterator>
-        explicit Vector(Iterator beg,Iterator end){
+        constexpr explicit Vector(Iterator beg,Iterator end){
             for(auto itr1 = beg,itr2 = m_data.begin();
                 itr1 != end && itr2 != m_data.end();
                 ++itr1,++itr2){
                 *itr2 = *itr1;
             }
         }
-        explicit Vector(std::initializer_list<Type> list){
+        constexpr explicit Vector(std::initializer_list<Type> list){
             for(auto itr1 = list.begin(),itr2 = m_data.begin();
                 itr1 != list.end() && itr2 != m_data.end();
                 ++itr1,++itr2){
                 *itr2 = *itr1;
             }
         }
-        explicit Vector(const Matrix<Type,1,Count> &matrix){
-            for(auto itr1 = matrix.begin(),itr2 = m_data.begin();
-                itr1 != matrix.end() && itr2 != m_data.end();
-                ++itr1,++itr2){
-                *itr2 = *itr1;
-            }
+        constexpr explicit Vector(const Matrix<Type,1,Count> &matrix){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = matrix[i];
+            });
         }
-        explicit Vector(const Matrix<Type,Count,1> &matrix){
-            for(auto itr1 = matrix.begin(),itr2 = m_data.begin();
-                itr1 != matrix.end() && itr2 != m_data.end();
-                ++itr1,++itr2){
-                *itr2 = *itr1;
-            }
+        constexpr explicit Vector(const Matrix<Type,Count,1> &matrix){
+            detail::unroll<Count>([&](auto i){
+                m_data[i] = matrix[i];
+            });
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,Vector>>>
+        constexpr Vector(const Expr &expr)noexcept{
+            detail::evaluate<Count>(m_data.data(),expr);
         }
         Vector(const Vector &vec) = default;
         Vector(Vector &&) = default;
         ~Vector() = default;
 
-        Vector &operator=(const Matrix<Type,1,Count> &matrix){
-            for(size_t i = 0;i < Count;++i){
+        constexpr Vector &operator=(const Matrix<Type,1,Count> &matrix){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = matrix[i];
-            }
+            });
             return *this;
         }
-        Vector &operator=(const Matrix<Type,Count,1> &matrix){
-            for(size_t i = 0;i < Count;++i){
+        constexpr Vector &operator=(const Matrix<Type,Count,1> &matrix){
+            detail::unroll<Count>([&](auto i){
                 m_data[i] = matrix[i];
-            }
+            });
+            return *this;
+        }
+        template <class Expr,class = std::enable_if_t<is_expression_of_v<Expr,Vector>>>
+        constexpr Vector &operator=(const Expr &expr)noexcept{
+            detail::evaluate<Count>(m_data.data(),expr);
             return *this;
         }
         Vector &operator=(const Vector &mat) = default;
         Vector &operator=(Vector &&) noexcept = default;
 
-        Type &operator[](size_t index) noexcept{
+        constexpr Type &operator[](size_t index) noexcept{
             return m_data[index];
         }
-        const Type &operator[](size_t index) const noexcept {
+        constexpr const Type &operator[](size_t index) const noexcept {
             return m_data[index];
         }
 
-        operator Type *()noexcept {
+        constexpr operator Type *()noexcept {
             return m_data.data();
         }
-        operator const Type *()const noexcept {
+        constexpr operator const Type *()const noexcept {
             return m_data.data();
         }
 
-        Type *data()noexcept {
+        constexpr Type *data()noexcept {
             return m_data.data();
         }
-        const Type *data()const noexcept {
+        constexpr const Type *data()const noexcept {
             return m_data.data();
         }
 
-        Matrix<Type,1,Count> toRow()const noexcept{
-            return Matrix<Type,1,Count>(m_data.data());
-        }
-        Matrix<Type,Count,1> toCol()const noexcept{
-            return Matrix<Type,Count,1>(m_data.data());
-        }
-
-        Vector operator+(const Vector &mat)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] + mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Vector operator+(const Type &val)const noexcept {
-            Vector ans;
-            for(size_t i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] + val;
-            }
-        }
-
-        Vector operator-(const Vector &mat)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] - mat.m_data[i];
-            }
-            return ans;
+        ///the Packet starting at element index, used by the expression evaluator
+        template <class Packet>
+        Packet packet(size_t index)const noexcept{
+            return Packet::load(m_data.data() + index);
         }
 
-        Vector operator-(const Type &value)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] - value;
-            }
-            return ans;
-        }
-        Vector operator-()const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = -m_data[i];
-            }
-            return ans;
-        }
-
-        Vector operator*(const Vector &mat)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] * mat.m_data[i];
-            }
-            return ans;
-        }
-
-        Vector operator*(const Type &value)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] * value;
-            }
-            return ans;
+        constexpr Matrix<Type,1,Count> toRow()const noexcept{
+            return Matrix<Type,1,Count>(m_data.data());
         }
-
-        Vector operator/(const Vector &mat)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] / mat.m_data[i];
-            }
-            return ans;
+        constexpr Matrix<Type,Count,1> toCol()const noexcept{
+            return Matrix<Type,Count,1>(m_data.data());
         }
 
-        Vector operator/(const Type &value)const noexcept{
-            Vector ans;
-            for(auto i = 0;i < Count;++i){
-                ans.m_data[i] = m_data[i] / value;
-            }
-            return ans;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Vector &operator+=(const Expr &expr)noexcept{
+            return *this = *this + expr;
         }
-
-        Vector &operator+=(const Vector &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data += mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Vector &operator-=(const Expr &expr)noexcept {
+            return *this = *this - expr;
         }
-        Vector &operator-=(const Vector &mat)noexcept {
-            for(size_t i = 0;i < Count;++i){
-                m_data -= mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Vector &operator*=(const Expr &expr)noexcept{
+            return *this = *this * expr;
         }
-        Vector &operator*=(const Vector &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data *= mat.m_data[i];
-            }
-            return *this;
+        template <class Expr,class = std::enable_if_t<is_expression_v<Expr>>>
+        constexpr Vector &operator/=(const Expr &expr)noexcept{
+            return *this = *this / expr;
         }
-        Vector &operator/=(const Vector &mat)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data /= mat.m_data[i];
-            }
-            return *this;
+        constexpr Vector &operator+=(const Type &value)noexcept{
+            return *this = *this + value;
         }
-        Vector &operator+=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data += value;
-            }
-            return *this;
+        constexpr Vector &operator-=(const Type &value)noexcept {
+            return *this = *this - value;
         }
-        Vector &operator-=(const Type &value)noexcept {
-            for(size_t i = 0;i < Count;++i){
-                m_data -= value;
-            }
-            return *this;
+        constexpr Vector &operator*=(const Type &value)noexcept{
+            return *this = *this * value;
         }
-        Vector &operator*=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data *= value;
-            }
-            return *this;
-        }
-        Vector &operator/=(const Type &value)noexcept{
-            for(size_t i = 0;i < Count;++i){
-                m_data /= value;
-            }
-            return *this;
+        constexpr Vector &operator/=(const Type &value)noexcept{
+            return *this = *this / value;
         }
 
 
-        bool operator==(const Vector &mat)const noexcept {
-            for(auto itr1 = m_data.begin(),
-                        itr2 = mat.m_data.begin();
-                itr1 != m_data.end();
-                ++itr1,++itr2){
-                if(std::abs(*itr1 - *itr2) > XMATH_EPS){
-                    return false;
-                }
-            }
-            return true;
+        constexpr bool operator==(const Vector &mat)const noexcept {
+            bool equal = true;
+            detail::unroll<Count>([&](auto i){
+                equal &= detail::abs(m_data[i] - mat.m_data[i]) <= XMATH_EPS;
+            });
+            return equal;
         }
-        bool operator!=(const Vector &mat)const noexcept {
+        constexpr bool operator!=(const Vector &mat)const noexcept {
             return !(*this == mat);
         }
 
 
-        Type dot(const Vector &vec) const noexcept{
-            Type ans = 0;
-            for(size_t i = 0;i < Count; ++i){
-                ans += m_data[i] * vec.m_data[i];
-            }
-            return ans;
+        ///summed in promote_t<Type> (float for half/bfloat16) and rounded to Type once
+        constexpr Type dot(const Vector &vec) const noexcept{
+            using Compute = detail::promote_t<Type>;
+            Compute ans = 0;
+            detail::unroll<Count>([&](auto i){
+                ans += static_cast<Compute>(m_data[i]) * static_cast<Compute>(vec.m_data[i]);
+            });
+            return static_cast<Type>(ans);
         }
 
         template <size_t Count2>
-        auto cross(const Vector<Type,Count2> &vec)const noexcept
+        constexpr auto cross(const Vector<Type,Count2> &vec)const noexcept
         -> std::enable_if_t<Count == 3 && Count2 == 3,Vector<Type,3>> {
             return Vector<Type,3>{
                     m_data[1] * vec[2] - vec[1] * m_data[2],
@@ -263,38 +327,26 @@ namespace xmath{
         }
 
 
-        Type length()const noexcept{
-            Type len = 0;
-            for(auto itr = m_data.cbegin();itr != m_data.cend();++itr){
-                len += *itr * *itr;
-            }
-            return std::sqrt(len);
+        ///the square root is taken before rounding, so a half vector whose length2() overflows still has a length
+        constexpr Type length()const noexcept{
+            return static_cast<Type>(detail::sqrt(sum2()));
         }
 
-        Type length2()const noexcept{
-            Type len = 0;
-            for(auto itr = m_data.cbegin();itr != m_data.cend();++itr){
-                len += *itr * *itr;
-            }
-            return len;
+        constexpr Type length2()const noexcept{
+            return static_cast<Type>(sum2());
         }
 
-        Vector normalize()const noexcept{
-            return Vector(this->operator/(length()));
+        constexpr Vector normalize()const noexcept{
+            return Vector(*this / length());
         }
 
         template <class Type2 = Type,size_t Count2 = Count>
-        auto translate()
-        -> std::enable_if_t<Count == 3 && Count2 == 3,Matrix<Type,4,4>>{
-            return Matrix<Type,4,4>{
-                    1,0,0,m_data[0],//x
-                    0,1,0,m_data[1],//y
-                    0,0,1,m_data[2],//z
-                    0,0,0,1
-            };
+        constexpr auto translate()const
+        -> std::enable_if_t<Count == 3 && Count2 == 3,TranslationMatrix<Type>>{
+            return TranslationMatrix<Type>(*this);
         }
         template <class Type2 = Type,size_t Count2 = Count>
-        auto translate()
+        constexpr auto translate()const
         -> std::enable_if_t<Count == 4 && Count2 == 4,Matrix<Type,4,4>>{
             return Matrix<Type,4,4>{
                     1,0,0,m_data[0],//x
@@ -305,69 +357,57 @@ namespace xmath{
         }
 
         template <class Type2 = Type,size_t Count2 = Count>
-        auto scale()
-        -> std::enable_if_t<Count == 3 && Count2 == 3,Matrix<Type,4,4>>{
-            return Matrix<Type,4,4>{
-                    m_data[0],0        ,0        ,0,
-                    0        ,m_data[1],0        ,0,
-                    0        ,0        ,m_data[2],0,
-                    0        ,0        ,0        ,1
-            };
+        constexpr auto scale()const
+        -> std::enable_if_t<Count == 3 && Count2 == 3,DiagonalMatrix<Type>>{
+            return DiagonalMatrix<Type>(*this);
         }
 
         template <class Type2 = Type,size_t Count2 = Count>
-        auto rotate(Type angle)
-        -> std::enable_if_t<Count == 3 && Count2 == 3,Matrix<Type,4,4>>{
+        constexpr auto rotate(Type angle)const
+        -> std::enable_if_t<Count == 3 && Count2 == 3,RotationMatrix<Type>>{
             auto tmp = normalize();
             auto u = tmp[0];
             auto v = tmp[1];
             auto w = tmp[2];
+            const auto c = detail::cos(angle);
+            const auto s = detail::sin(angle);
             //todo:need more tests
-            return Matrix<Type2,4,4>{
-                    u*u+(1-u*u)*cos(angle)         ,u*v*(1-cos(angle))-w*sin(angle),u*w*(1-cos(angle))+v*sin(angle),0,
-                    u*v*(1-cos(angle))+w*sin(angle),v*v+(1-v*v)*cos(angle)         ,v*w*(1-cos(angle))-u*sin(angle),0,
-                    u*w*(1-cos(angle))-v*sin(angle),v*w*(1-cos(angle))+u*sin(angle),         w*w+(1-w*w)*cos(angle),0,
-                    0                              ,0                              ,0                              ,1
-            }.transpose();
+            return RotationMatrix<Type>{
+                    u*u+(1-u*u)*c    ,u*v*(1-c)+w*s    ,u*w*(1-c)-v*s    ,
+                    u*v*(1-c)-w*s    ,v*v+(1-v*v)*c    ,v*w*(1-c)+u*s    ,
+                    u*w*(1-c)+v*s    ,v*w*(1-c)-u*s    ,w*w+(1-w*w)*c
+            };
         }
 
-        template <class Type2 = Type,size_t Count2 = Count>
-        auto rotate()
-        -> std::enable_if_t<Count == 3 && Count2 == 3,Matrix<Type,4,4>>{
-//            auto ac = cos(m_data[0]);
-//            auto as = sin(m_data[0]);
-//            auto bc = cos(m_data[1]);
-//            auto bs = sin(m_data[1]);
-//            auto cc = cos(m_data[2]);
-//            auto cs = sin(m_data[2]);
-//
-//            Matrix4d ma{
-//                1,  0, 0,0,
-//                0, ac,as,0,
-//                0,-as,ac,0,
-//                0,  0, 0,1
-//            };
-            return Vector<Type,3>{1,0,0}.rotate(m_data[0])
-                 % Vector<Type,3>{0,1,0}.rotate(m_data[1])
-                 % Vector<Type,3>{0,0,1}.rotate(m_data[2]);
+        /**@name rotate
+         * @note Euler angles [x,y,z] in radians composed in the given order,
+         *       in closed form with one sin/cos per angle instead of three rotate(angle) products
+         */
+        template <EulerOrder order = EulerOrder::xyz,class Type2 = Type,size_t Count2 = Count>
+        constexpr auto rotate()const
+        -> std::enable_if_t<Count == 3 && Count2 == 3,RotationMatrix<Type>>{
+            Type rot[9];
+            detail::eulerMatrix<order,Type>(
+                detail::sin(m_data[0]),detail::sin(m_data[1]),detail::sin(m_data[2]),
+                detail::cos(m_data[0]),detail::cos(m_data[1]),detail::cos(m_data[2]),rot);
+            return RotationMatrix<Type>(Matrix<Type,3,3>(rot));
         }
 
         template <class Type2 = Type,size_t Count2 = Count>
-        auto lookAt(const Vector<Type2,Count2> &target,const Vector<Type2,Count2> &upDir)
-        -> std::enable_if_t<Count == 3 && Count2 == 3,Matrix<Type,4,4>>{
-            auto forward = (target - *this).normalize();
+        constexpr auto lookAt(const Vector<Type2,Count2> &target,const Vector<Type2,Count2> &upDir)const
+        -> std::enable_if_t<Count == 3 && Count2 == 3,AffineMatrix<Type>>{
+            auto forward = Vector(target - *this).normalize();
             auto up = upDir;
 
             auto side = forward.cross(up).normalize();
             up = side.cross(forward);
 
-            auto m = Matrix<Type,4,4>{
-                    side[0],    side[1],    side[2],0,
-                      up[0],      up[1],      up[2],0,
-                -forward[0],-forward[1],-forward[2],0,
-                          0,          0,          0,1
+            auto m = RotationMatrix<Type>{
+                    side[0],    side[1],    side[2],
+                      up[0],      up[1],      up[2],
+                -forward[0],-forward[1],-forward[2]
             };
-            return m % this->operator-().translate();
+            return m % Vector(-*this).translate();
         }
 
         /**@name frustum
@@ -378,7 +418,7 @@ namespace xmath{
          * @return the frustum matrix
          */
         template <class Type2 = Type,size_t Count2 = Count>
-        auto frustum()
+        constexpr auto frustum()const
         -> std::enable_if_t<Count == 6 && Count2 == 6,Matrix<Type,4,4>>{
             Type2 inv_width = 1.0 / (m_data[3] - m_data[2]);
             Type2 inv_height = 1.0 / (m_data[0] - m_data[1]);
@@ -402,7 +442,7 @@ namespace xmath{
          * @return the frustum matrix
          */
         template <class Type2 = Type,size_t Count2 = Count>
-        auto ortho()
+        constexpr auto ortho()const
         -> std::enable_if_t<Count == 6 && Count2 == 6,Matrix<Type,4,4>>{
             Type2 inv_width = 1.0 / (m_data[3] - m_data[2]);
             Type2 inv_height = 1.0 / (m_data[0] - m_data[1]);
@@ -425,9 +465,9 @@ namespace xmath{
          * @return the frustum matrix
          */
         template <class Type2 = Type,size_t Count2 = Count>
-        auto frustum()
+        constexpr auto frustum()const
         -> std::enable_if_t<Count == 4 && Count2 == 4,Matrix<Type,4,4>>{
-            Type2 cot_fov2 = 1.0 / std::tan(m_data[1] / 2.0);
+            Type2 cot_fov2 = 1.0 / detail::tan(m_data[1] / 2.0);
             Type2 depth = m_data[2] - m_data[3];//near - far
             //todo:need more tests
             return Matrix < Type,4,4 > {
@@ -438,38 +478,47 @@ namespace xmath{
             };
         }
 
-            iterator begin()noexcept{
+        constexpr iterator begin()noexcept{
             return m_data.begin();
         }
-        iterator end()noexcept {
+        constexpr iterator end()noexcept {
             return m_data.end();
         }
-        const_iterator cbegin()const noexcept{
+        constexpr const_iterator begin()const noexcept{
+            return m_data.begin();
+        }
+        constexpr const_iterator end()const noexcept{
+            return m_data.end();
+        }
+        constexpr const_iterator cbegin()const noexcept{
             return m_data.cbegin();
         }
-        const_iterator cend()const noexcept{
+        constexpr const_iterator cend()const noexcept{
             return m_data.cend();
         }
-        reverse_iterator rbegin()noexcept{
+        constexpr reverse_iterator rbegin()noexcept{
             return m_data.rbegin();
         }
-        reverse_iterator rend()noexcept{
+        constexpr reverse_iterator rend()noexcept{
             return m_data.rend();
         }
-        const_reverse_iterator crbegin()const noexcept{
-            return m_data,crbegin();
+        constexpr const_reverse_iterator crbegin()const noexcept{
+            return m_data.crbegin();
         }
-        const_reverse_iterator crend()const noexcept{
+        constexpr const_reverse_iterator crend()const noexcept{
             return m_data.crend();
         }
 
-        friend Vector operator%(const Matrix<Type,Count,Count> &mat,const Vector &vec){
-            Vector ans;
-            for(size_t i = 0;i < Count;++i){
-                for(size_t j = 0;j < Count;++j){
-                    ans[i] += mat(i,j) * vec[j];
-                }
-            }
+        friend constexpr Vector operator%(const Matrix<Type,Count,Count> &mat,const Vector &vec)noexcept{
+            Vector ans(no_init);
+            detail::TransformKernel<Type,Count>::run(mat.data(),vec.data(),ans.data());
+            return ans;
+        }
+        template <class Type2,size_t RowStride,size_t ColStride,
+                  class = std::enable_if_t<std::is_same<std::remove_const_t<Type2>,Type>::value>>
+        friend constexpr Vector operator%(const MatrixView<Type2,Count,Count,RowStride,ColStride> &mat,const Vector &vec)noexcept{
+            Vector ans(no_init);
+            detail::product<Type,Count,Count,1,RowStride,ColStride,1,1>(mat.data(),vec.data(),ans.data());
             return ans;
         }
 
@@ -483,6 +532,16 @@ namespace xmath{
         }
 
     private:
+        ///the sum of squares in promote_t<Type>
+        constexpr detail::promote_t<Type> sum2()const noexcept{
+            using Compute = detail::promote_t<Type>;
+            Compute len = 0;
+            detail::unroll<Count>([&](auto i){
+                len += static_cast<Compute>(m_data[i]) * static_cast<Compute>(m_data[i]);
+            });
+            return len;
+        }
+
         std::array<Type,Count> m_data;
     };
 
@@ -514,4 +573,7 @@ namespace xmath{
 
 }
 
+//the return types of translate(),scale(),rotate() and lookAt(), need Vector complete
+#include "StructuredMatrix.h"
+
 #endif
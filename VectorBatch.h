@@ -0,0 +1,313 @@
+#ifndef _XMATH_VECTORBATCH_H_
+#define _XMATH_VECTORBATCH_H_
+
+#include <algorithm>
+#include <vector>
+#include "Vector.h"
+
+namespace xmath{
+    /**@name VectorBatch
+     * @note a structure-of-arrays container of Vector<Type,Count>:
+     *       every component is stored in its own contiguous array,
+     *       so the batched operations below work on a whole Packet of vectors at a time
+     * @note every batched operation writing into a res argument accepts res == *this
+     */
+    template <class Type,size_t Count>
+    class VectorBatch{
+    public:
+        using value_type = Type;
+        using vector_type = Vector<Type,Count>;
+
+        constexpr size_t count()const noexcept{
+            return Count;
+        }
+
+        VectorBatch() = default;
+        explicit VectorBatch(size_t size){
+            resize(size);
+        }
+        template <class Iterator>
+        VectorBatch(Iterator beg,Iterator end){
+            for(;beg != end;++beg){
+                push_back(*beg);
+            }
+        }
+        VectorBatch(const VectorBatch &) = default;
+        VectorBatch(VectorBatch &&) noexcept = default;
+        ~VectorBatch() = default;
+
+        VectorBatch &operator=(const VectorBatch &) = default;
+        VectorBatch &operator=(VectorBatch &&) noexcept = default;
+
+        size_t size()const noexcept{
+            return m_data[0].size();
+        }
+        bool empty()const noexcept{
+            return m_data[0].empty();
+        }
+        void resize(size_t size){
+            for(auto &itr : m_data){
+                itr.resize(size);
+            }
+        }
+        void reserve(size_t size){
+            for(auto &itr : m_data){
+                itr.reserve(size);
+            }
+        }
+        void clear()noexcept{
+            for(auto &itr : m_data){
+                itr.clear();
+            }
+        }
+
+        void push_back(const vector_type &vec){
+            for(size_t i = 0;i < Count;++i){
+                m_data[i].push_back(vec[i]);
+            }
+        }
+
+        vector_type get(size_t index)const noexcept{
+            vector_type res(no_init);
+            for(size_t i = 0;i < Count;++i){
+                res[i] = m_data[i][index];
+            }
+            return res;
+        }
+        void set(size_t index,const vector_type &vec)noexcept{
+            for(size_t i = 0;i < Count;++i){
+                m_data[i][index] = vec[i];
+            }
+        }
+
+        ///the contiguous array holding component c of every vector
+        Type *component(size_t c)noexcept{
+            return m_data[c].data();
+        }
+        const Type *component(size_t c)const noexcept{
+            return m_data[c].data();
+        }
+
+        /**@name transformPoints
+         * @note Count == 3: res = mat % [x,y,z,1], the last row of mat is ignored (affine)
+         * @note Count == 4: res = mat % [x,y,z,w]
+         */
+        template <size_t Count2 = Count>
+        auto transformPoints(const Matrix<Type,4,4> &mat,VectorBatch &res)const
+        -> std::enable_if_t<Count2 == 3 || Count2 == 4>{
+            res.resize(size());
+            transform<Count == 4,true>(mat,res);
+        }
+        template <size_t Count2 = Count>
+        auto transformPoints(const Matrix<Type,4,4> &mat)const
+        -> std::enable_if_t<Count2 == 3 || Count2 == 4,VectorBatch>{
+            VectorBatch res;
+            transformPoints(mat,res);
+            return res;
+        }
+
+        /**@name transformDirections
+         * @note res = mat % [x,y,z,0], only the upper 3x3 of mat is used
+         * @note for Count == 4 w is copied through unchanged
+         */
+        template <size_t Count2 = Count>
+        auto transformDirections(const Matrix<Type,4,4> &mat,VectorBatch &res)const
+        -> std::enable_if_t<Count2 == 3 || Count2 == 4>{
+            res.resize(size());
+            transform<false,false>(mat,res);
+            if(Count == 4 && &res != this){
+                std::copy(m_data[Count - 1].begin(),m_data[Count - 1].end(),res.m_data[Count - 1].begin());
+            }
+        }
+        template <size_t Count2 = Count>
+        auto transformDirections(const Matrix<Type,4,4> &mat)const
+        -> std::enable_if_t<Count2 == 3 || Count2 == 4,VectorBatch>{
+            VectorBatch res;
+            transformDirections(mat,res);
+            return res;
+        }
+
+        ///res[i] = get(i).dot(batch.get(i)) for i < min(size(),batch.size())
+        void dot(const VectorBatch &batch,Type *res)const noexcept{
+            const auto n = std::min(size(),batch.size());
+            detail::packetFor<Type>(n,[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                auto acc = P::load(m_data[0].data() + i) * P::load(batch.m_data[0].data() + i);
+                for(size_t c = 1;c < Count;++c){
+                    acc = madd(P::load(m_data[c].data() + i),P::load(batch.m_data[c].data() + i),acc);
+                }
+                acc.store(res + i);
+            });
+        }
+        std::vector<Type> dot(const VectorBatch &batch)const{
+            std::vector<Type> res(std::min(size(),batch.size()));
+            dot(batch,res.data());
+            return res;
+        }
+
+        template <size_t Count2 = Count>
+        auto cross(const VectorBatch &batch,VectorBatch &res)const
+        -> std::enable_if_t<Count2 == 3>{
+            const auto n = std::min(size(),batch.size());
+            res.resize(n);
+            detail::packetFor<Type>(n,[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                auto x1 = P::load(m_data[0].data() + i);
+                auto y1 = P::load(m_data[1].data() + i);
+                auto z1 = P::load(m_data[2].data() + i);
+                auto x2 = P::load(batch.m_data[0].data() + i);
+                auto y2 = P::load(batch.m_data[1].data() + i);
+                auto z2 = P::load(batch.m_data[2].data() + i);
+                (y1 * z2 - y2 * z1).store(res.m_data[0].data() + i);
+                (z1 * x2 - z2 * x1).store(res.m_data[1].data() + i);
+                (x1 * y2 - x2 * y1).store(res.m_data[2].data() + i);
+            });
+        }
+        template <size_t Count2 = Count>
+        auto cross(const VectorBatch &batch)const
+        -> std::enable_if_t<Count2 == 3,VectorBatch>{
+            VectorBatch res;
+            cross(batch,res);
+            return res;
+        }
+
+        void length(Type *res)const noexcept{
+            length2(res);
+            detail::packetFor<Type>(size(),[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                sqrt(P::load(res + i)).store(res + i);
+            });
+        }
+        std::vector<Type> length()const{
+            std::vector<Type> res(size());
+            length(res.data());
+            return res;
+        }
+
+        void length2(Type *res)const noexcept{
+            dot(*this,res);
+        }
+        std::vector<Type> length2()const{
+            std::vector<Type> res(size());
+            length2(res.data());
+            return res;
+        }
+
+        void normalize(VectorBatch &res)const{
+            res.resize(size());
+            detail::packetFor<Type>(size(),[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                auto acc = P::load(m_data[0].data() + i) * P::load(m_data[0].data() + i);
+                for(size_t c = 1;c < Count;++c){
+                    acc = madd(P::load(m_data[c].data() + i),P::load(m_data[c].data() + i),acc);
+                }
+                auto inv_len = P::broadcast(1) / sqrt(acc);
+                for(size_t c = 0;c < Count;++c){
+                    (P::load(m_data[c].data() + i) * inv_len).store(res.m_data[c].data() + i);
+                }
+            });
+        }
+        VectorBatch normalize()const{
+            VectorBatch res;
+            normalize(res);
+            return res;
+        }
+
+        /**@name rotate
+         * @note Count == 3, Euler angles [x,y,z]: res[i] = get(i).rotate<order>() for i < size()
+         */
+        template <EulerOrder order = EulerOrder::xyz,size_t Count2 = Count>
+        auto rotate(Matrix<Type,4,4> *res)const noexcept
+        -> std::enable_if_t<Count2 == 3>{
+            for(size_t i = 0;i < size();++i){
+                const Type x = m_data[0][i],y = m_data[1][i],z = m_data[2][i];
+                Type rot[9];
+                detail::eulerMatrix<order,Type>(
+                    std::sin(x),std::sin(y),std::sin(z),
+                    std::cos(x),std::cos(y),std::cos(z),rot);
+                res[i] = Matrix<Type,4,4>{
+                    rot[0],rot[1],rot[2],0,
+                    rot[3],rot[4],rot[5],0,
+                    rot[6],rot[7],rot[8],0,
+                    0     ,0     ,0     ,1
+                };
+            }
+        }
+
+        /**@name quaternion
+         * @note Count == 3, Euler angles [x,y,z]: res gets the xyzw components of
+         *       Quaternion<Type>(get(i),order) for every i
+         * @note the half-angle sin/cos are taken a block at a time, the closed form then runs a Packet at a time
+         */
+        template <EulerOrder order = EulerOrder::xyz,size_t Count2 = Count>
+        auto quaternion(VectorBatch<Type,4> &res)const
+        -> std::enable_if_t<Count2 == 3>{
+            constexpr size_t Block = 64;
+            res.resize(size());
+            alignas(64) Type trig[6][Block];
+            for(size_t beg = 0;beg < size();beg += Block){
+                const size_t n = std::min(Block,size() - beg);
+                for(size_t c = 0;c < 3;++c){
+                    for(size_t i = 0;i < n;++i){
+                        const Type half = m_data[c][beg + i] / 2;
+                        trig[c][i] = std::sin(half);
+                        trig[c + 3][i] = std::cos(half);
+                    }
+                }
+                detail::packetFor<Type>(n,[&](auto tag,size_t i){
+                    using P = typename decltype(tag)::type;
+                    P out[4];
+                    detail::eulerQuaternion<order,P>(
+                        P::load(trig[0] + i),P::load(trig[1] + i),P::load(trig[2] + i),
+                        P::load(trig[3] + i),P::load(trig[4] + i),P::load(trig[5] + i),out);
+                    for(size_t c = 0;c < 4;++c){
+                        out[c].store(res.component(c) + beg + i);
+                    }
+                });
+            }
+        }
+        template <EulerOrder order = EulerOrder::xyz,size_t Count2 = Count>
+        auto quaternion()const
+        -> std::enable_if_t<Count2 == 3,VectorBatch<Type,4>>{
+            VectorBatch<Type,4> res;
+            quaternion<order>(res);
+            return res;
+        }
+
+    private:
+        /**@name transform
+         * @note Homogeneous: res = mat % [x,y,z,w] (Count == 4)
+         * @note otherwise: res.xyz = mat % [x,y,z,Translate ? 1 : 0]
+         */
+        template <bool Homogeneous,bool Translate>
+        void transform(const Matrix<Type,4,4> &mat,VectorBatch &res)const noexcept{
+            constexpr size_t Rows = Homogeneous ? 4 : 3;
+            detail::packetFor<Type>(size(),[&](auto tag,size_t i){
+                using P = typename decltype(tag)::type;
+                auto x = P::load(m_data[0].data() + i);
+                auto y = P::load(m_data[1].data() + i);
+                auto z = P::load(m_data[2].data() + i);
+                auto w = Homogeneous ? P::load(m_data[Count - 1].data() + i) : P::broadcast(Translate ? 1 : 0);
+                P out[Rows];
+                for(size_t r = 0;r < Rows;++r){
+                    out[r] = madd(P::broadcast(mat(r,0)),x,
+                             madd(P::broadcast(mat(r,1)),y,
+                             madd(P::broadcast(mat(r,2)),z,
+                                  P::broadcast(mat(r,3)) * w)));
+                }
+                for(size_t r = 0;r < Rows;++r){
+                    out[r].store(res.m_data[r].data() + i);
+                }
+            });
+        }
+
+        std::array<std::vector<Type>,Count> m_data;
+    };
+
+    using VectorBatch3f = VectorBatch<float,3>;
+    using VectorBatch4f = VectorBatch<float,4>;
+    using VectorBatch3d = VectorBatch<double,3>;
+    using VectorBatch4d = VectorBatch<double,4>;
+}
+
+#endif //_XMATH_VECTORBATCH_H_
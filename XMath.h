@@ -3,6 +3,19 @@
 
 #include "Matrix.h"
 #include "Vector.h"
+#include "AffineMatrix.h"
+#include "StructuredMatrix.h"
 #include "Quaternion.h"
+#include "Transform.h"
+#include "Half.h"
+#include "Aligned.h"
+#include "VectorBatch.h"
+#include "Frustum.h"
+#include "AABB.h"
+#include "Decomposition.h"
+#include "MatrixBatch.h"
+#include "DynamicMatrix.h"
+#include "ThreadPool.h"
+#include "Parallel.h"
 
 #endif //_XMATH_H_
\ No newline at end of file
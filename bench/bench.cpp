@@ -0,0 +1,778 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "XMath.h"
+#include "Binary.h"
+#include "Stream.h"
+#include "Frustum.h"
+#include "AABB.h"
+#include "Decomposition.h"
+#include "MatrixBatch.h"
+
+#if defined(XMATH_BENCH_VMATH)
+#define VMATH_NAMESPACE vmath
+#include <vmath.h>
+#endif
+
+/**@name bench
+ * @note micro-benchmarks of the fixed-size public API, float/double and sizes 2-8,
+ *       with vmath as the reference line for the 3x3/4x4 operations it has
+ * @note usage: bench [--filter substring] [--samples n] [--min-time ms] [--json path]
+ * @note every sample times a batch of calls sized to take about --min-time,
+ *       the report is the per-call time over all samples (min/median/mean/stddev/max)
+ */
+namespace{
+    struct Options{
+        std::string filter;
+        std::string json;
+        size_t samples = 25;
+        double min_time_ms = 2.0;
+    };
+
+    struct Result{
+        std::string op;
+        std::string lib;
+        std::string type;
+        size_t size;
+        size_t batch;
+        double min;
+        double median;
+        double mean;
+        double stddev;
+        double max;
+    };
+
+    Options g_options;
+    std::vector<Result> g_results;
+
+    ///keeps value (and everything it was computed from) alive without a store
+    template <class Type>
+    inline void doNotOptimize(const Type &value){
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    template <class Type>
+    const char *typeName(){
+        if(std::is_same<Type,xmath::half>::value){
+            return "half";
+        }
+        if(std::is_same<Type,xmath::bfloat16>::value){
+            return "bfloat16";
+        }
+        return std::is_same<Type,float>::value ? "float" : "double";
+    }
+
+    /**@name run
+     * @note func(i) is one call of the operation on input i % Inputs
+     */
+    template <class Func>
+    void run(const std::string &op,const std::string &lib,const std::string &type,size_t size,Func &&func){
+        const auto name = op + "/" + lib + "/" + type + "/" + std::to_string(size);
+        if(!g_options.filter.empty() && name.find(g_options.filter) == std::string::npos){
+            return;
+        }
+        using Clock = std::chrono::steady_clock;
+        const auto timeBatch = [&](size_t batch){
+            const auto beg = Clock::now();
+            for(size_t i = 0;i < batch;++i){
+                func(i);
+            }
+            return std::chrono::duration<double,std::nano>(Clock::now() - beg).count();
+        };
+
+        //warm up and grow the batch until one sample takes min_time
+        size_t batch = 1;
+        const double target = g_options.min_time_ms * 1e6;
+        for(double elapsed = timeBatch(batch);elapsed < target;elapsed = timeBatch(batch)){
+            batch = elapsed <= 0 ? batch * 10 : std::max(batch * 2,static_cast<size_t>(batch * target / elapsed * 1.2));
+        }
+
+        std::vector<double> samples(g_options.samples);
+        for(auto &itr : samples){
+            itr = timeBatch(batch) / batch;
+        }
+        std::sort(samples.begin(),samples.end());
+        Result res{op,lib,type,size,batch,samples.front(),samples[samples.size() / 2],0,0,samples.back()};
+        for(auto itr : samples){
+            res.mean += itr;
+        }
+        res.mean /= samples.size();
+        for(auto itr : samples){
+            res.stddev += (itr - res.mean) * (itr - res.mean);
+        }
+        res.stddev = std::sqrt(res.stddev / samples.size());
+        std::printf("%-28s %-6s %-6s %zu  median %9.2f ns  min %9.2f  mean %9.2f  sd %7.2f\n",
+                    op.c_str(),lib.c_str(),type.c_str(),size,res.median,res.min,res.mean,res.stddev);
+        g_results.push_back(res);
+    }
+
+    constexpr size_t Inputs = 64;
+
+    template <class Type>
+    std::vector<Type> randomValues(size_t count,Type lo = -1,Type hi = 1){
+        static std::mt19937 engine(20190915);
+        std::uniform_real_distribution<Type> dist(lo,hi);
+        std::vector<Type> res(count);
+        for(auto &itr : res){
+            itr = dist(engine);
+        }
+        return res;
+    }
+
+    ///Inputs well-conditioned Size x Size matrices (diagonally dominant)
+    template <class Type,size_t Size>
+    std::vector<xmath::Matrix<Type,Size,Size>> randomMatrices(){
+        std::vector<xmath::Matrix<Type,Size,Size>> res;
+        for(size_t i = 0;i < Inputs;++i){
+            auto values = randomValues<Type>(Size * Size);
+            xmath::Matrix<Type,Size,Size> mat(values.data());
+            for(size_t j = 0;j < Size;++j){
+                mat(j,j) += Size;
+            }
+            res.push_back(mat);
+        }
+        return res;
+    }
+
+    template <class Type,size_t Size>
+    std::vector<xmath::Vector<Type,Size>> randomVectors(Type lo = -1,Type hi = 1){
+        std::vector<xmath::Vector<Type,Size>> res;
+        for(size_t i = 0;i < Inputs;++i){
+            auto values = randomValues<Type>(Size,lo,hi);
+            res.emplace_back(values.data());
+        }
+        return res;
+    }
+
+    template <class Type,size_t Size>
+    void benchMatrix(){
+        using namespace xmath;
+        const auto type = typeName<Type>();
+        const auto a = randomMatrices<Type,Size>();
+        const auto b = randomMatrices<Type,Size>();
+        const auto v = randomVectors<Type,Size>();
+
+        run("matrix%matrix","xmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs] % b[(i + 1) % Inputs]);
+        });
+        run("matrix%vector","xmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs] % v[(i + 1) % Inputs]);
+        });
+        run("det","xmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].det());
+        });
+        run("inverse","xmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].inverse());
+        });
+        run("transpose","xmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].transpose());
+        });
+        run("normalize","xmath",type,Size,[&](size_t i){
+            doNotOptimize(v[i % Inputs].normalize());
+        });
+        if constexpr (Size == 3){
+            run("assemble(extend)","xmath",type,Size * 2,[&](size_t i){
+                const auto &x = a[i % Inputs];
+                const auto &y = b[(i + 1) % Inputs];
+                doNotOptimize(x.extend(y).template extend<Direction::down>(y.extend(x)));
+            });
+            run("assemble(subView)","xmath",type,Size * 2,[&](size_t i){
+                Matrix<Type,Size * 2,Size * 2> res(no_init);
+                res.template subView<Size,Size>(0,0) = a[i % Inputs];
+                res.template subView<Size,Size>(0,Size) = b[(i + 1) % Inputs];
+                res.template subView<Size,Size>(Size,0) = b[(i + 1) % Inputs];
+                res.template subView<Size,Size>(Size,Size) = a[i % Inputs];
+                doNotOptimize(res);
+            });
+            run("sub%sub","xmath",type,Size,[&](size_t i){
+                doNotOptimize(a[i % Inputs].template sub<2,2>(1,1) % b[(i + 1) % Inputs].template sub<2,1>(0,0));
+            });
+            run("subView%subView","xmath",type,Size,[&](size_t i){
+                doNotOptimize(a[i % Inputs].template subView<2,2>(1,1) % b[(i + 1) % Inputs].template subView<2,1>(0,0));
+            });
+        }
+    }
+
+    template <class Type,size_t... Sizes>
+    void benchMatrices(std::index_sequence<Sizes...>){
+        int expand[] = {(benchMatrix<Type,Sizes>(),0)...};
+        (void)expand;
+    }
+
+    template <class Type>
+    void benchTransforms(){
+        using namespace xmath;
+        const auto type = typeName<Type>();
+        const auto v3 = randomVectors<Type,3>();
+        const auto u3 = randomVectors<Type,3>();
+        const auto angles = randomValues<Type>(Inputs,-3,3);
+        const auto q = randomVectors<Type,4>();
+        std::vector<Vector<Type,6>> planes;
+        std::vector<Vector<Type,4>> fovs;
+        for(size_t i = 0;i < Inputs;++i){
+            const auto r = randomValues<Type>(6,1,2);
+            planes.push_back(Vector<Type,6>{r[0],-r[1],-r[2],r[3],r[4] / 4,r[5] * 50});
+            fovs.push_back(Vector<Type,4>{r[0],r[1],r[4] / 4,r[5] * 50});
+        }
+
+        run("cross","xmath",type,3,[&](size_t i){
+            doNotOptimize(v3[i % Inputs].cross(u3[(i + 1) % Inputs]));
+        });
+        run("vector a+b*s","xmath",type,3,[&](size_t i){
+            doNotOptimize(Vector<Type,3>(v3[i % Inputs] + u3[(i + 1) % Inputs] * angles[i % Inputs]));
+        });
+        const std::vector<PaddedVector3<Type>> p3(v3.begin(),v3.end());
+        const std::vector<PaddedVector3<Type>> r3(u3.begin(),u3.end());
+        run("vector a+b*s(padded)","xmath",type,3,[&](size_t i){
+            doNotOptimize(PaddedVector3<Type>(p3[i % Inputs] + r3[(i + 1) % Inputs] * angles[i % Inputs]));
+        });
+        run("rotate(axis,angle)","xmath",type,4,[&](size_t i){
+            doNotOptimize(v3[i % Inputs].rotate(angles[i % Inputs]));
+        });
+        run("rotate(euler)","xmath",type,4,[&](size_t i){
+            doNotOptimize(v3[i % Inputs].rotate());
+        });
+        run("quaternion(euler)","xmath",type,4,[&](size_t i){
+            doNotOptimize(Quaternion<Type>(v3[i % Inputs],EulerOrder::xyz));
+        });
+        std::vector<Transform<Type>> trs;
+        for(size_t i = 0;i < Inputs;++i){
+            trs.emplace_back(v3[i],Quaternion<Type>(u3[i],EulerOrder::xyz),Vector<Type,3>(angles[i]));
+        }
+        run("transform.compose","xmath",type,4,[&](size_t i){
+            doNotOptimize(trs[i % Inputs] % trs[(i + 1) % Inputs]);
+        });
+        run("transform.inverse","xmath",type,4,[&](size_t i){
+            doNotOptimize(trs[i % Inputs].inverse());
+        });
+        run("transform.point","xmath",type,3,[&](size_t i){
+            doNotOptimize(trs[i % Inputs] % u3[(i + 1) % Inputs]);
+        });
+        //the same transforms as 3x4 affine matrices against the full 4x4 form
+        std::vector<AffineMatrix<Type>> affine;
+        std::vector<Matrix<Type,4,4>> full;
+        for(size_t i = 0;i < Inputs;++i){
+            affine.push_back(v3[i].translate() % u3[i].rotate() % Vector<Type,3>(angles[i]).scale());
+            full.push_back(affine.back());
+        }
+        run("affine.compose","xmath",type,4,[&](size_t i){
+            doNotOptimize(affine[i % Inputs] % affine[(i + 1) % Inputs]);
+        });
+        run("affine.compose(4x4)","xmath",type,4,[&](size_t i){
+            doNotOptimize(full[i % Inputs] % full[(i + 1) % Inputs]);
+        });
+        run("affine.inverse","xmath",type,4,[&](size_t i){
+            doNotOptimize(affine[i % Inputs].inverse());
+        });
+        run("affine.inverse(4x4)","xmath",type,4,[&](size_t i){
+            doNotOptimize(full[i % Inputs].inverseAffine());
+        });
+        run("affine.point","xmath",type,3,[&](size_t i){
+            doNotOptimize(affine[i % Inputs] % u3[(i + 1) % Inputs]);
+        });
+        //a model matrix from its parts: the structured products against the same parts made affine first
+        std::vector<TranslationMatrix<Type>> moves;
+        std::vector<RotationMatrix<Type>> turns;
+        std::vector<DiagonalMatrix<Type>> scales;
+        for(size_t i = 0;i < Inputs;++i){
+            moves.push_back(v3[i].translate());
+            turns.push_back(u3[i].rotate());
+            scales.push_back(Vector<Type,3>(angles[i]).scale());
+        }
+        run("model(t%r%s)","xmath",type,4,[&](size_t i){
+            doNotOptimize(moves[i % Inputs] % turns[(i + 1) % Inputs] % scales[(i + 2) % Inputs]);
+        });
+        run("model(t%r%s,affine)","xmath",type,4,[&](size_t i){
+            doNotOptimize(AffineMatrix<Type>(moves[i % Inputs]) % AffineMatrix<Type>(turns[(i + 1) % Inputs])
+                          % AffineMatrix<Type>(scales[(i + 2) % Inputs]));
+        });
+        run("scale%point","xmath",type,3,[&](size_t i){
+            doNotOptimize(scales[i % Inputs] % u3[(i + 1) % Inputs]);
+        });
+        run("scale%point(affine)","xmath",type,3,[&](size_t i){
+            doNotOptimize(AffineMatrix<Type>(scales[i % Inputs]) % u3[(i + 1) % Inputs]);
+        });
+        run("lookAt","xmath",type,4,[&](size_t i){
+            doNotOptimize(v3[i % Inputs].lookAt(u3[(i + 1) % Inputs],Vector<Type,3>{0,1,0}));
+        });
+        run("frustum(planes)","xmath",type,4,[&](size_t i){
+            doNotOptimize(planes[i % Inputs].frustum());
+        });
+        run("frustum(fov)","xmath",type,4,[&](size_t i){
+            doNotOptimize(fovs[i % Inputs].frustum());
+        });
+        run("ortho","xmath",type,4,[&](size_t i){
+            doNotOptimize(planes[i % Inputs].ortho());
+        });
+        run("quaternion.cross","xmath",type,4,[&](size_t i){
+            doNotOptimize(Quaternion<Type>(q[i % Inputs]).cross(Quaternion<Type>(q[(i + 1) % Inputs])));
+        });
+        run("quaternion.rotate","xmath",type,4,[&](size_t i){
+            doNotOptimize(Quaternion<Type>(q[i % Inputs]).rotate());
+        });
+
+        std::vector<Quaternion<Type>> unit;
+        for(const auto &itr : q){
+            unit.push_back(Quaternion<Type>(itr).normalize());
+        }
+        run("quaternion.rotate(vec)","xmath",type,3,[&](size_t i){
+            doNotOptimize(unit[i % Inputs].rotate(v3[(i + 1) % Inputs]));
+        });
+        run("quaternion.nlerp","xmath",type,4,[&](size_t i){
+            doNotOptimize(unit[i % Inputs].nlerp(unit[(i + 1) % Inputs],angles[i % Inputs] / 6 + Type(0.5)));
+        });
+        run("quaternion.slerp","xmath",type,4,[&](size_t i){
+            doNotOptimize(unit[i % Inputs].slerp(unit[(i + 1) % Inputs],angles[i % Inputs] / 6 + Type(0.5)));
+        });
+        run("quaternion.slerp(fast)","xmath",type,4,[&](size_t i){
+            doNotOptimize(unit[i % Inputs].template slerp<Interpolation::fast>(unit[(i + 1) % Inputs],angles[i % Inputs] / 6 + Type(0.5)));
+        });
+    }
+
+    ///size is the number of objects tested per call, about two thirds of them visible
+    template <class Type>
+    void benchCulling(){
+        using namespace xmath;
+        constexpr size_t Count = 4096;
+        const auto type = typeName<Type>();
+        const auto proj = Vector<Type,4>{Type(16) / 9,Type(1.2),Type(0.5),Type(200)}.frustum();
+        const auto view = Vector<Type,3>{0,0,0}.lookAt(Vector<Type,3>{0,0,-1},Vector<Type,3>{0,1,0});
+        const Frustum<Type> frustum(proj % view);
+        const auto xy = randomValues<Type>(2 * Count,-60,60);
+        const auto z = randomValues<Type>(Count,-150,10);
+        const auto r = randomValues<Type>(4 * Count,0,2);
+        VectorBatch<Type,3> centers(Count),extents(Count);
+        std::vector<Vector<Type,4>> spheres(Count);
+        for(size_t i = 0;i < Count;++i){
+            centers.set(i,Vector<Type,3>{xy[2 * i],xy[2 * i + 1],z[i]});
+            extents.set(i,Vector<Type,3>{r[4 * i],r[4 * i + 1],r[4 * i + 2]});
+            spheres[i] = Vector<Type,4>{xy[2 * i],xy[2 * i + 1],z[i],1};
+        }
+        std::vector<uint32_t> visible(Count);
+        //the per object loop the batched calls replace
+        run("cull(spheres,dot)","xmath",type,Count,[&](size_t){
+            size_t count = 0;
+            for(size_t i = 0;i < Count;++i){
+                bool inside = true;
+                for(size_t k = 0;k < 6 && inside;++k){
+                    inside = frustum[k].dot(spheres[i]) >= -r[4 * i + 3];
+                }
+                if(inside){
+                    visible[count++] = static_cast<uint32_t>(i);
+                }
+            }
+            doNotOptimize(count);
+        });
+        run("cull(spheres)","xmath",type,Count,[&](size_t){
+            doNotOptimize(frustum.cullSpheres(centers.component(0),centers.component(1),centers.component(2),
+                                              extents.component(0),Count,visible.data()));
+        });
+        run("cull(boxes)","xmath",type,Count,[&](size_t){
+            doNotOptimize(frustum.cullBoxes(centers,extents,visible.data()));
+        });
+    }
+
+    ///size is the number of boxes per call
+    template <class Type>
+    void benchBounds(){
+        using namespace xmath;
+        constexpr size_t Count = 4096;
+        const auto type = typeName<Type>();
+        const auto mat = randomMatrices<Type,4>()[0];
+        const auto c = randomValues<Type>(3 * Count,-100,100);
+        const auto e = randomValues<Type>(3 * Count,0,5);
+        std::vector<AABB<Type,3>> boxes(Count),moved(Count);
+        VectorBatch<Type,3> mins(Count),maxs(Count),moved_mins,moved_maxs;
+        for(size_t i = 0;i < Count;++i){
+            boxes[i] = AABB<Type,3>::fromCenter(Vector<Type,3>(&c[3 * i]),Vector<Type,3>(&e[3 * i]));
+            mins.set(i,boxes[i].min());
+            maxs.set(i,boxes[i].max());
+        }
+        //the eight corners through %, what transform() replaces
+        run("aabb.transform(corners)","xmath",type,Count,[&](size_t){
+            for(size_t i = 0;i < Count;++i){
+                AABB<Type,3> res;
+                for(size_t k = 0;k < 8;++k){
+                    const auto &box = boxes[i];
+                    const Vector<Type,4> corner{(k & 1 ? box.max() : box.min())[0],(k & 2 ? box.max() : box.min())[1],
+                                                (k & 4 ? box.max() : box.min())[2],1};
+                    const Vector<Type,4> p = mat % corner;
+                    res = res.merge(Vector<Type,3>{p[0],p[1],p[2]});
+                }
+                moved[i] = res;
+            }
+            doNotOptimize(moved[0]);
+        });
+        run("aabb.transform","xmath",type,Count,[&](size_t){
+            for(size_t i = 0;i < Count;++i){
+                moved[i] = boxes[i].transform(mat);
+            }
+            doNotOptimize(moved[0]);
+        });
+        run("transformBoxes","xmath",type,Count,[&](size_t){
+            transformBoxes(mat,boxes.data(),moved.data(),Count);
+            doNotOptimize(moved[0]);
+        });
+        run("transformBoxes(soa)","xmath",type,Count,[&](size_t){
+            transformBoxes(mat,mins,maxs,moved_mins,moved_maxs);
+            doNotOptimize(moved_mins.component(0)[0]);
+        });
+        run("mergeBoxes","xmath",type,Count,[&](size_t){
+            doNotOptimize(mergeBoxes(boxes.data(),Count));
+        });
+        run("mergeBoxes(soa)","xmath",type,Count,[&](size_t){
+            doNotOptimize(mergeBoxes(mins,maxs));
+        });
+    }
+
+    ///6x6 systems as in Gauss-Newton normal equations, size is the system size
+    template <class Type>
+    void benchSolvers(){
+        using namespace xmath;
+        constexpr size_t N = 6;
+        const auto type = typeName<Type>();
+        const auto j = randomMatrices<Type,N>();
+        const auto v = randomVectors<Type,N>();
+        std::vector<Matrix<Type,N,N>> a;
+        for(const auto &m : j){
+            Matrix<Type,N,N> spd = m.transpose() % m;
+            for(size_t i = 0;i < N;++i){
+                spd(i,i) += Type(N);
+            }
+            a.push_back(spd);
+        }
+        run("solve(inverse)","xmath",type,N,[&](size_t i){
+            doNotOptimize(a[i % Inputs].inverse() % v[(i + 1) % Inputs]);
+        });
+        run("matrix.solve","xmath",type,N,[&](size_t i){
+            doNotOptimize(a[i % Inputs].solve(v[(i + 1) % Inputs].toCol()));
+        });
+        run("lu.solve","xmath",type,N,[&](size_t i){
+            doNotOptimize(LUDecomposition<Type,N>(a[i % Inputs]).solve(v[(i + 1) % Inputs]));
+        });
+        run("cholesky.solve","xmath",type,N,[&](size_t i){
+            doNotOptimize(CholeskyDecomposition<Type,N>(a[i % Inputs]).solve(v[(i + 1) % Inputs]));
+        });
+        run("qr.solve","xmath",type,N,[&](size_t i){
+            doNotOptimize(QRDecomposition<Type,N,N>(a[i % Inputs]).solve(v[(i + 1) % Inputs]));
+        });
+        //one factorisation, many right-hand sides
+        const LUDecomposition<Type,N> lu(a[0]);
+        const CholeskyDecomposition<Type,N> cholesky(a[0]);
+        run("lu.solve(reuse)","xmath",type,N,[&](size_t i){
+            doNotOptimize(lu.solve(v[i % Inputs]));
+        });
+        run("cholesky.solve(reuse)","xmath",type,N,[&](size_t i){
+            doNotOptimize(cholesky.solve(v[i % Inputs]));
+        });
+    }
+
+    ///independent matrices one per call (Matrix) against one per Packet lane (MatrixBatch), size is the count
+    template <class Type,size_t N>
+    void benchMatrixBatch(){
+        using namespace xmath;
+        constexpr size_t Count = 4096;
+        const auto type = typeName<Type>();
+        const auto inputs = randomMatrices<Type,N>();
+        std::vector<Matrix<Type,N,N>> a(Count),b(Count),res(Count);
+        for(size_t i = 0;i < Count;++i){
+            a[i] = inputs[i % Inputs] * Type(1 + i % 7);
+            b[i] = a[(i + 1) % Count].transpose();
+        }
+        std::vector<Type> dets(Count);
+        const MatrixBatch<Type,N,N> batch_a(a.begin(),a.end()),batch_b(b.begin(),b.end());
+        MatrixBatch<Type,N,N> batch_res;
+        const std::string size = "[" + std::to_string(N) + "x" + std::to_string(N) + "]";
+        run("det" + size,"xmath",type,Count,[&](size_t){
+            for(size_t i = 0;i < Count;++i){
+                dets[i] = a[i].det();
+            }
+            doNotOptimize(dets[0]);
+        });
+        run("batch.det" + size,"xmath",type,Count,[&](size_t){
+            batch_a.det(dets.data());
+            doNotOptimize(dets[0]);
+        });
+        run("inverse" + size,"xmath",type,Count,[&](size_t){
+            for(size_t i = 0;i < Count;++i){
+                res[i] = a[i].inverse();
+            }
+            doNotOptimize(res[0]);
+        });
+        run("batch.inverse" + size,"xmath",type,Count,[&](size_t){
+            batch_a.inverse(batch_res);
+            doNotOptimize(batch_res.data()[0]);
+        });
+        run("matrix%matrix" + size,"xmath",type,Count,[&](size_t){
+            for(size_t i = 0;i < Count;++i){
+                res[i] = a[i] % b[i];
+            }
+            doNotOptimize(res[0]);
+        });
+        run("batch.multiply" + size,"xmath",type,Count,[&](size_t){
+            batch_a.multiply(batch_b,batch_res);
+            doNotOptimize(batch_res.data()[0]);
+        });
+        run("batch.transpose" + size,"xmath",type,Count,[&](size_t){
+            batch_a.transpose(batch_res);
+            doNotOptimize(batch_res.data()[0]);
+        });
+    }
+
+    ///size is the number of values converted per call
+    template <class Storage>
+    void benchStorage(){
+        using namespace xmath;
+        constexpr size_t Count = 4096;
+        const auto type = typeName<Storage>();
+        const auto values = randomValues<float>(Count,-100,100);
+        std::vector<Storage> stored(Count);
+        std::vector<float> back(Count);
+        run("convert(float->)","xmath",type,Count,[&](size_t){
+            convert(values.data(),stored.data(),Count);
+            doNotOptimize(stored[0]);
+        });
+        run("convert(->float)","xmath",type,Count,[&](size_t){
+            convert(stored.data(),back.data(),Count);
+            doNotOptimize(back[0]);
+        });
+        std::vector<Matrix<Storage,4,4>> m;
+        std::vector<Vector<Storage,4>> v;
+        for(const auto &itr : randomMatrices<float,4>()){
+            m.emplace_back();
+            convert(&itr,&m.back(),1);
+        }
+        for(const auto &itr : randomVectors<float,4>()){
+            v.emplace_back();
+            convert(&itr,&v.back(),1);
+        }
+        run("matrix%vector","xmath",type,4,[&](size_t i){
+            doNotOptimize(m[i % Inputs] % v[(i + 1) % Inputs]);
+        });
+    }
+
+    ///open() maps the file and checks the header, the records are not read
+    void benchBinary(){
+        using namespace xmath;
+        constexpr size_t Count = 65536;
+        const char *path = "xmath_bench.xmb";
+        const auto mats = randomMatrices<float,4>();
+        std::vector<Matrix4f> records(Count);
+        for(size_t i = 0;i < Count;++i){
+            records[i] = mats[i % Inputs];
+        }
+        run("binary.write","xmath","float",Count,[&](size_t){
+            doNotOptimize(writeBinary(path,records.data(),records.size()));
+        });
+        run("binary.open","xmath","float",Count,[&](size_t){
+            MappedBinary<Matrix4f> file(path);
+            doNotOptimize(file.records().back());
+        });
+        std::remove(path);
+    }
+
+    ///a point cloud file to file, loading it whole first vs streaming it chunk by chunk
+    void benchStream(){
+        using namespace xmath;
+        constexpr size_t Count = 1 << 20;
+        const char *in_path = "xmath_bench_in.bin";
+        const char *out_path = "xmath_bench_out.bin";
+        const auto v = randomVectors<float,3>(-100,100);
+        const Matrix4f mat = randomMatrices<float,4>()[0];
+        std::vector<Vector3f> points(Count);
+        for(size_t i = 0;i < Count;++i){
+            points[i] = v[i % Inputs];
+        }
+        std::FILE *file = std::fopen(in_path,"wb");
+        std::fwrite(points.data(),sizeof(Vector3f),Count,file);
+        std::fclose(file);
+
+        run("stream(load all)","xmath","float",Count,[&](size_t){
+            std::vector<Vector3f> cloud(Count);
+            std::FILE *in = std::fopen(in_path,"rb");
+            cloud.resize(std::fread(cloud.data(),sizeof(Vector3f),Count,in));
+            std::fclose(in);
+            transformPoints(mat,cloud.data(),cloud.data(),cloud.size());
+            std::FILE *out = std::fopen(out_path,"wb");
+            std::fwrite(cloud.data(),sizeof(Vector3f),cloud.size(),out);
+            std::fclose(out);
+        });
+        run("stream(chunked)","xmath","float",Count,[&](size_t){
+            doNotOptimize(streamTransform<Vector3f>(in_path,out_path,mat));
+        });
+        std::remove(in_path);
+        std::remove(out_path);
+    }
+
+#if defined(XMATH_BENCH_VMATH)
+    template <class Type,size_t Size>
+    using vmath_matrix_t = std::conditional_t<Size == 3,vmath::Matrix3<Type>,vmath::Matrix4<Type>>;
+    template <class Type,size_t Size>
+    using vmath_vector_t = std::conditional_t<Size == 3,vmath::Vector3<Type>,vmath::Vector4<Type>>;
+
+    ///vmath stores column-major, the inputs are the transposed xmath ones so both compute the same
+    template <class Type,size_t Size>
+    void benchVmathMatrix(){
+        const auto type = typeName<Type>();
+        std::vector<vmath_matrix_t<Type,Size>> a,b;
+        std::vector<vmath_vector_t<Type,Size>> v;
+        for(const auto &itr : randomMatrices<Type,Size>()){
+            a.emplace_back(itr.transpose().data());
+        }
+        for(const auto &itr : randomMatrices<Type,Size>()){
+            b.emplace_back(itr.transpose().data());
+        }
+        for(const auto &itr : randomVectors<Type,Size>()){
+            vmath_vector_t<Type,Size> vec;
+            for(size_t i = 0;i < Size;++i){
+                vec[i] = itr[i];
+            }
+            v.push_back(vec);
+        }
+
+        run("matrix%matrix","vmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs] * b[(i + 1) % Inputs]);
+        });
+        run("matrix%vector","vmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs] * v[(i + 1) % Inputs]);
+        });
+        run("det","vmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].det());
+        });
+        run("inverse","vmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].inverse());
+        });
+        run("transpose","vmath",type,Size,[&](size_t i){
+            doNotOptimize(a[i % Inputs].transpose());
+        });
+        run("normalize","vmath",type,Size,[&](size_t i){
+            auto vec = v[i % Inputs];
+            vec.normalize();
+            doNotOptimize(vec);
+        });
+    }
+
+    template <class Type>
+    void benchVmathTransforms(){
+        const auto type = typeName<Type>();
+        std::vector<vmath::Vector3<Type>> v3,u3;
+        for(const auto &itr : randomVectors<Type,3>()){
+            v3.emplace_back(itr[0],itr[1],itr[2]);
+        }
+        for(const auto &itr : randomVectors<Type,3>()){
+            u3.emplace_back(itr[0],itr[1],itr[2]);
+        }
+        std::vector<vmath::Quaternion<Type>> q;
+        for(const auto &itr : randomVectors<Type,4>()){
+            q.emplace_back(itr[3],itr[0],itr[1],itr[2]);
+        }
+        const auto planes = randomValues<Type>(Inputs * 6,1,2);
+        const auto up = vmath::Vector3<Type>(0,1,0);
+
+        run("cross","vmath",type,3,[&](size_t i){
+            doNotOptimize(v3[i % Inputs].crossProduct(u3[(i + 1) % Inputs]));
+        });
+        run("rotate(euler)","vmath",type,4,[&](size_t i){
+            const auto &vec = v3[i % Inputs];
+            doNotOptimize(vmath::Matrix4<Type>::createRotationAroundAxis(vec.x,vec.y,vec.z));
+        });
+        run("lookAt","vmath",type,4,[&](size_t i){
+            doNotOptimize(vmath::Matrix4<Type>::createLookAt(v3[i % Inputs],u3[(i + 1) % Inputs],up));
+        });
+        run("frustum(planes)","vmath",type,4,[&](size_t i){
+            const Type *p = planes.data() + i % Inputs * 6;
+            doNotOptimize(vmath::Matrix4<Type>::createFrustum(-p[2],p[3],-p[1],p[0],p[4] / 4,p[5] * 50));
+        });
+        run("ortho","vmath",type,4,[&](size_t i){
+            const Type *p = planes.data() + i % Inputs * 6;
+            doNotOptimize(vmath::Matrix4<Type>::createOrtho(-p[2],p[3],-p[1],p[0],p[4] / 4,p[5] * 50));
+        });
+        run("quaternion.cross","vmath",type,4,[&](size_t i){
+            doNotOptimize(q[i % Inputs] * q[(i + 1) % Inputs]);
+        });
+        run("quaternion.rotate","vmath",type,4,[&](size_t i){
+            doNotOptimize(q[i % Inputs].transform());
+        });
+    }
+#endif
+
+    void writeJson(const std::string &path){
+        std::ofstream os(path);
+        os << "{\n  \"library\": \"xmath\",\n";
+#if defined(XMATH_BENCH_VMATH)
+        os << "  \"reference\": \"vmath\",\n";
+#else
+        os << "  \"reference\": null,\n";
+#endif
+        os << "  \"samples\": " << g_options.samples << ",\n";
+        os << "  \"unit\": \"ns\",\n  \"results\": [\n";
+        for(size_t i = 0;i < g_results.size();++i){
+            const auto &r = g_results[i];
+            os << "    {\"op\": \"" << r.op << "\", \"lib\": \"" << r.lib << "\", \"type\": \"" << r.type
+               << "\", \"size\": " << r.size << ", \"batch\": " << r.batch
+               << ", \"min\": " << r.min << ", \"median\": " << r.median << ", \"mean\": " << r.mean
+               << ", \"stddev\": " << r.stddev << ", \"max\": " << r.max << "}"
+               << (i + 1 == g_results.size() ? "\n" : ",\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+    template <class Type>
+    void benchType(){
+        benchMatrices<Type>(std::index_sequence<2,3,4,5,6,7,8>{});
+        benchTransforms<Type>();
+        benchCulling<Type>();
+        benchBounds<Type>();
+        benchSolvers<Type>();
+        benchMatrixBatch<Type,3>();
+        benchMatrixBatch<Type,4>();
+#if defined(XMATH_BENCH_VMATH)
+        benchVmathMatrix<Type,3>();
+        benchVmathMatrix<Type,4>();
+        benchVmathTransforms<Type>();
+#endif
+    }
+}
+
+int main(int argc,char **argv){
+    for(int i = 1;i < argc;++i){
+        const bool has_value = i + 1 < argc;
+        if(!std::strcmp(argv[i],"--filter") && has_value){
+            g_options.filter = argv[++i];
+        }else if(!std::strcmp(argv[i],"--json") && has_value){
+            g_options.json = argv[++i];
+        }else if(!std::strcmp(argv[i],"--samples") && has_value){
+            g_options.samples = std::max(1,std::atoi(argv[++i]));
+        }else if(!std::strcmp(argv[i],"--min-time") && has_value){
+            g_options.min_time_ms = std::atof(argv[++i]);
+        }else{
+            std::cerr << "usage: " << argv[0] << " [--filter substring] [--samples n] [--min-time ms] [--json path]\n";
+            return 1;
+        }
+    }
+
+    benchType<float>();
+    benchType<double>();
+    benchStorage<xmath::half>();
+    benchStorage<xmath::bfloat16>();
+    benchBinary();
+    benchStream();
+
+    if(!g_options.json.empty()){
+        writeJson(g_options.json);
+    }
+    return 0;
+}
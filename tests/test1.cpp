@@ -1,7 +1,22 @@
 #include "XTest/XTest.h"
 #include "Matrix.h"
 #include "Vector.h"
+#include "AffineMatrix.h"
+#include "StructuredMatrix.h"
 #include "Quaternion.h"
+#include "VectorBatch.h"
+#include "Transform.h"
+#include "Half.h"
+#include "Aligned.h"
+#include "Binary.h"
+#include "Stream.h"
+#include "Frustum.h"
+#include "AABB.h"
+#include "Decomposition.h"
+#include "MatrixBatch.h"
+#include "Parallel.h"
+#include <atomic>
+#include <stdexcept>
 
 #define VMATH_NAMESPACE vmath
 #include <vmath.h>
@@ -253,3 +268,617 @@ CASE_END
 RUN(vmath_comp)
 
 
+
+CASE_BEGIN(expression)
+    using namespace xmath;
+    auto a = Vector3i{1,2,3};
+    auto b = Vector3i{4,5,6};
+    auto c = Vector3i{7,8,9};
+    Vector3i r = a * 2 + b - c;
+    INFO("a * 2 + b - c:",r);
+    ASSERT_SEQ((std::array<int,3>{-1,1,3}),r);
+    Matrix2x3i m = -(Matrix2x3i{1,2,3,4,5,6} * Matrix2x3i{2,2,2,1,1,1}) + 1;
+    INFO("m:\n",m);
+    ASSERT_SEQ((std::array<int,6>{-1,-3,-5,-3,-4,-5}),m);
+    //temporaries are held by value, so the expression may outlive the full-expression
+    auto e = a + Vector3i{1,1,1} * 2;
+    Vector3i s = e;
+    ASSERT_SEQ((std::array<int,3>{3,4,5}),s);
+    //the Matrix/Vector members and % evaluate the expression first
+    ASSERT_SEQ((std::array<int,1>{(a - b).dot(c)}),(std::array<int,1>{-72}));
+    auto n = Matrix3i{1,2,3,4,5,6,7,8,9};
+    ASSERT_SEQ((n + n) % n,Matrix3i(n % n * 2));
+    ASSERT_SEQ((n * 2).transpose(),Matrix3i(n.transpose() * 2));
+    //negation flips the sign bit on every SIMD width, -(+0) is -0
+    Vector<float,16> z = -Vector<float,16>(0.0f);
+    ASSERT_SEQ((std::array<bool,2>{std::signbit(z[0]),std::signbit(z[15])}),(std::array<bool,2>{true,true}));
+CASE_END
+
+RUN(expression)
+
+CASE_BEGIN(kernels)
+    using namespace xmath;
+    //the SIMD kernels at runtime against the scalar forms they run while constant-evaluated,
+    //small integers keep every product and sum exact so the two must agree bit for bit
+    constexpr Matrix4f af{1,-2,3,4, 5,6,-7,8, 9,10,11,-12, -13,14,15,16};
+    constexpr Matrix4f bf{2,0,-1,3, 1,4,2,-2, 0,-3,5,1, 6,2,-4,7};
+    constexpr Vector4f vf{1,-1,2,3};
+    constexpr Matrix4d ad{1,-2,3,4, 5,6,-7,8, 9,10,11,-12, -13,14,15,16};
+    constexpr Matrix4d bd{2,0,-1,3, 1,4,2,-2, 0,-3,5,1, 6,2,-4,7};
+    constexpr Vector4d vd{1,-1,2,3};
+    constexpr Matrix<float,3,4> wide{1,2,3,4, -5,6,-7,8, 9,-10,11,12};
+    constexpr Matrix<float,4,8> tall{1,2,3,4,5,6,7,8, -1,0,1,0,-1,0,1,0, 2,2,-2,2,2,-2,2,2, 0,1,2,3,-3,-2,-1,0};
+    constexpr auto abf = af % bf;
+    constexpr auto avf = af % vf;
+    constexpr auto atf = af.transpose();
+    constexpr auto abd = ad % bd;
+    constexpr auto avd = ad % vd;
+    constexpr auto atd = ad.transpose();
+    constexpr auto wt = wide % tall;
+    Matrix4f a = af;
+    Matrix4d d = ad;
+    Matrix<float,3,4> w = wide;
+    INFO("a % b:\n",a % bf);
+    ASSERT_SEQ(abf,(a % bf));
+    ASSERT_SEQ(avf,(a % vf));
+    ASSERT_SEQ(atf,a.transpose());
+    ASSERT_SEQ(abd,(d % bd));
+    ASSERT_SEQ(avd,(d % vd));
+    ASSERT_SEQ(atd,d.transpose());
+    ASSERT_SEQ(wt,(w % tall));
+CASE_END
+
+RUN(kernels)
+
+CASE_BEGIN(inverse4x4)
+    using namespace xmath;
+    //the SSE Inverse4x4Kernel<float> at runtime, against the identity and the scalar form it folds to
+    constexpr Matrix4f mf{2,1,0,1, -1,3,1,0, 0,1,4,-1, 1,0,-1,2};
+    constexpr auto scalar = mf.inverse();
+    constexpr Matrix4f singular{1,2,3,4, 2,-1,0,1, 3,1,3,5, 0,1,1,-2};
+    Matrix4f m = mf;
+    bool invertible = false;
+    const auto inv = m.inverse(invertible);
+    INFO("m.inverse():\n",inv);
+    ASSERT_SEQ((std::array<bool,4>{true,true,true,true}),
+               (std::array<bool,4>{invertible,m % inv == Matrix4f().identity(),inv % m == Matrix4f().identity(),inv == scalar}));
+    //the third row is the sum of the first two
+    m = singular;
+    ASSERT_SEQ(Matrix4f(),m.inverse(invertible));
+    ASSERT_SEQ((std::array<bool,1>{false}),(std::array<bool,1>{invertible}));
+CASE_END
+
+RUN(inverse4x4)
+
+CASE_BEGIN(constexpr_matrix)
+    using namespace xmath;
+    constexpr auto ortho = Vector<double,6>{2,1,5,3,4,5}.ortho();
+    constexpr Matrix4d trs = Vector3d{1,2,3}.translate() % Vector3d{0.4,0.5,0.7}.rotate() % Vector3d{2,2,2}.scale();
+    constexpr auto id = trs % trs.inverseAffine();
+    static_assert(Matrix3i{2,1,0,1,3,1,0,1,4}.det() == 18 && Matrix4i{2,1,0,0,1,3,1,0,0,1,4,1,0,0,1,5}.det() == 85,"det must fold");
+    static_assert(Matrix3i{2,0,0,0,4,0,0,0,1}.inverse() == Matrix3i{0,0,0,0,0,0,0,0,1} && Matrix3d{2,0,0,0,4,0,0,0,1}.inverse() == Matrix3d{0.5,0,0,0,0.25,0,0,0,1},"integers divide");
+    static_assert(id == Matrix4d().identity(),"inverseAffine must fold");
+    static_assert([]{ Vector3i v{1,2,3}; *v.begin() = 4; return v[0]; }() == 4,"mutable iterators");
+    INFO("trs % trs^-1:\n",id);
+    ASSERT_SEQ((Vector<double,6>{2,1,5,3,4,5}.ortho()),ortho);
+CASE_END
+
+RUN(constexpr_matrix)
+
+CASE_BEGIN(quaternion)
+    using namespace xmath;
+    constexpr auto q = Quaterniond{0.3,-0.2,0.5,0.8}.normalize();
+    constexpr auto p = Quaterniond{-0.6,0.1,0.2,0.7}.normalize();
+    constexpr auto v = Vector3d{1,2,3};
+    constexpr auto m = q.rotate() % Vector4d{1,2,3,1};
+    static_assert(q % v == Vector3d{m[0],m[1],m[2]},"rotate(vec) must match rotate()");
+    static_assert((q % p) % v == q % (p % v),"% must compose rotations");
+    constexpr auto half = q.slerp(p,0.5);
+    static_assert(half == q.slerp<Interpolation::fast>(p,0.5) && half == q.nlerp(p,0.5),"midpoints must agree");
+    INFO("slerp(q,p,0.5):",half);
+    auto r = q;
+    r %= p;
+    ASSERT_SEQ(q % p,r);
+CASE_END
+
+RUN(quaternion)
+
+CASE_BEGIN(euler)
+    using namespace xmath;
+    constexpr auto angles = Vector3d{0.3,-1.2,2.0};
+    constexpr auto chained = Vector3d{1,0,0}.rotate(0.3) % Vector3d{0,1,0}.rotate(-1.2) % Vector3d{0,0,1}.rotate(2.0);
+    static_assert(angles.rotate() == chained,"closed form must match the chained rotations");
+    static_assert(Quaterniond(angles,EulerOrder::zyx).rotate() == angles.rotate<EulerOrder::zyx>(),"quaternion must match matrix");
+    VectorBatch3d batch;
+    batch.push_back(angles);
+    Matrix4d mats[1];
+    batch.rotate<EulerOrder::yzx>(mats);
+    //two code paths, equal up to the eps of Matrix::operator== (FMA contraction differs)
+    ASSERT_SEQ((std::array<bool,1>{true}),(std::array<bool,1>{Matrix4d(angles.rotate<EulerOrder::yzx>()) == mats[0]}));
+    INFO("euler zyx:\n",angles.rotate<EulerOrder::zyx>());
+CASE_END
+
+RUN(euler)
+
+CASE_BEGIN(vector_batch)
+    using namespace xmath;
+    //13 vectors: whole packets and a scalar tail whatever the packet width,
+    //small integers keep transform, dot and cross exact so they must match the per-vector results
+    constexpr size_t n = 13;
+    const Matrix4f mat{2,-1,0,3, 1,3,-2,-1, 0,1,1,2, 4,0,-3,1};
+    VectorBatch<float,3> a,b;
+    VectorBatch<float,4> h;
+    for(size_t i = 0;i < n;++i){
+        const auto f = static_cast<float>(i);
+        a.push_back(Vector3f{f - 6,2 * f + 1,3 - f});
+        b.push_back(Vector3f{1 - f,f,f * f - 10});
+        h.push_back(Vector4f{f,-f,1 + f,2 - f});
+    }
+    const auto points = a.transformPoints(mat);
+    const auto directions = a.transformDirections(mat);
+    const auto points4 = h.transformPoints(mat);
+    const auto directions4 = h.transformDirections(mat);
+    const auto dots = a.dot(b);
+    const auto crosses = a.cross(b);
+    const auto lengths = a.length();
+    const auto units = a.normalize();
+    std::array<bool,n> exact{},close{};
+    for(size_t i = 0;i < n;++i){
+        const auto v = a.get(i),w = b.get(i);
+        const auto u = h.get(i);
+        const auto p = mat % Vector4f{v[0],v[1],v[2],1};
+        const auto d = mat % Vector4f{v[0],v[1],v[2],0};
+        const auto d4 = mat % Vector4f{u[0],u[1],u[2],0};
+        exact[i] = points.get(i) == Vector3f{p[0],p[1],p[2]} && directions.get(i) == Vector3f{d[0],d[1],d[2]}
+                   && points4.get(i) == mat % u && directions4.get(i) == Vector4f{d4[0],d4[1],d4[2],u[3]}
+                   && dots[i] == v.dot(w) && crosses.get(i) == v.cross(w);
+        //the batch multiplies by a reciprocal square root, so length and normalize agree up to rounding
+        close[i] = std::abs(lengths[i] - v.length()) <= 1e-6f * v.length() && units.get(i) == v.normalize();
+    }
+    INFO("points[12]:",points.get(12));
+    ASSERT_SEQ((std::array<bool,n>{true,true,true,true,true,true,true,true,true,true,true,true,true}),exact);
+    ASSERT_SEQ((std::array<bool,n>{true,true,true,true,true,true,true,true,true,true,true,true,true}),close);
+CASE_END
+
+RUN(vector_batch)
+
+CASE_BEGIN(transform)
+    using namespace xmath;
+    constexpr Transformd a(Vector3d{1,2,3},Quaterniond(Vector3d{0.1,0.2,0.3},EulerOrder::xyz),Vector3d(2.0));
+    constexpr Transformd b(Vector3d{-1,0,4},Quaterniond(Vector3d{1.5,0,-0.5},EulerOrder::zyx),Vector3d(0.5));
+    static_assert((a % b).toMatrix() == a.toMatrix() % b.toMatrix(),"compose must match the matrix product");
+    static_assert((a % a.inverse()).toMatrix() == Matrix4d().identity(),"inverse must undo the transform");
+    static_assert(Transformd(a.toMatrix()) == a,"the matrix must decompose back");
+    INFO("a % b:",a % b);
+    ASSERT_SEQ((std::array<double,3>{1,2,3}),a % Vector3d{});
+CASE_END
+
+RUN(transform)
+
+CASE_BEGIN(affine)
+    using namespace xmath;
+    constexpr auto a = Vector3d{1,2,3}.translate() % Vector3d{0.4,0.5,0.7}.rotate() % Vector3d{2,1,0.5}.scale();
+    constexpr auto b = Vector3d{0,-1,2}.lookAt(Vector3d{3,1,-2},Vector3d{0,1,0});
+    static_assert(Matrix4d(a % b) == Matrix4d(a) % Matrix4d(b),"compose must match the 4x4 product");
+    static_assert(a % a.inverse() == AffineMatrixd() && b.inverseRigid() == b.inverse(),"inverse must undo the transform");
+    static_assert(Matrix4d(a.inverse()) == Matrix4d(a).inverseAffine(),"inverse must match inverseAffine");
+    constexpr auto proj = Vector4d{1.5,1.2,0.5,100}.frustum();
+    static_assert(proj % b == proj % Matrix4d(b) && b % proj == Matrix4d(b) % proj,"mixed products");
+    constexpr auto p = Vector3d{0.5,-2,4};
+    constexpr auto q = Matrix4d(a) % Vector4d{0.5,-2,4,1};
+    static_assert(a % p == Vector3d{q[0],q[1],q[2]} && a % Vector4d{0.5,-2,4,1} == q,"points");
+    static_assert(a.transformDirection(p) + a.translation() == a.transformPoint(p),"directions skip t");
+    INFO("a % b:\n",a % b);
+    ASSERT_SEQ((std::array<double,4>{1,2,3,1}),(a % Vector4d{0,0,0,1}));
+CASE_END
+
+RUN(affine)
+
+CASE_BEGIN(structured)
+    using namespace xmath;
+    constexpr auto t = Vector3d{1,2,3}.translate();
+    constexpr auto s = Vector3d{2,0.5,-1}.scale();
+    constexpr auto r = Vector3d{0.4,0.5,0.7}.rotate();
+    constexpr Matrix4d tm = t,sm = s,rm = r;
+    static_assert(std::is_same_v<decltype(t % t),TranslationMatrixd> && std::is_same_v<decltype(s % s),DiagonalMatrixd>
+               && std::is_same_v<decltype(r % r),RotationMatrixd> && std::is_same_v<decltype(t % r),AffineMatrixd>,"shapes");
+    static_assert(Matrix4d(t % t) == tm % tm && Matrix4d(s % s) == sm % sm && Matrix4d(r % r) == rm % rm,"same shapes");
+    static_assert(Matrix4d(t % s % r) == tm % sm % rm && Matrix4d(r % s % t) == rm % sm % tm && Matrix4d(s % t % r) == sm % tm % rm,"mixed shapes");
+    constexpr AffineMatrixd a = Vector3d{0,-1,2}.lookAt(Vector3d{3,1,-2},Vector3d{0,1,0});
+    constexpr Matrix4d am = a;
+    static_assert(Matrix4d(a % t) == am % tm && Matrix4d(a % s) == am % sm && Matrix4d(a % r) == am % rm,"affine % shape");
+    static_assert(Matrix4d(t % a) == tm % am && Matrix4d(s % a) == sm % am && Matrix4d(r % a) == rm % am,"shape % affine");
+    constexpr auto proj = Vector4d{1.5,1.2,0.5,100}.frustum();
+    static_assert(proj % t == proj % tm && proj % s == proj % sm && proj % r == proj % rm,"dense % shape");
+    static_assert(t % proj == tm % proj && s % proj == sm % proj && r % proj == rm % proj,"shape % dense");
+    constexpr auto v = Vector4d{0.5,-2,4,1};
+    static_assert(t % v == tm % v && s % v == sm % v && r % v == rm % v,"shape % vector");
+    static_assert(t % t.inverse() == TranslationMatrixd() && s % s.inverse() == DiagonalMatrixd() && r % r.inverse() == RotationMatrixd(),"inverses");
+    static_assert(IdentityMatrixd() % t == t && r % IdentityMatrixd() == r && Matrix4d(IdentityMatrixd()) == Matrix4d().identity(),"identity");
+    constexpr auto multiplies = [](auto rhs){
+        return requires(IdentityMatrixd id){ id % rhs; };
+    };
+    static_assert(multiplies(v) && multiplies(Vector3d()) && multiplies(am) && !multiplies(2.0) && !multiplies(Matrix2d()),"identity operands");
+    static_assert(t(1,3) == tm(1,3) && s(2,2) == sm(2,2) && r(0,1) == rm(0,1) && r(3,3) == 1 && s(3,3) == 1,"4x4 elements");
+    static_assert(t.det() == 1 && s.det() == sm.det() && r.det() == rm.det(),"det");
+    auto acc = t;
+    acc %= t;
+    ASSERT_SEQ((std::array<double,3>{2,4,6}),acc.translation());
+    INFO("s % point:",s % Vector3d{1,1,1});
+    ASSERT_SEQ((std::array<double,3>{2,0.5,-1}),(s % Vector3d{1,1,1}));
+CASE_END
+
+RUN(structured)
+
+CASE_BEGIN(half)
+    using namespace xmath;
+    static_assert(half(65504.0f).bits() == 0x7BFF,"largest finite half");
+    static_assert(half(1.0f + 0x1p-11f).bits() == 0x3C00,"ties round to even");
+    static_assert(bfloat16(1.0f).bits() == 0x3F80,"bfloat16 keeps the float exponent");
+    constexpr Matrix4h mat{1,2,3,4, 0,1,0,2, 0,0,1,3, 0,0,0,1};
+    static_assert(mat % Vector4h{1,1,1,1} == Vector4h{10,3,4,1},"products accumulate in float");
+    static_assert(Vector3h{300,400,1200}.length() == half(1300.0f),"so do length() and dot(), 1300^2 is not a finite half");
+    constexpr Matrix4h big{50,0,0,-7, 0,50,0,0, 0,0,50,0, 0,0,0,1};
+    static_assert(big.det() == 125000.0f && Matrix<half,3,3>{-300,0,0,0,-300,0,0,0,-2}.det() == -180000.0f,"det() is a float");
+    static_assert(big.inverse() == Matrix4h{0.02f,0,0,0.14f, 0,0.02f,0,0, 0,0,0.02f,0, 0,0,0,1},"so are the inverse intermediates");
+    static_assert(detail::abs(half(-2.0f)) == half(2.0f),"");
+    bool invertible = false;
+    const auto inv = Matrix<half,2,2>{-2,1,3,-4}.inverse(invertible);
+    INFO("inverse:",inv);
+    ASSERT_SEQ((std::array<bool,2>{true,true}),(std::array<bool,2>{invertible,inv == Matrix<half,2,2>{-0.8f,-0.2f,-0.6f,-0.4f}}));
+    ASSERT_SEQ((Matrix4h{0.02f,0,0,0.14f, 0,0.02f,0,0, 0,0,0.02f,0, 0,0,0,1}),big.inverse(invertible));
+    std::array<float,5> src{0.1f,-2.5f,1e6f,3.0f,-0.0f};
+    std::array<bfloat16,5> stored{};
+    std::array<float,5> back{};
+    convert(src.data(),stored.data(),src.size());
+    convert(stored.data(),back.data(),back.size());
+    INFO("bfloat16:",back[0],back[1],back[2]);
+    ASSERT_SEQ((std::array<float,2>{-2.5f,3.0f}),(std::array<float,2>{back[1],back[3]}));
+CASE_END
+
+RUN(half)
+
+CASE_BEGIN(aligned)
+    using namespace xmath;
+    static_assert(sizeof(PaddedVector3f) == 16 && alignof(PaddedVector3f) == 16,"four lanes");
+    static_assert(alignof(AlignedMatrix4f) == XMATH_CACHE_LINE,"one cache line");
+    constexpr PaddedVector3f a{1,2,3},b{4,5,6};
+    static_assert(PaddedVector3f(a + b * 2.0f) == Vector3f{9,12,15},"padded expressions");
+    std::vector<PaddedVector3f,AlignedAllocator<PaddedVector3f>> padded(2);
+    const Vector3f packed[2] = {Vector3f{1,2,3},Vector3f{-1,2,1}};
+    convert(packed,padded.data(),2);
+    padded[1] = padded[0] / padded[1];
+    INFO("padded:",padded[1]);
+    ASSERT_SEQ((std::array<float,4>{-1,1,3,0}),(std::array<float,4>{padded[1][0],padded[1][1],padded[1][2],padded[1].data()[3]}));
+    padded[1] += Vector3f{1,1,1};
+    padded[1] *= padded[0] + padded[0];
+    ASSERT_SEQ((std::array<float,4>{0,8,24,0}),(std::array<float,4>{padded[1][0],padded[1][1],padded[1][2],padded[1].data()[3]}));
+CASE_END
+
+RUN(aligned)
+
+CASE_BEGIN(binary)
+    using namespace xmath;
+    const std::vector<Quaternionf> poses(100,Quaternionf(Vector3f{0.1f,0.2f,0.3f},EulerOrder::xyz));
+    const auto written = writeBinary("xmath_test.xmb",poses.data(),poses.size());
+    MappedBinary<Quaternionf> file;
+    const auto opened = file.open("xmath_test.xmb");
+    MappedBinary<Quaterniond> wrong;
+    const auto mismatched = wrong.open("xmath_test.xmb");
+    INFO("records:",file.size());
+    ASSERT_SEQ((std::array<int,3>{0,0,static_cast<int>(BinaryError::type)}),
+               (std::array<int,3>{static_cast<int>(written),static_cast<int>(opened),static_cast<int>(mismatched)}));
+    ASSERT_SEQ(poses.back(),file.records().back());
+    file.close();
+    std::remove("xmath_test.xmb");
+CASE_END
+
+RUN(binary)
+
+CASE_BEGIN(views)
+    using namespace xmath;
+    constexpr Matrix3f m{1,2,3,4,5,6,7,8,9};
+    static_assert(Matrix3f(m.transposeView()) == m.transpose(),"transpose view");
+    static_assert(m.transposeView() % m.view() == m.transpose() % m,"strided product");
+    static_assert(Matrix<float,3,4>(m.extendView(Matrix<float,3,1>{1,1,1})) == Matrix<float,3,4>{1,2,3,1,4,5,6,1,7,8,9,1},"extend");
+    Matrix4f big{};
+    big.subView<3,3>(0,0) = m;
+    big.colView(3) = Matrix<float,4,1>{4,8,12,1};
+    big.rowView(3).sub<1,3>(0,0) += 2.0f;
+    INFO("big:",big);
+    ASSERT_SEQ((std::array<float,4>{7,8,9,12}),big.row(2));
+    ASSERT_SEQ((std::array<float,4>{2,2,2,1}),big.row(3));
+    //a view of the assigned matrix is read through a temporary
+    auto sym = m;
+    sym += sym.transposeView();
+    ASSERT_SEQ(sym,Matrix3f(m + m.transpose()));
+CASE_END
+
+RUN(views)
+
+CASE_BEGIN(dynamic)
+    using namespace xmath;
+    //gemm against a naive triple loop, small integers keep both sums exact in every Type;
+    //the sizes straddle the 4 x (2 packets) register tile and the 64/256/512 cache blocks
+    const auto matches = []<class Type>(Type,size_t m,size_t n,size_t k){
+        DynamicMatrix<Type> a(m,k,no_init),b(k,n,no_init),naive(m,n);
+        for(size_t i = 0;i < a.count();++i){
+            a[i] = static_cast<Type>(static_cast<int>(i % 7) - 3);
+        }
+        for(size_t i = 0;i < b.count();++i){
+            b[i] = static_cast<Type>(static_cast<int>(i % 5) - 2);
+        }
+        for(size_t i = 0;i < m;++i){
+            for(size_t j = 0;j < n;++j){
+                for(size_t p = 0;p < k;++p){
+                    naive(i,j) += a(i,p) * b(p,j);
+                }
+            }
+        }
+        return a % b == naive;
+    };
+    const size_t sizes[][3] = {{1,1,1},{5,7,3},{67,19,261},{13,530,9}};
+    std::array<bool,12> gemm{};
+    for(size_t i = 0;i < 4;++i){
+        gemm[i * 3] = matches(0,sizes[i][0],sizes[i][1],sizes[i][2]);
+        gemm[i * 3 + 1] = matches(0.0f,sizes[i][0],sizes[i][1],sizes[i][2]);
+        gemm[i * 3 + 2] = matches(0.0,sizes[i][0],sizes[i][1],sizes[i][2]);
+    }
+    ASSERT_SEQ((std::array<bool,12>{true,true,true,true,true,true,true,true,true,true,true,true}),gemm);
+    //fixed on either side, a strided view and a vector
+    constexpr Matrix<double,3,4> fixed{1,2,3,4, -1,0,2,1, 3,-2,1,0};
+    constexpr Matrix<double,4,5> rhs{1,0,2,-1,3, 0,1,1,2,-2, 4,-1,0,1,1, 2,2,-3,0,1};
+    const DynamicMatrixd dynamic(rhs);
+    const auto left = fixed % dynamic;
+    const auto right = DynamicMatrixd(fixed) % rhs;
+    const auto sub = DynamicMatrixd(fixed).view(0,1,3,3) % dynamic.view(1,0,3,5);
+    const auto col = DynamicMatrixd(fixed) % Vector4d{1,-1,2,0};
+    INFO("fixed % dynamic:\n",left);
+    ASSERT_SEQ(DynamicMatrixd(fixed % rhs),left);
+    ASSERT_SEQ(DynamicMatrixd(fixed % rhs),right);
+    ASSERT_SEQ(DynamicMatrixd(fixed.sub<3,3>(0,1) % rhs.sub<3,5>(1,0)),sub);
+    ASSERT_SEQ((DynamicVectord{5,3,7}),col);
+    //the inner dimensions differ
+    const auto mismatch = dynamic % dynamic;
+    ASSERT_SEQ((std::array<size_t,2>{0,0}),(std::array<size_t,2>{mismatch.getRowCount(),mismatch.getColCount()}));
+    const DynamicVectori u{1,2,3},v{4,-5,6};
+    ASSERT_SEQ((DynamicVectori{5,-3,9}),u + v);
+    ASSERT_SEQ((DynamicVectori{4,-10,18}),u * v);
+    ASSERT_SEQ((std::array<int,2>{12,14}),(std::array<int,2>{u.dot(v),u.length2()}));
+CASE_END
+
+RUN(dynamic)
+
+CASE_BEGIN(parallel)
+    using namespace xmath;
+    ThreadPool pool(4);
+    //every index exactly once, over enough generations for the workers to miss a wake-up or run a stale job
+    constexpr size_t n = 1000;
+    std::vector<std::atomic<int>> hits(n);
+    for(size_t gen = 0;gen < 200;++gen){
+        pool.parallelFor(gen % 3,n - gen % 5,gen % 2 == 0 ? 0 : 7,[&](size_t beg,size_t end){
+            for(size_t i = beg;i < end;++i){
+                hits[i].fetch_add(1,std::memory_order_relaxed);
+            }
+        });
+    }
+    size_t expected = 0;
+    for(size_t i = 0;i < n;++i){
+        size_t runs = 0;
+        for(size_t gen = 0;gen < 200;++gen){
+            runs += i >= gen % 3 && i < n - gen % 5;
+        }
+        expected += hits[i].load() == static_cast<int>(runs);
+    }
+    INFO("hits[0],hits[500]:",hits[0].load(),",",hits[500].load());
+    ASSERT_SEQ((std::array<size_t,1>{n}),(std::array<size_t,1>{expected}));
+    //the first exception reaches the caller and the pool stays usable
+    std::string error;
+    try{
+        pool.parallelFor(0,n,1,[](size_t beg,size_t){
+            if(beg == 500){
+                throw std::runtime_error("job 500");
+            }
+        });
+    }catch(const std::runtime_error &e){
+        error = e.what();
+    }
+    ASSERT_SEQ(std::string("job 500"),error);
+    //a nested parallelFor runs serially: one call over the whole range on the calling thread
+    std::atomic<int> nested{0},serial{0};
+    pool.parallelFor(0,64,1,[&](size_t,size_t){
+        const auto id = std::this_thread::get_id();
+        pool.parallelFor(0,100,1,[&](size_t beg,size_t end){
+            nested.fetch_add(1);
+            serial.fetch_add(beg == 0 && end == 100 && std::this_thread::get_id() == id);
+        });
+    });
+    ASSERT_SEQ((std::array<int,2>{64,64}),(std::array<int,2>{nested.load(),serial.load()}));
+    //parallelProduct against %
+    std::vector<Matrix4f> lhs(37),rhs(37),out(37),shared(37);
+    std::array<bool,37> same{};
+    for(size_t i = 0;i < lhs.size();++i){
+        const auto f = static_cast<float>(i);
+        lhs[i] = Vector3f{f,1,-f}.translate() % Vector3f{0.1f * f,0,0.5f}.rotate();
+        rhs[i] = Vector3f{1,f,2}.scale() % Vector3f{0,0.2f * f,0}.rotate();
+    }
+    parallelProduct(lhs.data(),rhs.data(),out.data(),lhs.size(),pool);
+    parallelProduct(lhs[3],rhs.data(),shared.data(),rhs.size(),pool);
+    for(size_t i = 0;i < lhs.size();++i){
+        same[i] = out[i] == lhs[i] % rhs[i] && shared[i] == lhs[3] % rhs[i];
+    }
+    ASSERT_SEQ((std::array<bool,37>{true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,
+                                    true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true,true}),same);
+    //the dynamic product spans more than one block of 64 rows
+    DynamicMatrixd a(150,70,no_init),b(70,90,no_init);
+    for(size_t i = 0;i < a.count();++i){
+        a[i] = static_cast<double>(static_cast<int>(i % 9) - 4);
+    }
+    for(size_t i = 0;i < b.count();++i){
+        b[i] = static_cast<double>(static_cast<int>(i % 4) - 1);
+    }
+    ASSERT_SEQ(a % b,parallelProduct(a,b,pool));
+    ASSERT_SEQ(DynamicMatrixd(),parallelProduct(a,a,pool));
+CASE_END
+
+RUN(parallel)
+
+CASE_BEGIN(stream)
+    using namespace xmath;
+    const Matrix4f mat{1,0,0,1, 0,2,0,2, 0,0,3,3, 0,0,0,1};
+    std::vector<Vector3f> points(1000,Vector3f{1,1,1});
+    points.back() = Vector3f{-1,2,0};
+    std::FILE *file = std::fopen("xmath_stream_in.bin","wb");
+    std::fwrite(points.data(),sizeof(Vector3f),points.size(),file);
+    std::fclose(file);
+    const auto res = streamTransform<Vector3f>("xmath_stream_in.bin","xmath_stream_out.bin",mat,64);
+    std::vector<Vector3f> moved(points.size() + 1);
+    file = std::fopen("xmath_stream_out.bin","rb");
+    moved.resize(std::fread(moved.data(),sizeof(Vector3f),moved.size(),file));
+    std::fclose(file);
+    INFO("records:",moved.size());
+    ASSERT_SEQ((std::array<int,2>{0,1000}),(std::array<int,2>{static_cast<int>(res),static_cast<int>(moved.size())}));
+    ASSERT_SEQ((Vector3f{2,4,6}),moved.front());
+    ASSERT_SEQ((Vector3f{0,6,3}),moved.back());
+    //Type comes from the records, so the structured chain converts to the 4x4
+    const auto chain = Vector3f{1,2,3}.translate() % Vector3f{1,2,3}.scale();
+    streamTransform<Vector3f>("xmath_stream_in.bin","xmath_stream_out.bin",chain,64);
+    std::vector<Vector3f> chained(points.size());
+    file = std::fopen("xmath_stream_out.bin","rb");
+    chained.resize(std::fread(chained.data(),sizeof(Vector3f),chained.size(),file));
+    std::fclose(file);
+    ASSERT_SEQ(moved,chained);
+    std::vector<Vector4f> homogeneous(3,Vector4f{-1,2,0,1});
+    parallelTransform(chain,homogeneous.data(),homogeneous.data(),homogeneous.size());
+    ASSERT_SEQ((Vector4f{0,6,3,1}),homogeneous.back());
+    std::remove("xmath_stream_in.bin");
+    std::remove("xmath_stream_out.bin");
+CASE_END
+
+RUN(stream)
+
+CASE_BEGIN(frustum)
+    using namespace xmath;
+    constexpr Frustumf box(Vector<float,6>{1,-1,-1,1,1,3}.ortho());
+    static_assert(box.contains(Vector3f{0,0,-2}) && !box.contains(Vector3f{0,0,-4}),"ortho volume");
+    static_assert(box[Frustumf::near_clip] == Vector4f{0,0,-1,-1},"normalized inward planes");
+    const Frustumf view(Vector4f{1,1.5f,0.5f,100}.frustum());
+    VectorBatch<float,3> centers,extents;
+    const float radius[5] = {1,1,1,1,0.5f};
+    for(const auto &itr : {Vector3f{0,0,-10},Vector3f{0,0,10},Vector3f{50,0,-10},Vector3f{0,0,-99},Vector3f{0,0,-0.1f}}){
+        centers.push_back(itr);
+        extents.push_back(Vector3f{1,1,0.5f});
+    }
+    uint32_t visible[5];
+    const size_t count = view.cullSpheres(centers,radius,visible);
+    INFO("visible:",count);
+    ASSERT_SEQ((std::array<uint32_t,3>{0,3,4}),(std::array<uint32_t,3>{visible[0],visible[1],visible[2]}));
+    ASSERT_SEQ((std::array<size_t,2>{3,3}),(std::array<size_t,2>{count,view.cullBoxes(centers,extents,visible)}));
+CASE_END
+
+RUN(frustum)
+
+CASE_BEGIN(aabb)
+    using namespace xmath;
+    constexpr AABB3f a(Vector3f{0,0,0},Vector3f{2,1,1}),b(Vector3f{1,1,1},Vector3f{3,2,2});
+    static_assert(a.intersects(b) && !a.contains(b) && a.merge(b).contains(b),"touching boxes");
+    static_assert(AABB3f().empty() && a.merge(AABB3f()) == a,"the empty box");
+    constexpr Matrix4f turn{0,-1,0,5, 1,0,0,0, 0,0,1,0, 0,0,0,1};
+    static_assert(a.transform(turn) == AABB3f(Vector3f{4,0,0},Vector3f{5,2,1}),"a quarter turn about z, moved by 5");
+    std::vector<AABB3f> boxes{a,b,AABB3f()};
+    transformBoxes(turn,boxes.data(),boxes.data(),boxes.size());
+    INFO("moved:",boxes[1]);
+    ASSERT_SEQ((std::array<float,6>{3,1,1,4,3,2}),(std::array<float,6>{boxes[1].min()[0],boxes[1].min()[1],boxes[1].min()[2],
+                                                                     boxes[1].max()[0],boxes[1].max()[1],boxes[1].max()[2]}));
+    ASSERT_SEQ((std::array<int,2>{1,1}),(std::array<int,2>{boxes[2].empty(),mergeBoxes(boxes.data(),boxes.size()) == boxes[0].merge(boxes[1])}));
+CASE_END
+
+RUN(aabb)
+
+CASE_BEGIN(solvers)
+    using namespace xmath;
+    constexpr Matrix<double,2,2> spd{4,2,2,5};
+    constexpr CholeskyDecomposition<double,2> cholesky(spd);
+    static_assert(cholesky.positiveDefinite() && cholesky.l() == Matrix<double,2,2>{2,0,1,2},"exact factor");
+    static_assert(cholesky.solve(Vector<double,2>{8,12}) == Vector<double,2>{1,2} && cholesky.det() == 16,"");
+    static_assert(!CholeskyDecomposition<double,2>(Matrix<double,2,2>{1,2,2,1}).positiveDefinite(),"indefinite");
+    const LUDecomposition<int,3> lu(Matrix<int,3,3>{2,1,1,4,3,3,8,7,9});
+    INFO("lu:",lu.solve(Vector<int,3>{4,10,24}));
+    ASSERT_SEQ((Vector<int,3>{1,1,1}),lu.solve(Vector<int,3>{4,10,24}));
+    ASSERT_SEQ((Matrix<int,3,2>{1,2,1,0,1,-1}),lu.solve(Matrix<int,3,2>{4,3,10,5,24,7}));
+    ASSERT_SEQ((std::array<int,2>{4,0}),(std::array<int,2>{lu.det(),LUDecomposition<int,2>(Matrix<int,2,2>{1,2,2,4}).invertible()}));
+    //the line through (0,1),(1,3),(2,5),(3,7) as a least squares fit
+    const QRDecomposition<int,4,2> qr(Matrix<int,4,2>{1,0,1,1,1,2,1,3});
+    ASSERT_SEQ((Vector<int,2>{1,2}),qr.solve(Vector<int,4>{1,3,5,7}));
+CASE_END
+
+RUN(solvers)
+
+CASE_BEGIN(large_solve)
+    using namespace xmath;
+    using Matrix6d = Matrix<double,6,6>;
+    //L % U with a unit lower L and the diagonal of U multiplying out to 12
+    constexpr Matrix6d l{1,0,0,0,0,0, 2,1,0,0,0,0, -1,3,1,0,0,0, 0,1,-2,1,0,0, 4,0,1,2,1,0, 1,-1,0,3,-2,1};
+    constexpr Matrix6d u{2,1,0,-1,3,1, 0,1,2,0,-1,4, 0,0,3,1,2,0, 0,0,0,1,-3,2, 0,0,0,0,2,1, 0,0,0,0,0,1};
+    constexpr Matrix6d a = l % u;
+    constexpr Matrix<double,6,2> b{1,0, 2,-1, 0,3, -4,1, 5,2, 1,1};
+    constexpr Matrix6d id = Matrix6d().identity();
+    static_assert(detail::abs(a.det() - 12) <= XMATH_EPS && a % a.inverse() == id && a % a.solve(b) == b,"6x6 round trip must fold");
+    //the last row is twice the first, so the LU elimination leaves an exact zero pivot
+    constexpr Matrix6d singular{1,2,0,-1,3,1, 0,1,2,0,-1,4, 2,0,3,1,2,0, 1,1,0,1,-3,2, -1,0,2,0,2,1, 2,4,0,-2,6,2};
+    static_assert(singular.det() == 0 && singular.inverse() == Matrix6d() && singular.solve(b) == Matrix<double,6,2>(),"singular gives zero");
+    Matrix6d m = a;
+    bool invertible = false,solvable = false;
+    const auto inv = m.inverse(invertible);
+    const auto x = m.solve(b,solvable);
+    INFO("a.inverse():\n",inv);
+    ASSERT_SEQ((std::array<bool,5>{true,true,true,true,true}),
+               (std::array<bool,5>{invertible,solvable,m % inv == id,inv % m == id,m % x == b}));
+    ASSERT_SEQ((std::array<bool,1>{true}),(std::array<bool,1>{detail::abs(m.det() - 12) <= XMATH_EPS}));
+    m = singular;
+    ASSERT_SEQ(Matrix6d(),m.inverse(invertible));
+    ASSERT_SEQ((Matrix<double,6,2>()),m.solve(b,solvable));
+    ASSERT_SEQ((std::array<bool,3>{false,false,true}),(std::array<bool,3>{invertible,solvable,m.det() == 0}));
+CASE_END
+
+RUN(large_solve)
+
+CASE_BEGIN(matrix_batch)
+    using namespace xmath;
+    const std::vector<Matrix<float,2,2>> mats{{2,0,0,4},{1,2,2,4},{0,1,-1,0}};
+    MatrixBatch<float,2,2> batch(mats.begin(),mats.end());
+    ASSERT_SEQ((std::vector<float>{8,0,1}),batch.det());
+    std::array<bool,3> invertible;
+    MatrixBatch<float,2,2> inv;
+    batch.inverse(inv,invertible.data());
+    INFO("inverse:",inv.get(0),inv.get(1),inv.get(2));
+    ASSERT_SEQ((std::array<bool,3>{true,false,true}),invertible);
+    ASSERT_SEQ((Matrix<float,2,2>{0.5f,0,0,0.25f}),inv.get(0));
+    ASSERT_SEQ((Matrix<float,2,2>()),inv.get(1));
+    ASSERT_SEQ((Matrix<float,2,2>{0,-1,1,0}),inv.get(2));
+    batch.multiply(inv,batch);
+    ASSERT_SEQ((Matrix<float,2,2>{1,0,0,1}),batch.get(0));
+    ASSERT_SEQ((Matrix<float,2,2>{1,0,0,1}),batch.get(2));
+    ASSERT_SEQ((Matrix<float,2,2>{0,-1,1,0}),(MatrixBatch<float,2,2>(mats.begin(),mats.end()).transpose().get(2)));
+CASE_END
+
+RUN(matrix_batch)
+
+CASE_BEGIN(unroll)
+    using namespace xmath;
+    //below XMATH_UNROLL_LIMIT straight-line code, above it the row loop, both usable in constant expressions
+    constexpr Matrix<int,3,3> small{1,2,3,4,5,6,7,8,10};
+    static_assert(small % small.identity() == small && small.transpose().transpose() == small,"unrolled");
+    constexpr auto big = Matrix<int,9,9>(2).identity();
+    constexpr Matrix<int,9,9> triple = big * 3;
+    static_assert(triple % big == triple && big.cofactor(0,0) == Matrix<int,8,8>().identity(),"row loop");
+    Matrix<double,9,9> m(no_init);
+    for(size_t i = 0;i < 81;++i){
+        m[i] = double(i % 7) - 3;
+    }
+    ASSERT_SEQ(m,(m % m.identity()));
+    ASSERT_SEQ(m,m.transpose().transpose());
+    ASSERT_SEQ((m.sub<9,4>(0,0).extend(m.sub<9,5>(0,4))),m);
+CASE_END
+
+RUN(unroll)